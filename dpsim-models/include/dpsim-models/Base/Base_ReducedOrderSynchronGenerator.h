@@ -128,6 +128,8 @@ namespace Base {
 			virtual void mnaCompPostStep(const Matrix& leftVector) = 0;
 			/// Stamps system matrix
 			virtual void mnaCompApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) = 0;
+			/// The right vector is only stamped into the terminal and virtual nodes
+			Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override { return this->mnaCompOwnRightVectorStampNodes(matrixNodeIndices); }
 			/// Model flag indicating whether the machine is modelled as Norton or Thevenin equivalent
 			Bool mModelAsNortonSource;
 			// Model flag indicating the SG order to be used
@@ -13,6 +13,8 @@
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include <dpsim-models/Filesystem.h>
@@ -37,6 +39,10 @@ namespace CPS {
 		std::map <String, String> mAssignPattern;
 		/// Skip first row if it has no digits at beginning
 		Bool mSkipFirstRow = true;
+		/// Number of threads reading profile files (0: hardware concurrency)
+		UInt mNumThreads = 0;
+		/// Files by their upper case, alphanumeric name without extension, used when the AUTO mode is selected
+		std::unordered_map<String, fs::path> mFileIndex;
 
 	public:
 		/// set load profile assigning pattern. AUTO for assigning load profile name (csv file name) to load object with the same name (mName)
@@ -65,6 +71,8 @@ namespace CPS {
 		Real time_format_convert(const String& time);
 		/// Skip first row if it has no digits at beginning
 		void doSkipFirstRow(Bool value = true) { mSkipFirstRow = value; }
+		/// Set the number of threads reading profile files (0: hardware concurrency)
+		void setNumberOfThreads(UInt numThreads) { mNumThreads = numThreads; }
 		///
 		MatrixRow csv2Eigen(const String& path);
 
@@ -87,8 +95,9 @@ namespace CPS {
 			CSVReader::Mode mode = CSVReader::Mode::AUTO,
 			CSVReader::DataFormat format = CSVReader::DataFormat::SECONDS);
 
-		/// TODO : deprecate in the future
-		/// read in load profile with time stamp format specified
+		/// read in load profile with time stamp format specified.
+		/// The profile is interpolated when it is evaluated, time_step is only kept for compatibility.
+		/// Profiles read from the same file and interval share their samples.
 		PowerProfile readLoadProfile(fs::path file,
 			Real start_time = -1, Real time_step = 1, Real end_time = -1,
 			CSVReader::DataFormat format = CSVReader::DataFormat::SECONDS);
@@ -111,6 +120,17 @@ namespace CPS {
 
 		/// interpolation for weighting factor data points
 		Real interpol_linear(std::map<Real, Real>& data_wf, Real x);
+
+	private:
+		/// Profile tables already read, by file, start time, end time and format
+		std::map<std::tuple<String, Real, Real, DataFormat>, ProfileTable::Ptr> mProfileTables;
+
+		/// read the samples of a profile file between start_time and end_time
+		ProfileTable::Ptr readProfileTable(const fs::path& file, Real start_time, Real end_time, DataFormat format);
+		/// read the profile files that are not cached yet in parallel
+		void readProfileTables(const std::vector<fs::path>& files, Real start_time, Real end_time, DataFormat format);
+		/// index the file list by normalized name
+		void buildFileIndex();
 	};
 
 
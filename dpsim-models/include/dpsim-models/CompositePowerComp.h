@@ -23,6 +23,19 @@ namespace CPS {
 		MNAInterface::List mSubcomponentsAfterPostStep;
 
 		std::vector<CPS::Attribute<Matrix>::Ptr> mRightVectorStamps;
+		/// Subcomponents the right vector stamps belong to
+		MNAInterface::List mRightVectorStampComps;
+		/// Rows of each right vector stamp if all stamp patterns are known, otherwise empty
+		std::vector<std::vector<UInt>> mRightVectorStampRows;
+		/// Matrix node indices of the parent and all right vector stamps if all stamp patterns are known
+		std::vector<UInt> mRightVectorStampNodes;
+		/// Rows of mRightVectorStampNodes
+		std::vector<UInt> mRightVectorRows;
+		/// Whether only the rows of mRightVectorRows are set
+		Bool mSparseRightVector = false;
+
+		/// Converts matrix node indices into rows of the right vector
+		std::vector<UInt> rightVectorRows(const std::vector<UInt>& matrixNodeIndices, Matrix::Index numRows);
 
 	public:
 		using Type = VarType;
@@ -53,6 +66,8 @@ namespace CPS {
 		void mnaCompApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) override;
 		/// Stamps right side (source) vector
 		void mnaCompApplyRightSideVectorStamp(Matrix& rightVector) override;
+		/// Stamp pattern of the right vector, known if it is known for the parent and all subcomponents
+		Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override;
 		/// MNA pre step operations
 		void mnaCompPreStep(Real time, Int timeStepCount) override;
 		/// MNA post step operations
@@ -72,6 +87,11 @@ namespace CPS {
 		virtual void mnaParentApplyRightSideVectorStamp(Matrix& rightVector) {
 			// By default, the parent has no custom stamp on the right vector, only the subcomponents are stamped
 		};
+		virtual Bool mnaParentRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) {
+			// By default, the parent has no custom stamp on the right vector. Parents that stamp into
+			// the right vector have to report their nodes or return false.
+			return true;
+		};
 		virtual void mnaParentPreStep(Real time, Int timeStepCount) {
 			// By default, the parent has no custom pre-step, only the subcomponents' pre-steps are executed
 		};
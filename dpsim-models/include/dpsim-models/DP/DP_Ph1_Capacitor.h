@@ -56,6 +56,8 @@ namespace Ph1 {
 		void mnaCompApplySystemMatrixStampHarm(SparseMatrixRow& systemMatrix, Int freqIdx);
 		/// Stamps right side (source) vector
 		void mnaCompApplyRightSideVectorStamp(Matrix& rightVector) override;
+		/// Stamps only into the terminal and virtual nodes
+		Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override { return mnaCompOwnRightVectorStampNodes(matrixNodeIndices); }
 		void mnaCompApplyRightSideVectorStampHarm(Matrix& rightVector) override;
 		/// Update interface voltage from MNA system result
 		void mnaCompUpdateVoltage(const Matrix& leftVector) override;
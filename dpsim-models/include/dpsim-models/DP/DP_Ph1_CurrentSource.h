@@ -50,6 +50,8 @@ namespace Ph1 {
 		void mnaCompApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) { }
 		/// Stamps right side (source) vector
 		void mnaCompApplyRightSideVectorStamp(Matrix& rightVector);
+		/// Stamps only into the terminal and virtual nodes
+		Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override { return mnaCompOwnRightVectorStampNodes(matrixNodeIndices); }
 		///
 		void mnaCompUpdateVoltage(const Matrix& leftVector);
 
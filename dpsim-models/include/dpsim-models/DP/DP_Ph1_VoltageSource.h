@@ -85,6 +85,8 @@ namespace Ph1 {
 		void mnaCompApplySystemMatrixStampHarm(SparseMatrixRow& systemMatrix, Int freqIdx) override;
 		/// Stamps right side (source) vector
 		void mnaCompApplyRightSideVectorStamp(Matrix& rightVector) override;
+		/// Stamps only into the terminal and virtual nodes
+		Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override { return mnaCompOwnRightVectorStampNodes(matrixNodeIndices); }
 		void mnaCompApplyRightSideVectorStampHarm(Matrix& rightVector) override;
 		/// Returns current through the component
 		void mnaCompUpdateCurrent(const Matrix& leftVector) override;
@@ -57,6 +57,8 @@ namespace Ph3 {
 		void mnaCompApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
 		/// Stamps right side (source) vector
 		void mnaCompApplyRightSideVectorStamp(Matrix& rightVector);
+		/// Stamps only into the terminal and virtual nodes
+		Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override { return mnaCompOwnRightVectorStampNodes(matrixNodeIndices); }
 		/// Update interface voltage from MNA system result
 		void mnaCompUpdateVoltage(const Matrix& leftVector);
 		/// Update interface current from MNA system result
@@ -0,0 +1,98 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <dpsim-models/Definitions.h>
+#include <dpsim-models/MathUtils.h>
+
+namespace CPS {
+	/// State space model x' = A x + B u discretized with the trapezoidal rule.
+	///
+	/// Unlike Math::StateSpaceTrapezoidal, the discretized matrices
+	/// Ad = F2^-1 F1 and Bd = F2^-1 B dt/2 with F1/2 = I +/- A dt/2 are cached
+	/// and only recomputed after A, B or the time step were changed. They are
+	/// computed and applied like Math::calculateStateSpaceTrapezoidalMatrices and
+	/// Math::applyStateSpaceTrapezoidalMatrices without a constant input.
+	/// The dimensions can be fixed at compile time to avoid heap allocations.
+	template <int States = Eigen::Dynamic, int Inputs = Eigen::Dynamic>
+	class DiscreteStateSpace {
+	public:
+		typedef Eigen::Matrix<Real, States, States> StateMatrix;
+		typedef Eigen::Matrix<Real, States, Inputs> InputMatrix;
+
+		/// Set the system matrix A, the discretization is refreshed on the next step
+		template <typename Derived>
+		void setSystemMatrix(const Eigen::MatrixBase<Derived>& A) {
+			mA = A;
+			mSystemMatrixDirty = true;
+		}
+		/// Set the input matrix B, only Bd is refreshed on the next step
+		template <typename Derived>
+		void setInputMatrix(const Eigen::MatrixBase<Derived>& B) {
+			mB = B;
+			mInputMatrixDirty = true;
+		}
+		/// Set the integration time step
+		void setTimeStep(Real timeStep) {
+			if (timeStep != mTimeStep)
+				mSystemMatrixDirty = true;
+			mTimeStep = timeStep;
+		}
+
+		/// Compute the states of the current step, stateCurr must not alias statePrev
+		template <typename DerivedState, typename DerivedInput, typename DerivedResult>
+		void step(const Eigen::MatrixBase<DerivedState>& statePrev, const Eigen::MatrixBase<DerivedInput>& inputCurr,
+			const Eigen::MatrixBase<DerivedInput>& inputPrev, Eigen::MatrixBase<DerivedResult>& stateCurr) {
+			if (mSystemMatrixDirty)
+				discretizeSystemMatrix();
+			if (mInputMatrixDirty)
+				discretizeInputMatrix();
+
+			Math::updateStateSpaceTrapezoidalStates(mAd, mBd, statePrev, inputCurr, inputPrev, stateCurr);
+		}
+
+		/// Discretized system matrix F2^-1 F1
+		const StateMatrix& discreteSystemMatrix() {
+			if (mSystemMatrixDirty)
+				discretizeSystemMatrix();
+			return mAd;
+		}
+		/// Discretized input matrix F2^-1 B dt/2
+		const InputMatrix& discreteInputMatrix() {
+			if (mSystemMatrixDirty)
+				discretizeSystemMatrix();
+			if (mInputMatrixDirty)
+				discretizeInputMatrix();
+			return mBd;
+		}
+
+	private:
+		void discretizeSystemMatrix() {
+			Math::calculateStateSpaceTrapezoidalSystemMatrix(mA, mTimeStep, mF2Inverse, mAd);
+			mSystemMatrixDirty = false;
+			mInputMatrixDirty = true;
+		}
+		void discretizeInputMatrix() {
+			Math::calculateStateSpaceTrapezoidalInputMatrix(mF2Inverse, mB, mTimeStep, mBd);
+			mInputMatrixDirty = false;
+		}
+
+		StateMatrix mA;
+		InputMatrix mB;
+		Real mTimeStep = 0;
+
+		/// Cached inverse of F2 = I - A dt/2
+		StateMatrix mF2Inverse;
+		StateMatrix mAd;
+		InputMatrix mBd;
+
+		Bool mSystemMatrixDirty = true;
+		Bool mInputMatrixDirty = true;
+	};
+}
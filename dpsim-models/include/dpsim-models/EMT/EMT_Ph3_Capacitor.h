@@ -51,6 +51,8 @@ namespace CPS {
 				void mnaCompApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) override;
 				/// Stamps right side (source) vector
 				void mnaCompApplyRightSideVectorStamp(Matrix& rightVector) override;
+				/// Stamps only into the terminal and virtual nodes
+				Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override { return mnaCompOwnRightVectorStampNodes(matrixNodeIndices); }
 				/// Update interface voltage from MNA system result
 				void mnaCompUpdateVoltage(const Matrix& leftVector) override;
 				/// Update interface current from MNA system result
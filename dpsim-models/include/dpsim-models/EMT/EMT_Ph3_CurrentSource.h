@@ -57,6 +57,8 @@ namespace CPS {
 				void mnaCompInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) override;
 				/// Stamps right side (source) vector
 				void mnaCompApplyRightSideVectorStamp(Matrix& rightVector) override;
+				/// Stamps only into the terminal and virtual nodes
+				Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override { return mnaCompOwnRightVectorStampNodes(matrixNodeIndices); }
 				/// Returns voltage through the component
 				void mnaCompUpdateVoltage(const Matrix& leftVector) override;
 				/// MNA pre step operations
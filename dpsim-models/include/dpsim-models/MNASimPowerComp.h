@@ -21,7 +21,7 @@ namespace CPS {
 		using List = std::vector<Ptr>;
 
 		/// This component's contribution ("stamp") to the right-side vector.
-		/// TODO performance improvements from a sparse representation, at least during copying / summation?
+		/// The solver only gathers the rows reported by mnaRightVectorStampNodes, if any.
 		Attribute<Matrix>::Ptr mRightVector;
 
 		/// List of tasks that relate to using MNA for this component (usually pre-step and/or post-step)
@@ -46,6 +46,7 @@ namespace CPS {
 		void mnaInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) final;
 		void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) final;
 		void mnaApplyRightSideVectorStamp(Matrix& rightVector) final;
+		Bool mnaRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) final;
 		void mnaUpdateVoltage(const Matrix& leftVector) final;
 		void mnaUpdateCurrent(const Matrix& leftVector) final;
 		void mnaPreStep(Real time, Int timeStepCount) final;
@@ -61,6 +62,7 @@ namespace CPS {
 		virtual void mnaCompInitialize(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector);
 		virtual void mnaCompApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
 		virtual void mnaCompApplyRightSideVectorStamp(Matrix& rightVector);
+		virtual Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices);
 		virtual void mnaCompUpdateVoltage(const Matrix& leftVector);
 		virtual void mnaCompUpdateCurrent(const Matrix& leftVector);
 		virtual void mnaCompPreStep(Real time, Int timeStepCount);
@@ -72,6 +74,10 @@ namespace CPS {
 		virtual void mnaCompApplyRightSideVectorStampHarm(Matrix& sourceVector);
 		virtual void mnaCompApplyRightSideVectorStampHarm(Matrix& sourceVector, Int freqIdx);
 
+		/// Reports the terminal and virtual nodes of this component as stamp pattern of the right vector,
+		/// to be used by overrides of mnaCompRightVectorStampNodes in components that only stamp into these nodes
+		Bool mnaCompOwnRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices);
+
 		const Task::List& mnaTasks() const final;
 		Attribute<Matrix>::Ptr getRightVector() const final;
 
@@ -52,6 +52,11 @@ namespace CPS {
 
 		static Real realFromVectorElement(const Matrix& mat, Matrix::Index row);
 
+		/// Sorted rows of a real vector that setVectorElement writes for the matrix node indices
+		static std::vector<UInt> vectorElementRows(const std::vector<UInt>& matrixNodeIndices);
+		/// Sorted rows of a complex vector that setVectorElement writes for the matrix node indices in all frequencies
+		static std::vector<UInt> complexVectorElementRows(const std::vector<UInt>& matrixNodeIndices, Matrix::Index numRows, Int maxFreq = 1);
+
 		// #### Matric Operations ####
 		//
 		// | Re-Re(row,col)_harm1 | Im-Re(row,col)_harm1 | Interharmonics harm1-harm2
@@ -92,6 +97,28 @@ namespace CPS {
 		static void calculateStateSpaceTrapezoidalMatrices(const Matrix & A, const Matrix & B, const Matrix & C, const Real & dt, Matrix & Ad, Matrix & Bd, Matrix & Cd);
 		/// Apply the trapezoidal based state space matrices Ad, Bd, Cd to get the states at the current time step
 		static Matrix applyStateSpaceTrapezoidalMatrices(const Matrix & Ad, const Matrix & Bd, const Matrix & Cd, const Matrix & statesPrevStep, const Matrix & inputCurrStep, const Matrix & inputPrevStep);
+		/// Calculate the inverse of F2 = I - A dt/2 and the discretized system matrix Ad = F2^-1 (I + A dt/2) using trapezoidal rule
+		template <typename DerivedA, typename DerivedF2Inv, typename DerivedAd>
+		static void calculateStateSpaceTrapezoidalSystemMatrix(const Eigen::MatrixBase<DerivedA> & A, Real dt,
+			Eigen::MatrixBase<DerivedF2Inv> & F2inv, Eigen::MatrixBase<DerivedAd> & Ad) {
+			typename DerivedA::PlainObject I = DerivedA::PlainObject::Identity(A.rows(), A.cols());
+			F2inv = (I - (dt/2.) * A).inverse();
+			Ad.noalias() = F2inv * (I + (dt/2.) * A);
+		}
+		/// Calculate the discretized input matrix Bd = F2^-1 B dt/2 using trapezoidal rule from the inverse of F2
+		template <typename DerivedF2Inv, typename DerivedB, typename DerivedBd>
+		static void calculateStateSpaceTrapezoidalInputMatrix(const Eigen::MatrixBase<DerivedF2Inv> & F2inv,
+			const Eigen::MatrixBase<DerivedB> & B, Real dt, Eigen::MatrixBase<DerivedBd> & Bd) {
+			Bd.noalias() = (dt/2.) * F2inv * B;
+		}
+		/// Apply the trapezoidal based state space matrices Ad, Bd without allocating a result, statesCurrStep must not alias statesPrevStep
+		template <typename DerivedAd, typename DerivedBd, typename DerivedState, typename DerivedInput, typename DerivedResult>
+		static void updateStateSpaceTrapezoidalStates(const Eigen::MatrixBase<DerivedAd> & Ad, const Eigen::MatrixBase<DerivedBd> & Bd,
+			const Eigen::MatrixBase<DerivedState> & statesPrevStep, const Eigen::MatrixBase<DerivedInput> & inputCurrStep,
+			const Eigen::MatrixBase<DerivedInput> & inputPrevStep, Eigen::MatrixBase<DerivedResult> & statesCurrStep) {
+			statesCurrStep.noalias() = Ad * statesPrevStep;
+			statesCurrStep.noalias() += Bd * (inputCurrStep + inputPrevStep);
+		}
 
 		static void FFT(std::vector<Complex>& samples);
 
@@ -7,6 +7,8 @@
  *********************************************************************************/
 
 #pragma once
+#include <vector>
+
 #include <dpsim-models/Definitions.h>
 
 namespace CPS {
@@ -15,8 +17,59 @@ namespace CPS {
 		Real q;
 	};
 
-	struct PowerProfile {
-		std::map<Real, PQData> pqData;
-		std::map<Real, Real> weightingFactors;
+	/// Samples of a profile file with one column per value on a common time base.
+	/// The table is immutable after reading, so that all loads using the same file share it.
+	struct ProfileTable {
+		typedef std::shared_ptr<const ProfileTable> Ptr;
+
+		/// Time of each sample in s, strictly ascending
+		std::vector<Real> times;
+		/// Values with one row per sample and one column per quantity
+		Matrix values;
+		/// Time step of an equidistant time base, 0 if the samples are looked up by their times
+		Real timeStep = 0;
+
+		/// Use an equidistant time base if all sample times are on a uniform grid
+		void detectTimeBase();
+	};
+
+	/// Load profile interpolated linearly between the samples of a shared table.
+	///
+	/// The index of the last sample before the requested time is kept as a cursor, so that
+	/// monotonically increasing times are evaluated without a search and without allocations.
+	/// Before the first and after the last sample, the profile is constant.
+	class PowerProfile {
+	public:
+		enum class Type { None, PQ, WeightingFactor };
+
+		///
+		PowerProfile() { }
+		///
+		PowerProfile(ProfileTable::Ptr table, Type type) : mTable(table), mType(type) { }
+
+		///
+		Type type() const { return mType; }
+		///
+		Bool empty() const { return !mTable || mTable->times.empty(); }
+		///
+		ProfileTable::Ptr table() const { return mTable; }
+
+		/// Interpolated value of a column of the table at the given time
+		Real value(Real time, UInt column);
+		/// Active and reactive power in W and var of a PQ profile
+		PQData pq(Real time) { return { value(time, 0), value(time, 1) }; }
+		/// Weighting factor of a weighting factor profile
+		Real weightingFactor(Real time) { return value(time, 0); }
+
+	private:
+		///
+		ProfileTable::Ptr mTable;
+		///
+		Type mType = Type::None;
+		/// Index of the last sample at or before the previously requested time
+		UInt mCursor = 0;
+
+		/// Move the cursor to the last sample at or before the given time
+		void seek(Real time);
 	};
 }
@@ -56,6 +56,8 @@ namespace CPS {
 				void mnaCompApplySystemMatrixStamp(SparseMatrixRow& systemMatrix);
 				/// Stamps right side (source) vector
 				void mnaCompApplyRightSideVectorStamp(Matrix& rightVector);
+				/// Stamps only into the terminal and virtual nodes
+				Bool mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) override { return mnaCompOwnRightVectorStampNodes(matrixNodeIndices); }
 				/// Returns current through the component
 				void mnaCompUpdateCurrent(const Matrix& leftVector);
 
@@ -10,6 +10,7 @@
 
 #include <vector>
 
+#include <dpsim-models/DiscreteStateSpace.h>
 #include <dpsim-models/SimPowerComp.h>
 #include <dpsim-models/SimSignalComp.h>
 #include <dpsim-models/Task.h>
@@ -39,6 +40,8 @@ namespace Signal {
 		Matrix mC = Matrix::Zero(2, 2);
 		/// matrix D of state space model
 		Matrix mD = Matrix::Zero(2, 2);
+		/// discretized state space model
+		DiscreteStateSpace<2, 2> mStateSpace;
 
 	public:
 
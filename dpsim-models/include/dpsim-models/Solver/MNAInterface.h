@@ -28,6 +28,12 @@ namespace CPS {
 		virtual void mnaApplySystemMatrixStamp(SparseMatrixRow& systemMatrix) = 0;
 		/// Stamps right side (source) vector
 		virtual void mnaApplyRightSideVectorStamp(Matrix& rightVector) = 0;
+		/// Collects the matrix node indices the right side vector stamp writes to.
+		/// Returns false if they are unknown and the solver has to add the complete vector.
+		/// The solver does not check this during the simulation, see the DP_EMT_RightVectorStamps example.
+		virtual Bool mnaRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) {
+			return false;
+		}
 		/// Update interface voltage from MNA system result
 		virtual void mnaUpdateVoltage(const Matrix& leftVector) = 0;
 		/// Update interface current from MNA system result
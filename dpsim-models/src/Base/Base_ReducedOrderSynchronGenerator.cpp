@@ -501,8 +501,8 @@ void Base::ReducedOrderSynchronGenerator<Complex>::mnaCompPreStep(Real time, Int
 	// model specific calculation of electrical vars
 	stepInPerUnit();
 
-	// stamp model specific right side vector after calculation of electrical vars
-	(**mRightVector).setZero();
+	// stamp model specific right side vector after calculation of electrical vars,
+	// which always sets the same rows, so that the others stay zero
 	mnaCompApplyRightSideVectorStamp(**mRightVector);
 }
 
@@ -529,8 +529,8 @@ void Base::ReducedOrderSynchronGenerator<Real>::mnaCompPreStep(Real time, Int ti
 	// model specific calculation of electrical vars
 	stepInPerUnit();
 
-	// stamp model specific right side vector after calculation of electrical vars
-	(**mRightVector).setZero();
+	// stamp model specific right side vector after calculation of electrical vars,
+	// which always sets the same rows, so that the others stay zero
 	mnaCompApplyRightSideVectorStamp(**mRightVector);
 }
 
@@ -544,7 +544,6 @@ template <typename VarType>
 void Base::ReducedOrderSynchronGenerator<VarType>::mnaCompPreStep(Real time, Int timeStepCount) {
 	mSimTime = time;
 	stepInPerUnit();
-	(**mRightVector).setZero();
 	mnaCompApplyRightSideVectorStamp(**mRightVector);
 }
 
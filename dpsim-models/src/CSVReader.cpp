@@ -6,44 +6,271 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  *********************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include <dpsim-models/CSVReader.h>
 
 using namespace CPS;
 
+namespace {
+	/// Contents of a file, memory-mapped where supported
+	class FileBuffer {
+	public:
+		FileBuffer(const fs::path& path) {
+#ifdef __linux__
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw SystemError("Cannot open " + path.string());
+			struct stat status;
+			if (fstat(fd, &status) == 0 && status.st_size > 0) {
+				void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (data != MAP_FAILED) {
+					mMapped = data;
+					mSize = status.st_size;
+					madvise(mMapped, mSize, MADV_SEQUENTIAL);
+				}
+			}
+			close(fd);
+			if (mMapped)
+				return;
+#endif
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+				throw SystemError("Cannot open " + path.string());
+			mContents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		~FileBuffer() {
+#ifdef __linux__
+			if (mMapped)
+				munmap(mMapped, mSize);
+#endif
+		}
+
+		FileBuffer(const FileBuffer&) = delete;
+		FileBuffer& operator=(const FileBuffer&) = delete;
+
+		const char* begin() const { return mMapped ? static_cast<const char*>(mMapped) : mContents.data(); }
+		const char* end() const { return begin() + (mMapped ? mSize : mContents.size()); }
+
+	private:
+		void* mMapped = nullptr;
+		std::size_t mSize = 0;
+		String mContents;
+	};
+
+	/// Range of characters of a single cell
+	struct Cell {
+		const char* begin;
+		const char* end;
+	};
+
+	/// Strip blanks and a carriage return around a cell
+	Cell trim(Cell cell) {
+		while (cell.begin < cell.end && (*cell.begin == ' ' || *cell.begin == '\t'))
+			++cell.begin;
+		while (cell.end > cell.begin && (cell.end[-1] == ' ' || cell.end[-1] == '\t' || cell.end[-1] == '\r'))
+			--cell.end;
+		return cell;
+	}
+
+	/// Split a line at commas, a trailing comma adds an empty cell
+	void splitCells(const char* begin, const char* end, std::vector<Cell>& cells) {
+		cells.clear();
+		while (true) {
+			const char* comma = static_cast<const char*>(std::memchr(begin, ',', end - begin));
+			if (!comma) {
+				cells.push_back(trim({ begin, end }));
+				return;
+			}
+			cells.push_back(trim({ begin, comma }));
+			begin = comma + 1;
+		}
+	}
+
+	/// Next line of a buffer, without the line break
+	Bool nextLine(const char*& pos, const char* end, Cell& line) {
+		if (pos >= end)
+			return false;
+		const char* lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+		if (!lineEnd)
+			lineEnd = end;
+		line = { pos, lineEnd };
+		pos = lineEnd + 1;
+		return true;
+	}
+
+	/// Parse a number like std::stod, without locale and allocations where the library supports it
+	Real parseReal(Cell cell) {
+		if (cell.begin < cell.end && *cell.begin == '+')
+			++cell.begin;
+#if defined(__cpp_lib_to_chars)
+		Real value;
+		auto result = std::from_chars(cell.begin, cell.end, value);
+		if (result.ec != std::errc())
+			throw std::invalid_argument("Cannot parse number " + String(cell.begin, cell.end));
+		return value;
+#else
+		return std::stod(String(cell.begin, cell.end));
+#endif
+	}
+
+	/// Convert a HH:MM:SS time stamp into total seconds, 0 if it has less than two fields
+	Real parseTimeOfDay(Cell cell) {
+		Int fields[3] = { 0, 0, 0 };
+		Int numFields = 0;
+		const char* pos = cell.begin;
+		while (numFields < 3) {
+			auto result = std::from_chars(pos, cell.end, fields[numFields]);
+			if (result.ec != std::errc())
+				break;
+			++numFields;
+			pos = result.ptr;
+			if (pos == cell.end || *pos != ':')
+				break;
+			++pos;
+		}
+		return (numFields >= 2) ? fields[0] * 3600. + fields[1] * 60. + fields[2] : 0.;
+	}
+
+	/// Upper case name without non-alphanumeric characters, used to match files and loads
+	String normalizeName(String name) {
+		for (auto & c : name) c = toupper(c);
+		name.erase(std::remove_if(name.begin(), name.end(), [](char c) { return !isalnum(c); }), name.end());
+		return name;
+	}
+
+	/// Read the samples of a profile file from the last row at or before start_time to the first row after end_time.
+	/// Rows whose time is not ascending and rows with missing values are skipped and counted.
+	ProfileTable::Ptr parseProfile(const fs::path& file, Real start_time, Real end_time,
+		Bool timeOfDay, Bool skipFirstRow, UInt& numIgnored) {
+
+		FileBuffer buffer(file);
+		const char* pos = buffer.begin();
+		Cell line;
+		std::vector<Cell> cells;
+
+		// ignore the first row if it is a title
+		if (skipFirstRow) {
+			const char* first = pos;
+			if (nextLine(pos, buffer.end(), line)) {
+				Cell cell = trim(line);
+				if (cell.begin < cell.end && std::isdigit(static_cast<unsigned char>(*cell.begin)))
+					pos = first;
+			}
+		}
+
+		auto table = std::make_shared<ProfileTable>();
+		std::vector<Real> values;
+		Int numColumns = 0;
+		numIgnored = 0;
+		while (nextLine(pos, buffer.end(), line)) {
+			splitCells(line.begin, line.end, cells);
+			if (cells.size() == 1 && cells[0].begin == cells[0].end)
+				continue;
+
+			// the data type is determined by the first row (assuming only time,p,q or time,weighting factor)
+			if (numColumns == 0 && cells.size() >= 2)
+				numColumns = (cells.size() == 2) ? 1 : 2;
+			if (cells.size() < static_cast<std::size_t>(std::max(numColumns, 1) + 1)
+				|| std::any_of(cells.begin(), cells.begin() + std::max(numColumns, 1) + 1,
+					[](const Cell& cell) { return cell.begin == cell.end; })) {
+				++numIgnored;
+				continue;
+			}
+
+			Real currentTime = timeOfDay ? parseTimeOfDay(cells[0]) : parseReal(cells[0]);
+
+			if (start_time >= 0 && currentTime <= start_time) {
+				table->times.clear();
+				values.clear();
+			}
+			if (!table->times.empty() && currentTime <= table->times.back()) {
+				++numIgnored;
+				continue;
+			}
+
+			table->times.push_back(currentTime);
+			if (numColumns == 1) {
+				values.push_back(parseReal(cells[1]));
+			}
+			else {
+				// multiplied by 1000 due to unit conversion (kw to w)
+				values.push_back(parseReal(cells[1]) * 1000);
+				values.push_back(parseReal(cells[2]) * 1000);
+			}
+
+			if (end_time > 0 && currentTime > end_time)
+				break;
+		}
+
+		table->values = Eigen::Map<const MatrixRow>(values.data(), table->times.size(), numColumns);
+		table->detectTimeBase();
+		return table;
+	}
+}
+
 MatrixRow CSVReader::csv2Eigen(const String& path) {
-    std::ifstream inputFile;
-    inputFile.open(path);
-    String line;
-    std::vector<double> values;
-    UInt rows = 0;
-    while (std::getline(inputFile, line)) {
-        std::stringstream lineStream(line);
-        String cell;
-        while (std::getline(lineStream, cell, ',')) {
-            values.push_back(std::stod(cell));
-        }
-        ++rows;
-    }
-	UInt columns = values.size()/rows;
-    return Eigen::Map<const MatrixRow>(values.data(), rows, columns);
+	FileBuffer buffer(path);
+	const char* pos = buffer.begin();
+	Cell line;
+	std::vector<Cell> cells;
+	std::vector<double> values;
+	UInt rows = 0, columns = 0, numIgnored = 0;
+	while (nextLine(pos, buffer.end(), line)) {
+		if (trim(line).begin == trim(line).end)
+			continue;
+		splitCells(line.begin, line.end, cells);
+		// the number of columns is determined by the first row, rows of a different length are skipped
+		if (rows == 0)
+			columns = static_cast<UInt>(cells.size());
+		if (cells.size() != columns) {
+			++numIgnored;
+			continue;
+		}
+		for (auto& cell : cells)
+			values.push_back(parseReal(cell));
+		++rows;
+	}
+	if (numIgnored > 0)
+		SPDLOG_LOGGER_WARN(mSLog, "Ignored {} rows in {}, the number of columns differs from the first row", numIgnored, path);
+	return Eigen::Map<const MatrixRow>(values.data(), rows, columns);
 }
 
 void CSVRow::readNextRow(std::istream& str) {
 	std::string line;
 	std::getline(str, line);
 
-	std::stringstream   lineStream(line);
-	std::string         cell;
-
+	// split without a stringstream, leading blanks of a cell are skipped
 	m_data.clear();
-	while (std::getline(lineStream >> std::ws, cell, ',')) {
-		m_data.push_back(cell);
-	}
-	// This checks for a trailing comma with no data after it.
-	if (!lineStream && cell.empty()){
-		// If there was a trailing comma then add an empty element.
-		m_data.push_back("");
+	std::size_t begin = 0;
+	while (true) {
+		begin = line.find_first_not_of(" \t\n\v\f\r", begin);
+		if (begin == std::string::npos)
+			begin = line.size();
+		std::size_t comma = line.find(',', begin);
+		if (comma == std::string::npos) {
+			if (begin < line.size())
+				m_data.push_back(line.substr(begin));
+			// This checks for a trailing comma with no data after it.
+			else if (m_data.empty() || line.back() == ',')
+				m_data.push_back("");
+			break;
+		}
+		m_data.push_back(line.substr(begin, comma - begin));
+		begin = comma + 1;
 	}
 }
 
@@ -364,74 +591,84 @@ std::vector<PQData> CSVReader::readLoadProfileDP(fs::path file,
 PowerProfile CSVReader::readLoadProfile(fs::path file,
 	Real start_time, Real time_step, Real end_time, CSVReader::DataFormat format) {
 
-	PowerProfile load_profile;
-	std::ifstream csvfile(file);
-	bool need_that_conversion = (format == DataFormat::HHMMSS) ? true : false;
-	bool data_with_weighting_factor = false;
+	// loads assigned to the same file share its samples
+	auto key = std::make_tuple(file.string(), start_time, end_time, format);
+	auto table = mProfileTables.find(key);
+	if (table == mProfileTables.end())
+		table = mProfileTables.emplace(key, readProfileTable(file, start_time, end_time, format)).first;
 
-	CSVReaderIterator loop(csvfile);
+	auto type = (table->second->values.cols() == 1) ? PowerProfile::Type::WeightingFactor : PowerProfile::Type::PQ;
+	return PowerProfile(table->second, type);
+}
 
-	// ignore the first row if it is a title
-	if (mSkipFirstRow && !std::isdigit((*loop).get(0)[0])) {
-		loop.next();
-	}
+ProfileTable::Ptr CSVReader::readProfileTable(const fs::path& file,
+	Real start_time, Real end_time, CSVReader::DataFormat format) {
 
-	/*
-	 loop over rows of the csv file to find the entry point to read in.
-	 and determine data type prior to read in. (assuming only time,p,q or time,weighting factor)
-	 if start_time and end_time are negative (as default), it reads in all rows.
-	*/
-	for (; loop != CSVReaderIterator(); loop.next()) {
-		CSVReaderIterator nextRow = loop;
-		nextRow.next();
-		CPS::Real nextTime = (need_that_conversion) ? time_format_convert((*nextRow).get(0)) : std::stod((*nextRow).get(0));
-		if ((*nextRow).size() == 2) {
-			data_with_weighting_factor = true;
-		}
-		if ((start_time < 0) | (nextTime >= Int(start_time)))
-		{
-			break;
-		}
-	}
-	/*
-	 reading data after entry point until end_time is reached
-	*/
-	for (; loop != CSVReaderIterator(); loop.next()) {
-		CPS::Real currentTime = (need_that_conversion) ? time_format_convert((*loop).get(0)) : std::stod((*loop).get(0));
-		if (data_with_weighting_factor) {
-			Real wf = std::stod((*loop).get(1));
-			load_profile.weightingFactors.insert(std::pair<Real, Real>(currentTime, wf));
-		}
-		else {
-		PQData pq;
-		// multiplied by 1000 due to unit conversion (kw to w)
-		pq.p = std::stod((*loop).get(1)) * 1000;
-		pq.q = std::stod((*loop).get(2)) * 1000;
-		load_profile.pqData.insert(std::pair<Real,PQData>(currentTime,pq));
-		}
+	UInt numIgnored;
+	auto table = parseProfile(file, start_time, end_time, format == DataFormat::HHMMSS, mSkipFirstRow, numIgnored);
+	if (numIgnored > 0)
+		SPDLOG_LOGGER_WARN(mSLog, "Ignored {} rows in {}, time is not ascending or values are missing", numIgnored, file.string());
+	SPDLOG_LOGGER_INFO(mSLog, "Read {} samples from {}, time step {} s", table->times.size(), file.string(), table->timeStep);
+	return table;
+}
 
-		if (end_time > 0 && currentTime > end_time)
-			break;
-	}
-		std::vector<CPS::Real> times;
-	for (CPS::Real x_ = start_time; x_ <= end_time; x_ += time_step) {
-		times.push_back(x_);
-	}
+void CSVReader::readProfileTables(const std::vector<fs::path>& files,
+	Real start_time, Real end_time, CSVReader::DataFormat format) {
 
-	for (auto x : times) {
-		if (load_profile.pqData.find(x) == load_profile.pqData.end()) {
-			if (data_with_weighting_factor) {
-				Real y = interpol_linear(load_profile.weightingFactors, x);
-				load_profile.weightingFactors.insert(std::pair<Real, Real>(x, y));
-			}
-			else {
-				PQData y = interpol_linear(load_profile.pqData, x);
-				load_profile.pqData.insert(std::pair<Real,PQData>(x,y));
-			}
+	std::vector<fs::path> missing;
+	for (auto& file : files) {
+		if (mProfileTables.find(std::make_tuple(file.string(), start_time, end_time, format)) == mProfileTables.end()
+			&& std::find(missing.begin(), missing.end(), file) == missing.end())
+			missing.push_back(file);
+	}
+	if (missing.empty())
+		return;
+
+	UInt numFiles = static_cast<UInt>(missing.size());
+	UInt numWorkers = mNumThreads > 0 ? mNumThreads : std::max(1u, std::thread::hardware_concurrency());
+	numWorkers = std::max(1u, std::min(numWorkers, numFiles));
+
+	std::vector<ProfileTable::Ptr> tables(numFiles);
+	std::vector<UInt> numIgnored(numFiles, 0);
+	std::vector<std::exception_ptr> errors(numWorkers);
+	std::atomic<UInt> nextFile(0);
+	auto work = [&](UInt worker) {
+		try {
+			for (UInt file = nextFile++; file < numFiles; file = nextFile++)
+				tables[file] = parseProfile(missing[file], start_time, end_time,
+					format == DataFormat::HHMMSS, mSkipFirstRow, numIgnored[file]);
+		} catch (...) {
+			errors[worker] = std::current_exception();
 		}
+	};
+
+	std::vector<std::thread> threads;
+	for (UInt worker = 1; worker < numWorkers; ++worker)
+		threads.emplace_back(work, worker);
+	work(0);
+	for (auto& thread : threads)
+		thread.join();
+	for (auto& error : errors)
+		if (error)
+			std::rethrow_exception(error);
+
+	for (UInt file = 0; file < numFiles; ++file) {
+		if (numIgnored[file] > 0)
+			SPDLOG_LOGGER_WARN(mSLog, "Ignored {} rows in {}, time is not ascending or values are missing", numIgnored[file], missing[file].string());
+		mProfileTables.emplace(std::make_tuple(missing[file].string(), start_time, end_time, format), tables[file]);
 	}
+	SPDLOG_LOGGER_INFO(mSLog, "Read {} profiles with {} threads", numFiles, numWorkers);
+}
 
-	return load_profile;
+void CSVReader::buildFileIndex() {
+	mFileIndex.clear();
+	for (auto& file : mFileList) {
+		/// file names are matched without the "CSV" of the extension
+		String file_name = normalizeName(file.filename().string());
+		if (file_name.size() < 3)
+			continue;
+		mFileIndex[file_name.substr(0, file_name.size() - 3)] = file;
+	}
 }
 
 // can only read one file for now
@@ -482,32 +719,38 @@ void CSVReader::assignLoadProfile(CPS::SystemTopology& sys, Real start_time, Rea
 
 	switch (mode) {
 		case CSVReader::Mode::AUTO: {
+			SPDLOG_LOGGER_INFO(mSLog, "Comparing csv file names with load mRIDs ...");
+			if (mFileIndex.empty())
+				buildFileIndex();
+
+			std::vector<std::pair<std::shared_ptr<CPS::SP::Ph1::Load>, fs::path>> assignments;
 			for (auto obj : sys.mComponents) {
 				if (std::shared_ptr<CPS::SP::Ph1::Load> load = std::dynamic_pointer_cast<CPS::SP::Ph1::Load>(obj)) {
-					SPDLOG_LOGGER_INFO(mSLog, "Comparing csv file names with load mRIDs ...");
-					String load_name = load->name();
-					for (auto file : mFileList) {
-						String file_name = file.filename().string();
-						/// changing file name and load name to upper case for later matching
-						for (auto & c : load_name) c = toupper(c);
-						for (auto & c : file_name) c = toupper(c);
-						/// strip off all non-alphanumeric characters
-						load_name.erase(remove_if(load_name.begin(), load_name.end(), [](char c) { return !isalnum(c); }), load_name.end());
-						file_name.erase(remove_if(file_name.begin(), file_name.end(), [](char c) { return !isalnum(c); }), file_name.end());
-						if (std::string(file_name.begin(), file_name.end() - 3).compare(load_name) == 0) {
-							load->mLoadProfile = readLoadProfile(file, start_time, time_step, end_time, format);
-							load->use_profile = true;
-							SPDLOG_LOGGER_INFO(mSLog, "Assigned {} to {}", file.filename().string(), load->name());
-						}
-					}
+					auto file = mFileIndex.find(normalizeName(load->name()));
+					if (file != mFileIndex.end())
+						assignments.emplace_back(load, file->second);
 				}
 			}
+
+			std::vector<fs::path> files;
+			for (auto& assignment : assignments)
+				files.push_back(assignment.second);
+			readProfileTables(files, start_time, end_time, format);
+
+			for (auto& assignment : assignments) {
+				assignment.first->mLoadProfile = readLoadProfile(assignment.second, start_time, time_step, end_time, format);
+				assignment.first->use_profile = true;
+				SPDLOG_LOGGER_INFO(mSLog, "Assigned {} to {}", assignment.second.filename().string(), assignment.first->name());
+			}
 			break;
 		}
 		case CSVReader::Mode::MANUAL: {
 			Int LP_assigned_counter = 0;
 			Int LP_not_assigned_counter = 0;
 			SPDLOG_LOGGER_INFO(mSLog, "Assigning load profiles with user defined pattern ...");
+
+			std::vector<std::pair<std::shared_ptr<CPS::SP::Ph1::Load>, String>> assignments;
+			std::vector<fs::path> files;
 			for (auto obj : sys.mComponents) {
 				if (std::shared_ptr<CPS::SP::Ph1::Load> load = std::dynamic_pointer_cast<CPS::SP::Ph1::Load>(obj)) {
 					std::map<String, String>::iterator file = mAssignPattern.find(load->name());
@@ -517,13 +760,20 @@ void CSVReader::assignLoadProfile(CPS::SystemTopology& sys, Real start_time, Rea
 						LP_not_assigned_counter++;
 						continue;
 					}
-					load->mLoadProfile = readLoadProfile(fs::path(mPath + file->second + ".csv"), start_time, time_step, end_time);
-					load->use_profile = true;
-					std::cout<<" Assigned "<< file->second<< " to " <<load->name()<<std::endl;
-					SPDLOG_LOGGER_INFO(mSLog, "Assigned {}.csv to {}", file->second, load->name());
-					LP_assigned_counter++;
+					assignments.emplace_back(load, file->second);
+					files.push_back(fs::path(mPath + file->second + ".csv"));
 				}
 			}
+			readProfileTables(files, start_time, end_time, CSVReader::DataFormat::SECONDS);
+
+			for (auto& assignment : assignments) {
+				auto load = assignment.first;
+				load->mLoadProfile = readLoadProfile(fs::path(mPath + assignment.second + ".csv"), start_time, time_step, end_time);
+				load->use_profile = true;
+				std::cout<<" Assigned "<< assignment.second<< " to " <<load->name()<<std::endl;
+				SPDLOG_LOGGER_INFO(mSLog, "Assigned {}.csv to {}", assignment.second, load->name());
+				LP_assigned_counter++;
+			}
 			SPDLOG_LOGGER_INFO(mSLog, "Assigned profiles for {} loads, {} not assigned.", LP_assigned_counter, LP_not_assigned_counter);
 			break;
 		}
@@ -12,6 +12,7 @@ void CompositePowerComp<VarType>::addMNASubComponent(typename SimPowerComp<VarTy
 
 		if (contributeToRightVector) {
 			this->mRightVectorStamps.push_back(mnasubcomp->mRightVector);
+			this->mRightVectorStampComps.push_back(mnasubcomp);
 		}
 
 		switch (preStepOrder) {
@@ -50,6 +51,41 @@ void CompositePowerComp<VarType>::mnaCompInitialize(Real omega, Real timeStep, A
 	**this->mRightVector = Matrix::Zero(leftVector->get().rows(), 1);
 
 	mnaParentInitialize(omega, timeStep, leftVector);
+
+	// Only sum up the rows of the subcomponent stamps if all of them report their nodes
+	mRightVectorStampNodes.clear();
+	mRightVectorStampRows.assign(mRightVectorStamps.size(), std::vector<UInt>());
+	mSparseRightVector = mnaParentRightVectorStampNodes(mRightVectorStampNodes);
+	for (UInt stamp = 0; stamp < mRightVectorStamps.size() && mSparseRightVector; ++stamp) {
+		const Matrix& stampVector = **mRightVectorStamps[stamp];
+		if (stampVector.size() == 0)
+			continue;
+
+		std::vector<UInt> matrixNodeIndices;
+		mSparseRightVector = stampVector.cols() == 1 && stampVector.rows() == (**this->mRightVector).rows()
+			&& mRightVectorStampComps[stamp]->mnaRightVectorStampNodes(matrixNodeIndices);
+		mRightVectorStampRows[stamp] = rightVectorRows(matrixNodeIndices, stampVector.rows());
+		mRightVectorStampNodes.insert(mRightVectorStampNodes.end(), matrixNodeIndices.begin(), matrixNodeIndices.end());
+	}
+	mRightVectorRows = rightVectorRows(mRightVectorStampNodes, (**this->mRightVector).rows());
+}
+
+template <>
+std::vector<UInt> CompositePowerComp<Real>::rightVectorRows(const std::vector<UInt>& matrixNodeIndices, Matrix::Index numRows) {
+	return Math::vectorElementRows(matrixNodeIndices);
+}
+
+template <>
+std::vector<UInt> CompositePowerComp<Complex>::rightVectorRows(const std::vector<UInt>& matrixNodeIndices, Matrix::Index numRows) {
+	return Math::complexVectorElementRows(matrixNodeIndices, numRows, this->mNumFreqs > 0 ? static_cast<Int>(this->mNumFreqs) : 1);
+}
+
+template <typename VarType>
+Bool CompositePowerComp<VarType>::mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) {
+	if (!mSparseRightVector)
+		return false;
+	matrixNodeIndices.insert(matrixNodeIndices.end(), mRightVectorStampNodes.begin(), mRightVectorStampNodes.end());
+	return true;
 }
 
 template <typename VarType>
@@ -62,10 +98,21 @@ void CompositePowerComp<VarType>::mnaCompApplySystemMatrixStamp(SparseMatrixRow&
 
 template <typename VarType>
 void CompositePowerComp<VarType>::mnaCompApplyRightSideVectorStamp(Matrix& rightVector) {
-	rightVector.setZero();
-	for (auto stamp : mRightVectorStamps) {
-		if ((**stamp).size() != 0) {
-			rightVector += **stamp;
+	if (mSparseRightVector) {
+		// The other rows stay zero
+		for (auto row : mRightVectorRows)
+			rightVector(row, 0) = 0;
+		for (UInt stamp = 0; stamp < mRightVectorStamps.size(); ++stamp) {
+			const Matrix& stampVector = **mRightVectorStamps[stamp];
+			for (auto row : mRightVectorStampRows[stamp])
+				rightVector(row, 0) += stampVector(row, 0);
+		}
+	} else {
+		rightVector.setZero();
+		for (auto stamp : mRightVectorStamps) {
+			if ((**stamp).size() != 0) {
+				rightVector += **stamp;
+			}
 		}
 	}
 	mnaParentApplyRightSideVectorStamp(rightVector);
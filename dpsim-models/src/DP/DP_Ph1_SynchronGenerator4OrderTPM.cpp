@@ -218,7 +218,6 @@ void DP::Ph1::SynchronGenerator4OrderTPM::correctorStep() {
 	**mEhMod += - Complex(0, mBase_Z * (mResistanceMatrixVarying * IdpCorrection)(1,0));
 
 	// stamp currents
-	(**mRightVector).setZero();
 	mnaCompApplyRightSideVectorStamp(**mRightVector);
 
 	// store value currently at j-1 for later use
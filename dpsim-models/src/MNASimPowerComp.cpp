@@ -51,6 +51,11 @@ void MNASimPowerComp<VarType>::mnaApplyRightSideVectorStamp(Matrix& rightVector)
 	this->mnaCompApplyRightSideVectorStamp(rightVector);
 };
 
+template<typename VarType>
+Bool MNASimPowerComp<VarType>::mnaRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) {
+	return this->mnaCompRightVectorStampNodes(matrixNodeIndices);
+};
+
 template<typename VarType>
 void MNASimPowerComp<VarType>::mnaUpdateVoltage(const Matrix& leftVector) {
 	this->mnaCompUpdateVoltage(leftVector);
@@ -111,6 +116,27 @@ void MNASimPowerComp<VarType>::mnaCompApplyRightSideVectorStamp(Matrix& rightVec
 	// Empty default implementation. Can be overridden by child classes if desired.
 }
 
+template<typename VarType>
+Bool MNASimPowerComp<VarType>::mnaCompRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) {
+	// By default the stamp pattern is unknown and the solver adds the complete right vector.
+	// Can be overridden by child classes that only stamp into known nodes.
+	return false;
+}
+
+template<typename VarType>
+Bool MNASimPowerComp<VarType>::mnaCompOwnRightVectorStampNodes(std::vector<UInt>& matrixNodeIndices) {
+	for (UInt terminal = 0; terminal < this->terminalNumber(); ++terminal) {
+		if (this->terminalNotGrounded(terminal))
+			for (auto index : this->matrixNodeIndices(terminal))
+				matrixNodeIndices.push_back(index);
+	}
+	for (auto node : this->mVirtualNodes) {
+		for (auto index : node->matrixNodeIndices())
+			matrixNodeIndices.push_back(index);
+	}
+	return true;
+}
+
 template<typename VarType>
 void MNASimPowerComp<VarType>::mnaCompUpdateVoltage(const Matrix& leftVector) {
 	// Empty default implementation. Can be overridden by child classes if desired.
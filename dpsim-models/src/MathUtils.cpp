@@ -6,6 +6,8 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  *********************************************************************************/
 
+#include <algorithm>
+
 #include <dpsim-models/MathUtils.h>
 
 using namespace CPS;
@@ -103,6 +105,27 @@ Real Math::realFromVectorElement(const Matrix& mat, Matrix::Index row) {
 	return mat(row, 0);
 }
 
+std::vector<UInt> Math::vectorElementRows(const std::vector<UInt>& matrixNodeIndices) {
+	std::vector<UInt> rows = matrixNodeIndices;
+	std::sort(rows.begin(), rows.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+	return rows;
+}
+
+std::vector<UInt> Math::complexVectorElementRows(const std::vector<UInt>& matrixNodeIndices, Matrix::Index numRows, Int maxFreq) {
+	UInt harmonicOffset = static_cast<UInt>(numRows / maxFreq);
+	UInt complexOffset = harmonicOffset / 2;
+
+	std::vector<UInt> rows;
+	for (auto index : matrixNodeIndices) {
+		for (Int freq = 0; freq < maxFreq; ++freq) {
+			rows.push_back(index + harmonicOffset * freq);
+			rows.push_back(index + complexOffset + harmonicOffset * freq);
+		}
+	}
+	return vectorElementRows(rows);
+}
+
 void Math::setMatrixElement(SparseMatrixRow& mat, Matrix::Index row, Matrix::Index column, Complex value, Int maxFreq, Int freqIdx) {
 	// Assume square matrix
 	Eigen::Index harmonicOffset = mat.rows() / maxFreq;
@@ -152,7 +175,7 @@ void Math::addToMatrixElement(SparseMatrixRow& mat, std::vector<UInt> rows, std:
 }
 
 void Math::addToMatrixElement(SparseMatrixRow& mat, Matrix::Index row, Matrix::Index column, Real value) {
-	mat.coeffRef(row, column) = mat.coeff(row, column) + value;
+	mat.coeffRef(row, column) += value;
 }
 
 void Math::addToMatrixElement(SparseMatrixRow& mat, std::vector<UInt> rows, std::vector<UInt> columns, Real value) {
@@ -309,20 +332,16 @@ Matrix Math::StateSpaceEuler(Matrix states, Matrix A, Matrix input, Real dt) {
 }
 
 void Math::calculateStateSpaceTrapezoidalMatrices(const Matrix & A, const Matrix & B, const Matrix & C, const Real & dt, Matrix & Ad, Matrix & Bd, Matrix & Cd) {
-	Matrix::Index n = A.rows();
-	Matrix I = Matrix::Identity(n, n);
-
-	Matrix F1 = I + (dt/2.) * A;
-	Matrix F2 = I - (dt/2.) * A;
-	Matrix F2inv = F2.inverse();
-
-	Ad = F2inv*F1;
-	Bd = F2inv*(dt/2.)*B;
+	Matrix F2inv;
+	calculateStateSpaceTrapezoidalSystemMatrix(A, dt, F2inv, Ad);
+	calculateStateSpaceTrapezoidalInputMatrix(F2inv, B, dt, Bd);
 	Cd = F2inv*dt*C;
 }
 
 Matrix Math::applyStateSpaceTrapezoidalMatrices(const Matrix & Ad, const Matrix & Bd, const Matrix & Cd, const Matrix & statesPrevStep, const Matrix & inputCurrStep, const Matrix & inputPrevStep) {
-	return Ad*statesPrevStep + Bd*(inputCurrStep + inputPrevStep) + Cd;
+	Matrix statesCurrStep(Ad.rows(), statesPrevStep.cols());
+	updateStateSpaceTrapezoidalStates(Ad, Bd, statesPrevStep, inputCurrStep, inputPrevStep, statesCurrStep);
+	return statesCurrStep + Cd;
 }
 
 void Math::FFT(std::vector<Complex>& samples) {
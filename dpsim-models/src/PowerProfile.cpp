@@ -0,0 +1,61 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+
+#include <dpsim-models/PowerProfile.h>
+
+using namespace CPS;
+
+void ProfileTable::detectTimeBase() {
+	timeStep = 0;
+	if (times.size() < 2)
+		return;
+
+	Real step = (times.back() - times.front()) / (times.size() - 1);
+	if (step <= 0)
+		return;
+	for (std::size_t i = 1; i < times.size(); ++i) {
+		if (std::abs(times[i] - (times.front() + i * step)) > 1e-6 * step)
+			return;
+	}
+	timeStep = step;
+}
+
+void PowerProfile::seek(Real time) {
+	const std::vector<Real>& times = mTable->times;
+	UInt numSamples = static_cast<UInt>(times.size());
+
+	if (mTable->timeStep > 0) {
+		Real position = std::floor((time - times.front()) / mTable->timeStep + 1e-9);
+		mCursor = static_cast<UInt>(std::min(std::max(position, 0.), Real(numSamples - 1)));
+		return;
+	}
+
+	// going back in time restarts the search
+	if (mCursor >= numSamples || time < times[mCursor]) {
+		auto next = std::upper_bound(times.begin(), times.end(), time);
+		mCursor = next == times.begin() ? 0 : static_cast<UInt>(next - times.begin() - 1);
+		return;
+	}
+	while (mCursor + 1 < numSamples && times[mCursor + 1] <= time)
+		++mCursor;
+}
+
+Real PowerProfile::value(Real time, UInt column) {
+	if (empty())
+		throw SystemError("Profile has no samples.");
+
+	seek(time);
+	const std::vector<Real>& times = mTable->times;
+	if (time <= times[mCursor] || mCursor + 1 >= times.size())
+		return mTable->values(mCursor, column);
+
+	const Real delta = (time - times[mCursor]) / (times[mCursor + 1] - times[mCursor]);
+	return delta * mTable->values(mCursor + 1, column) + (1 - delta) * mTable->values(mCursor, column);
+}
@@ -76,11 +76,12 @@ void SP::Ph1::Load::modifyPowerFlowBusType(PowerflowBusType powerflowBusType) {
 
 
 void SP::Ph1::Load::updatePQ(Real time) {
-	if (mLoadProfile.weightingFactors.empty()) {
-		**mActivePower = mLoadProfile.pqData.find(time)->second.p;
-		**mReactivePower = mLoadProfile.pqData.find(time)->second.q;
+	if (mLoadProfile.type() == PowerProfile::Type::PQ) {
+		PQData pq = mLoadProfile.pq(time);
+		**mActivePower = pq.p;
+		**mReactivePower = pq.q;
 	} else {
-		Real wf = mLoadProfile.weightingFactors.find(time)->second;
+		Real wf = mLoadProfile.weightingFactor(time);
 		///THISISBAD: P_nom and Q_nom do not exist as attributes
 		Real P_new = this->attributeTyped<Real>("P_nom")->get()*wf;
 		Real Q_new = this->attributeTyped<Real>("Q_nom")->get()*wf;
@@ -35,6 +35,7 @@ void PLL::setParameters(Real kpPLL, Real kiPLL, Real omegaNom) {
 
 void PLL::setSimulationParameters(Real timestep) {
     mTimeStep = timestep;
+    mStateSpace.setTimeStep(mTimeStep);
     SPDLOG_LOGGER_INFO(mSLog, "Integration step = {}", mTimeStep);
 }
 
@@ -57,6 +58,9 @@ void PLL::composeStateSpaceMatrices() {
     mD <<   0,  0,
             0,  0;
 
+    mStateSpace.setSystemMatrix(mA);
+    mStateSpace.setInputMatrix(mB);
+
     SPDLOG_LOGGER_INFO(mSLog, "State space matrices:");
     SPDLOG_LOGGER_INFO(mSLog, "A = \n{}", mA);
     SPDLOG_LOGGER_INFO(mSLog, "B = \n{}", mB);
@@ -89,7 +93,7 @@ void PLL::signalStep(Real time, Int timeStepCount) {
     SPDLOG_LOGGER_TRACE(mSLog, "Time {}:", time);
     SPDLOG_LOGGER_TRACE(mSLog, "Input values: inputCurr = ({}, {}), inputPrev = ({}, {}), stateCurr = ({}, {}), statePrev = ({}, {})", (**mInputCurr)(0,0), (**mInputCurr)(1,0), (**mInputPrev)(0,0), (**mInputPrev)(1,0), (**mStateCurr)(0,0), (**mStateCurr)(1,0), (**mStatePrev)(0,0), (**mStatePrev)(1,0));
 
-    **mStateCurr = Math::StateSpaceTrapezoidal(**mStatePrev, mA, mB, mTimeStep, **mInputCurr, **mInputPrev);
+    mStateSpace.step(**mStatePrev, **mInputCurr, **mInputPrev, **mStateCurr);
     **mOutputCurr = mC * **mStateCurr + mD * **mInputCurr;
 
     SPDLOG_LOGGER_TRACE(mSLog, "State values: stateCurr = ({}, {})", (**mStateCurr)(0,0), (**mStateCurr)(1,0));
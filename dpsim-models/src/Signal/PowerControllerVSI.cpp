@@ -83,6 +83,9 @@ void PowerControllerVSI::setControllerParameters(Real Kp_powerCtrl, Real Ki_powe
 		mKpCurrCtrld*mKpPowerCtrld, 0, 0, 0, -mKpCurrCtrld, 0,
 		0, -mKpCurrCtrlq * mKpPowerCtrlq, 0, 0, 0, -mKpCurrCtrlq;
 
+	mStateSpace.setSystemMatrix(mA);
+	mStateSpace.setInputMatrix(mB);
+
 	SPDLOG_LOGGER_INFO(mSLog, "State space matrices:");
     SPDLOG_LOGGER_INFO(mSLog, "A = \n{}", mA);
     SPDLOG_LOGGER_INFO(mSLog, "B = \n{}", mB);
@@ -109,6 +112,7 @@ void PowerControllerVSI::setInitialStateValues(Real pInit, Real qInit,
 void PowerControllerVSI::initializeStateSpaceModel(Real omega, Real timeStep, Attribute<Matrix>::Ptr leftVector) {
 	mTimeStep = timeStep;
 	mOmegaCutoff = omega;
+	mStateSpace.setTimeStep(mTimeStep);
 
 	// update B matrix due to its dependence on Irc
 	updateBMatrixStateSpaceModel();
@@ -157,7 +161,7 @@ void PowerControllerVSI::signalStep(Real time, Int timeStepCount) {
     SPDLOG_LOGGER_DEBUG(mSLog, "Time {}\n: inputCurr = \n{}\n , inputPrev = \n{}\n , statePrev = \n{}", time, **mInputCurr, **mInputPrev, **mStatePrev);
 
 	// calculate new states
-	**mStateCurr = Math::StateSpaceTrapezoidal(**mStatePrev, mA, mB, mTimeStep, **mInputCurr, **mInputPrev);
+	mStateSpace.step(**mStatePrev, **mInputCurr, **mInputPrev, **mStateCurr);
 	SPDLOG_LOGGER_DEBUG(mSLog, "stateCurr = \n {}", **mStateCurr);
 
 	// calculate new outputs
@@ -170,6 +174,7 @@ void PowerControllerVSI::updateBMatrixStateSpaceModel() {
 	mB.coeffRef(0, 3) = mOmegaCutoff * **mIrc_q;
 	mB.coeffRef(1, 2) = -mOmegaCutoff * **mIrc_q;
 	mB.coeffRef(1, 3) = mOmegaCutoff * **mIrc_d;
+	mStateSpace.setInputMatrix(mB);
 }
 
 Task::List PowerControllerVSI::getTasks() {
@@ -0,0 +1,198 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+
+#include <DPsim.h>
+#include <dpsim/PFContingencySolver.h>
+
+using namespace DPsim;
+
+// Compares the snapshots solved in parallel by the batch powerflow and the outages verified by the
+// contingency analysis of the WSCC 9-bus system against powerflow simulations of the same operating
+// points and of the topologies without the outaged branch solved one after another.
+
+std::list<fs::path> filenames;
+
+SystemTopology loadSystem(const String& name) {
+	CPS::CIM::Reader reader(name, CPS::Logger::Level::off, CPS::Logger::Level::off);
+	return reader.loadCIM(60, filenames, CPS::Domain::SP, CPS::PhaseType::Single, CPS::GeneratorType::PVNode);
+}
+
+void scaleLoads(SystemTopology& system, Real scale) {
+	for (auto comp : system.mComponents) {
+		if (auto load = std::dynamic_pointer_cast<CPS::SP::Ph1::Load>(comp)) {
+			load->attributeTyped<Real>("P")->set(load->attributeTyped<Real>("P")->get() * scale);
+			load->attributeTyped<Real>("Q")->set(load->attributeTyped<Real>("Q")->get() * scale);
+		}
+	}
+}
+
+MatrixComp solveSequential(const String& simName, SystemTopology& system) {
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(system);
+	sim.setTimeStep(1);
+	sim.setFinalTime(1);
+	sim.setDomain(CPS::Domain::SP);
+	sim.setSolverType(Solver::Type::NRP);
+	sim.doInitFromNodesAndTerminals(true);
+	sim.run();
+
+	MatrixComp voltages(system.mNodes.size(), 1);
+	for (UInt idx = 0; idx < system.mNodes.size(); ++idx)
+		voltages(idx, 0) = std::dynamic_pointer_cast<CPS::SimNode<Complex>>(system.mNodes[idx])->singleVoltage();
+	return voltages;
+}
+
+// net nodal injections of the topology with scaled loads, one row per node in the order of the topology
+void nodalInjections(SystemTopology& system, Real scale, Matrix& activePower, Matrix& reactivePower, UInt column) {
+	for (UInt idx = 0; idx < system.mNodes.size(); ++idx) {
+		activePower(idx, column) = 0;
+		reactivePower(idx, column) = 0;
+		for (auto comp : system.mComponentsAtNode[system.mNodes[idx]]) {
+			if (auto load = std::dynamic_pointer_cast<CPS::SP::Ph1::Load>(comp)) {
+				activePower(idx, column) -= load->attributeTyped<Real>("P")->get() * scale;
+				reactivePower(idx, column) -= load->attributeTyped<Real>("Q")->get() * scale;
+			}
+			else if (auto gen = std::dynamic_pointer_cast<CPS::SP::Ph1::SynchronGenerator>(comp))
+				activePower(idx, column) += gen->attributeTyped<Real>("P_set")->get();
+		}
+	}
+}
+
+void removeBranch(SystemTopology& system, const String& name) {
+	auto branch = system.component<CPS::TopologicalPowerComp>(name);
+	auto& components = system.mComponents;
+	components.erase(std::remove(components.begin(), components.end(), branch), components.end());
+	for (auto& node : system.mComponentsAtNode)
+		node.second.erase(std::remove(node.second.begin(), node.second.end(), branch), node.second.end());
+}
+
+// apparent power of each line and transformer at the terminal with the higher flow
+std::map<String, Real> branchLoadings(SystemTopology& system) {
+	std::map<String, Real> loadings;
+	for (auto comp : system.mComponents) {
+		if (!std::dynamic_pointer_cast<CPS::SP::Ph1::PiLine>(comp) && !std::dynamic_pointer_cast<CPS::SP::Ph1::Transformer>(comp))
+			continue;
+		Matrix p = comp->attributeTyped<Matrix>("p_branch_vector")->get();
+		Matrix q = comp->attributeTyped<Matrix>("q_branch_vector")->get();
+		loadings[comp->name()] = std::max(std::abs(Complex(p(0, 0), q(0, 0))), std::abs(Complex(p(1, 0), q(1, 0))));
+	}
+	return loadings;
+}
+
+Bool checkContingencies() {
+	auto system = loadSystem("PF_WSCC9bus_Contingency");
+	PFContingencySolver contingency("PF_WSCC9bus_Contingency", system);
+	contingency.setNumberOfThreads(2);
+	// limits far below all flows, so that every outage is verified and reports the loading of all other branches
+	for (auto comp : system.mComponents)
+		if (std::dynamic_pointer_cast<CPS::SP::Ph1::PiLine>(comp) || std::dynamic_pointer_cast<CPS::SP::Ph1::Transformer>(comp))
+			contingency.setBranchLimit(comp->name(), 1.);
+	auto results = contingency.analyze();
+
+	Bool valid = true;
+	for (auto& result : results) {
+		// the generator transformers connect the generators radially
+		Bool transformer = static_cast<Bool>(system.component<CPS::SP::Ph1::Transformer>(result.outage));
+		if (result.islanding != transformer) {
+			std::cerr << "Outage of " << result.outage << (transformer ? " does not island" : " islands") << std::endl;
+			valid = false;
+			continue;
+		}
+		if (result.islanding)
+			continue;
+		if (!result.verified || !result.converged) {
+			std::cerr << "Outage of " << result.outage << " was not solved" << std::endl;
+			valid = false;
+			continue;
+		}
+
+		auto reference = loadSystem("PF_WSCC9bus_Outage");
+		removeBranch(reference, result.outage);
+		solveSequential("PF_WSCC9bus_Outage", reference);
+		auto loadings = branchLoadings(reference);
+		Real maxLoading = 0;
+		for (auto& loading : loadings)
+			maxLoading = std::max(maxLoading, loading.second);
+
+		UInt numOverloads = 0;
+		for (auto& violation : result.violations) {
+			if (violation.type != PFContingencyViolation::Type::BranchOverload)
+				continue;
+			++numOverloads;
+			if (std::abs(violation.value - loadings[violation.element]) > 1e-6 * maxLoading) {
+				std::cerr << "Outage of " << result.outage << ": loading of " << violation.element << " is " << violation.value
+					<< " instead of " << loadings[violation.element] << std::endl;
+				valid = false;
+			}
+		}
+		if (numOverloads != loadings.size()) {
+			std::cerr << "Outage of " << result.outage << ": " << numOverloads << " loadings for " << loadings.size() << " branches" << std::endl;
+			valid = false;
+		}
+	}
+	return valid;
+}
+
+Bool compare(const String& name, const MatrixComp& reference, const MatrixComp& voltages, Real tolerance) {
+	Real deviation = (voltages - reference).cwiseAbs().maxCoeff() / reference.cwiseAbs().maxCoeff();
+	if (deviation > tolerance) {
+		std::cerr << name << ": relative deviation " << deviation << " from the sequential solution" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	filenames = DPsim::Utils::findFiles({
+		"WSCC-09_RX_DI.xml",
+		"WSCC-09_RX_EQ.xml",
+		"WSCC-09_RX_SV.xml",
+		"WSCC-09_RX_TP.xml"
+	}, "build/_deps/cim-data-src/WSCC-09/WSCC-09_RX", "CIMPATH");
+
+	// the overloaded snapshot does not converge, the following ones of the same worker
+	// must not continue from its solution
+	std::vector<Real> scales = { 0.8, 1.0, 1.2, 50.0, 0.9, 1.1 };
+	const UInt overloaded = 3;
+
+	auto system = loadSystem("PF_WSCC9bus_Batch");
+	Matrix activePower(system.mNodes.size(), scales.size());
+	Matrix reactivePower(system.mNodes.size(), scales.size());
+	for (UInt snapshot = 0; snapshot < scales.size(); ++snapshot)
+		nodalInjections(system, scales[snapshot], activePower, reactivePower, snapshot);
+
+	PFBatchSolver batch("PF_WSCC9bus_Batch", system);
+	batch.setNumberOfThreads(2);
+	batch.doWarmStart(true);
+	auto result = batch.solve(activePower, reactivePower);
+
+	Bool valid = true;
+	if (result.iterations[overloaded] >= 0) {
+		std::cerr << "Overloaded snapshot converged" << std::endl;
+		valid = false;
+	}
+	for (UInt snapshot = 0; snapshot < scales.size(); ++snapshot) {
+		if (snapshot == overloaded)
+			continue;
+		String name = "Snapshot " + std::to_string(snapshot);
+		if (result.iterations[snapshot] < 0) {
+			std::cerr << name << " did not converge" << std::endl;
+			valid = false;
+			continue;
+		}
+
+		auto reference = loadSystem("PF_WSCC9bus_Sequential");
+		scaleLoads(reference, scales[snapshot]);
+		valid = compare(name, solveSequential("PF_WSCC9bus_Sequential", reference), result.voltages.col(snapshot), 1e-6) && valid;
+	}
+
+	valid = checkContingencies() && valid;
+	return valid ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <functional>
+
+#include <DPsim.h>
+
+using namespace DPsim;
+
+// Compares the powerflow solutions of the WSCC 9-bus system obtained with the
+// different powerflow solver configurations against the dense Newton-Raphson solver.
+
+std::list<fs::path> filenames;
+
+MatrixComp solvePowerflow(const String& simName, Solver::Type solverType,
+	const std::function<void(Simulation&)>& configure) {
+
+	CPS::CIM::Reader reader(simName, CPS::Logger::Level::off, CPS::Logger::Level::off);
+	SystemTopology system = reader.loadCIM(60, filenames, CPS::Domain::SP, CPS::PhaseType::Single, CPS::GeneratorType::PVNode);
+
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(system);
+	sim.setTimeStep(1);
+	sim.setFinalTime(1);
+	sim.setDomain(CPS::Domain::SP);
+	sim.setSolverType(solverType);
+	sim.doInitFromNodesAndTerminals(true);
+	configure(sim);
+	sim.run();
+
+	MatrixComp voltages(system.mNodes.size(), 1);
+	for (UInt idx = 0; idx < system.mNodes.size(); ++idx)
+		voltages(idx, 0) = std::dynamic_pointer_cast<CPS::SimNode<Complex>>(system.mNodes[idx])->singleVoltage();
+	return voltages;
+}
+
+struct PowerflowSeries {
+	/// Voltages of all nodes after each time step
+	std::vector<MatrixComp> voltages;
+	/// Newton-Raphson iterations and Jacobian factorizations of each time step
+	std::vector<Int> iterations;
+	std::vector<Int> factorizations;
+};
+
+Int solverStatistic(Simulation& sim, const String& name) {
+	return std::dynamic_pointer_cast<CPS::Attribute<Int>>(sim.getIdObjAttribute(sim.name() + "_PF", name).getPtr())->get();
+}
+
+// Solves the powerflow in consecutive time steps while the loads rise by 2% per step
+PowerflowSeries solvePowerflowSeries(const String& simName, const std::function<void(Simulation&)>& configure) {
+	const UInt numSteps = 6;
+
+	CPS::CIM::Reader reader(simName, CPS::Logger::Level::off, CPS::Logger::Level::off);
+	SystemTopology system = reader.loadCIM(60, filenames, CPS::Domain::SP, CPS::PhaseType::Single, CPS::GeneratorType::PVNode);
+
+	std::vector<std::pair<std::shared_ptr<CPS::SP::Ph1::Load>, Complex>> loads;
+	for (auto comp : system.mComponents) {
+		if (auto load = std::dynamic_pointer_cast<CPS::SP::Ph1::Load>(comp))
+			loads.emplace_back(load, Complex(**load->mActivePower, **load->mReactivePower));
+	}
+
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(system);
+	sim.setTimeStep(1);
+	sim.setFinalTime(numSteps);
+	sim.setDomain(CPS::Domain::SP);
+	sim.setSolverType(Solver::Type::NRP);
+	sim.doInitFromNodesAndTerminals(true);
+	sim.doSparseJacobian();
+	configure(sim);
+
+	PowerflowSeries series;
+	sim.start();
+	for (UInt step = 0; step < numSteps; ++step) {
+		for (auto& load : loads) {
+			**load.first->mActivePower = load.second.real() * (1. + 0.02 * step);
+			**load.first->mReactivePower = load.second.imag() * (1. + 0.02 * step);
+		}
+		sim.next();
+
+		MatrixComp voltages(system.mNodes.size(), 1);
+		for (UInt idx = 0; idx < system.mNodes.size(); ++idx)
+			voltages(idx, 0) = std::dynamic_pointer_cast<CPS::SimNode<Complex>>(system.mNodes[idx])->singleVoltage();
+		series.voltages.push_back(voltages);
+		series.iterations.push_back(solverStatistic(sim, "iterations"));
+		series.factorizations.push_back(solverStatistic(sim, "factorizations"));
+	}
+	sim.stop();
+	return series;
+}
+
+// Compares the solutions of all time steps and sums the iterations and factorizations after the first step
+Bool compareSeries(const String& name, const PowerflowSeries& reference, const PowerflowSeries& series,
+	Real tolerance, Int& iterations, Int& factorizations) {
+	Bool valid = true;
+	iterations = 0;
+	factorizations = 0;
+	for (std::size_t step = 0; step < reference.voltages.size(); ++step) {
+		Real deviation = (series.voltages[step] - reference.voltages[step]).cwiseAbs().maxCoeff()
+			/ reference.voltages[step].cwiseAbs().maxCoeff();
+		if (!(deviation <= tolerance)) {
+			std::cerr << name << ": relative deviation " << deviation << " from the cold start in step " << step << std::endl;
+			valid = false;
+		}
+		if (step > 0) {
+			iterations += series.iterations[step];
+			factorizations += series.factorizations[step];
+		}
+	}
+	return valid;
+}
+
+Bool compare(const String& name, const MatrixComp& reference, const MatrixComp& voltages, Real tolerance) {
+	Real deviation = (voltages - reference).cwiseAbs().maxCoeff() / reference.cwiseAbs().maxCoeff();
+	if (deviation > tolerance) {
+		std::cerr << name << ": relative deviation " << deviation << " from the dense Newton-Raphson solution" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	filenames = DPsim::Utils::findFiles({
+		"WSCC-09_RX_DI.xml",
+		"WSCC-09_RX_EQ.xml",
+		"WSCC-09_RX_SV.xml",
+		"WSCC-09_RX_TP.xml"
+	}, "build/_deps/cim-data-src/WSCC-09/WSCC-09_RX", "CIMPATH");
+
+	auto dense = solvePowerflow("PF_WSCC9bus_Dense", Solver::Type::NRP, [](Simulation& sim) { });
+	Bool valid = true;
+
+	auto sparse = solvePowerflow("PF_WSCC9bus_Sparse", Solver::Type::NRP, [](Simulation& sim) {
+		sim.doSparseJacobian();
+	});
+	valid = compare("Sparse Jacobian", dense, sparse, 1e-8) && valid;
+
+	auto sparseLU = solvePowerflow("PF_WSCC9bus_SparseLU", Solver::Type::NRP, [](Simulation& sim) {
+		sim.doSparseJacobian();
+		sim.setDirectLinearSolverImplementation(DirectLinearSolverImpl::SparseLU);
+	});
+	valid = compare("Sparse Jacobian with SparseLU", dense, sparseLU, 1e-8) && valid;
+
+	// later time steps continue from the last solution and keep the factorized Jacobian
+	// as long as the iterations still converge fast enough
+	auto warmStart = solvePowerflow("PF_WSCC9bus_WarmStart", Solver::Type::NRP, [](Simulation& sim) {
+		sim.doSparseJacobian();
+		sim.doPowerflowWarmStart(true, 0.5);
+		sim.setFinalTime(3);
+	});
+	valid = compare("Warm start with Jacobian reuse", dense, warmStart, 1e-6) && valid;
+
+	// with changing loads, each step starts from the previous solution instead of a flat start
+	Int coldIterations, coldFactorizations, warmIterations, warmFactorizations, reuseIterations, reuseFactorizations;
+	auto coldSeries = solvePowerflowSeries("PF_WSCC9bus_ColdStartSeries", [](Simulation& sim) { });
+	compareSeries("Cold start", coldSeries, coldSeries, 0, coldIterations, coldFactorizations);
+
+	auto warmSeries = solvePowerflowSeries("PF_WSCC9bus_WarmStartSeries", [](Simulation& sim) {
+		sim.doPowerflowWarmStart(true, 0.);
+	});
+	valid = compareSeries("Warm start", coldSeries, warmSeries, 1e-6, warmIterations, warmFactorizations) && valid;
+	if (warmIterations >= coldIterations) {
+		std::cerr << "Warm start: " << warmIterations << " iterations after the first step instead of less than the "
+			<< coldIterations << " of the cold start" << std::endl;
+		valid = false;
+	}
+
+	// the Jacobian factorized in an earlier iteration or step is kept while the mismatch halves in each iteration
+	auto reuseSeries = solvePowerflowSeries("PF_WSCC9bus_JacobianReuseSeries", [](Simulation& sim) {
+		sim.doPowerflowWarmStart(true, 0.5);
+	});
+	valid = compareSeries("Warm start with Jacobian reuse", coldSeries, reuseSeries, 1e-6, reuseIterations, reuseFactorizations) && valid;
+	if (reuseFactorizations >= reuseIterations) {
+		std::cerr << "Warm start with Jacobian reuse: " << reuseFactorizations << " factorizations in "
+			<< reuseIterations << " iterations after the first step" << std::endl;
+		valid = false;
+	}
+
+	// the fast-decoupled iterations stop at the same mismatch tolerance, but approach the solution linearly
+	auto fastDecoupledXB = solvePowerflow("PF_WSCC9bus_FDLF_XB", Solver::Type::FDLF, [](Simulation& sim) {
+		sim.setFastDecoupledVariant(FastDecoupledVariant::XB);
+	});
+	valid = compare("Fast-decoupled XB", dense, fastDecoupledXB, 1e-6) && valid;
+
+	auto fastDecoupledBX = solvePowerflow("PF_WSCC9bus_FDLF_BX", Solver::Type::FDLF, [](Simulation& sim) {
+		sim.setFastDecoupledVariant(FastDecoupledVariant::BX);
+	});
+	valid = compare("Fast-decoupled BX", dense, fastDecoupledBX, 1e-6) && valid;
+
+	return valid ? 0 : 1;
+}
@@ -46,7 +46,7 @@ void multiply_decoupled(SystemTopology& sys, int copies,
 	}
 }
 
-void simulateDecoupled(std::list<fs::path> filenames, Int copies, Int threads, Int seq = 0) {
+void simulateDecoupled(std::list<fs::path> filenames, Int copies, Int threads, Int seq = 0, Bool sharedSymbolic = false) {
 	String simName = "WSCC_9bus_decoupled_" + std::to_string(copies)
 		+ "_" + std::to_string(threads) + "_" + std::to_string(seq);
 	Logger::setLogDir("logs/"+simName);
@@ -62,6 +62,8 @@ void simulateDecoupled(std::list<fs::path> filenames, Int copies, Int threads, I
 	sim.setTimeStep(0.0001);
 	sim.setFinalTime(0.5);
 	sim.setDomain(Domain::DP);
+	if (sharedSymbolic)
+		sim.doSharedSymbolicAnalysis();
 	if (threads > 0)
 		sim.setScheduler(std::make_shared<OpenMPLevelScheduler>(threads));
 
@@ -83,6 +85,7 @@ void simulateDecoupled(std::list<fs::path> filenames, Int copies, Int threads, I
 	//std::ofstream of1("topology_graph.svg");
 	//sys.topologyGraph().render(of1));
 
+	sim.doTimingTrace();
 	sim.run();
 	sim.logStepTimes(simName + "_step_times");
 }
@@ -107,6 +110,7 @@ int main(int argc, char *argv[]) {
 	Int numCopies = 0;
 	Int numThreads = 0;
 	Int numSeq = 0;
+	Bool sharedSymbolic = false;
 
 	if (args.options.find("copies") != args.options.end())
 		numCopies = args.getOptionInt("copies");
@@ -114,9 +118,11 @@ int main(int argc, char *argv[]) {
 		numThreads = args.getOptionInt("threads");
 	if (args.options.find("seq") != args.options.end())
 		numSeq = args.getOptionInt("seq");
+	if (args.options.find("shared-symbolic") != args.options.end())
+		sharedSymbolic = args.getOptionBool("shared-symbolic");
 
 	std::cout << "Simulate with " << numCopies << " copies, "
 		<< numThreads << " threads, sequence number "
-		<< numSeq << std::endl;
-	simulateDecoupled(filenames, numCopies,	numThreads, numSeq);
+		<< numSeq << (sharedSymbolic ? ", shared symbolic analysis" : "") << std::endl;
+	simulateDecoupled(filenames, numCopies,	numThreads, numSeq, sharedSymbolic);
 }
@@ -98,6 +98,7 @@ void simulateDiakoptics(std::list<fs::path> filenames,
 	//}
 	//sim.addLogger(logger);
 
+	sim.doTimingTrace();
 	sim.run();
 	sim.logStepTimes(simName + "_step_times");
 }
@@ -0,0 +1,198 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <cmath>
+#include <fstream>
+
+#include <DPsim.h>
+#include <dpsim-models/CSVReader.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+// Compares the load profiles interpolated on demand from the shared profile tables against the
+// interpolation of the samples stored in a std::map, which readLoadProfile used to precompute for
+// every time step. Times are evaluated forwards and backwards, loads assigned to the same file
+// share its table but keep their own position in it.
+// The parsing of the profile files is checked with time-of-day stamps, a cropped interval and
+// files with rows out of order or with missing values, which are skipped.
+
+struct ProfileSample {
+	Real time;
+	Real p;
+	Real q;
+};
+
+const std::vector<ProfileSample> equidistantSamples = {
+	{ 0, 10, 1 }, { 10, 12, 1.5 }, { 20, 9, 2 }, { 30, 15, 0.5 }, { 40, 15, -1 },
+	{ 50, 7, 0 }, { 60, 11, 3 }, { 70, 20, 2.5 }, { 80, 18, 1 }, { 90, 10, 1 }
+};
+
+const std::vector<ProfileSample> irregularSamples = {
+	{ 0, 5, 0 }, { 5, 8, 1 }, { 20, 6, 2 }, { 21, 30, -2 }, { 50, 25, 1 }, { 51.5, 4, 0 }, { 90, 12, 3 }
+};
+
+// Profile file with a title row and the powers in kW and kvar
+fs::path writeProfile(const fs::path& directory, const String& name, const std::vector<ProfileSample>& samples) {
+	fs::path file = directory / (name + ".csv");
+	std::ofstream csv(file);
+	csv << "time,p,q\n";
+	for (auto& sample : samples)
+		csv << sample.time << "," << sample.p << "," << sample.q << "\n";
+	return file;
+}
+
+// Samples as the previous implementation stored them, in W and var
+std::map<Real, PQData> sampleMap(const std::vector<ProfileSample>& samples) {
+	std::map<Real, PQData> map;
+	for (auto& sample : samples)
+		map[sample.time] = { sample.p * 1000, sample.q * 1000 };
+	return map;
+}
+
+// Times from before the first to after the last sample, forwards, backwards and forwards again
+std::vector<Real> evaluationTimes() {
+	std::vector<Real> times;
+	for (Real time = -5; time <= 100; time += 2.5)
+		times.push_back(time);
+	for (Real time = 97; time >= -3; time -= 7)
+		times.push_back(time);
+	for (Real time = 20; time <= 55; time += 0.5)
+		times.push_back(time);
+	times.push_back(90);
+	times.push_back(0);
+	return times;
+}
+
+Bool checkValue(const String& name, Real time, Real value, Real expected) {
+	if (std::abs(value - expected) > 1e-9 * std::max(1., std::abs(expected))) {
+		std::cerr << name << " at " << time << " s: " << value << " instead of " << expected << std::endl;
+		return false;
+	}
+	return true;
+}
+
+Bool checkProfile(const String& name, CSVReader& reader, const fs::path& file,
+	const std::vector<ProfileSample>& samples, Bool equidistant) {
+	PowerProfile profile = reader.readLoadProfile(file);
+	Bool valid = true;
+	if (profile.type() != PowerProfile::Type::PQ || (profile.table()->timeStep > 0) != equidistant) {
+		std::cerr << name << ": wrong profile type or time base" << std::endl;
+		valid = false;
+	}
+
+	auto reference = sampleMap(samples);
+	for (Real time : evaluationTimes()) {
+		PQData pq = profile.pq(time);
+		PQData expected = reader.interpol_linear(reference, time);
+		valid = checkValue(name + " active power", time, pq.p, expected.p) && valid;
+		valid = checkValue(name + " reactive power", time, pq.q, expected.q) && valid;
+	}
+	return valid;
+}
+
+// Two loads assigned to the same file are updated alternately, one forwards and one backwards in time
+Bool checkSharedTable(const fs::path& directory, const std::vector<ProfileSample>& samples) {
+	auto load1 = SP::Ph1::Load::make("load1");
+	auto load2 = SP::Ph1::Load::make("load2");
+	SystemTopology sys(50, SystemNodeList{}, SystemComponentList{ load1, load2 });
+
+	std::map<String, String> assignList = { { "load1", "irregular" }, { "load2", "irregular" } };
+	CSVReader reader("CSVReader_LoadProfiles_Shared", directory.string() + "/", assignList, Logger::Level::off);
+	reader.assignLoadProfile(sys, -1, 1, -1, CSVReader::Mode::MANUAL);
+
+	Bool valid = true;
+	if (!load1->use_profile || !load2->use_profile || !load1->mLoadProfile.table()
+		|| load1->mLoadProfile.table() != load2->mLoadProfile.table()) {
+		std::cerr << "Shared table: the loads do not share the table of their file" << std::endl;
+		return false;
+	}
+
+	auto reference = sampleMap(samples);
+	for (Real time = 0; time <= 90; time += 1.5) {
+		Real backwards = 90 - time;
+		load1->updatePQ(time);
+		load2->updatePQ(backwards);
+		valid = checkValue("Shared table forwards", time, **load1->mActivePower, reader.interpol_linear(reference, time).p) && valid;
+		valid = checkValue("Shared table backwards", backwards, **load2->mReactivePower, reader.interpol_linear(reference, backwards).q) && valid;
+	}
+	return valid;
+}
+
+fs::path writeFile(const fs::path& directory, const String& name, const String& contents) {
+	fs::path file = directory / name;
+	std::ofstream csv(file);
+	csv << contents;
+	return file;
+}
+
+Bool checkTable(const String& name, const PowerProfile& profile, const std::vector<ProfileSample>& samples) {
+	auto table = profile.table();
+	Bool valid = table && table->times.size() == samples.size() && table->values.rows() == static_cast<Eigen::Index>(samples.size());
+	for (std::size_t row = 0; valid && row < samples.size(); ++row) {
+		valid = table->times[row] == samples[row].time
+			&& std::abs(table->values(row, 0) - samples[row].p * 1000) < 1e-9
+			&& std::abs(table->values(row, 1) - samples[row].q * 1000) < 1e-9;
+	}
+	if (!valid) {
+		std::cerr << name << ": samples differ from";
+		for (auto& sample : samples)
+			std::cerr << " " << sample.time << "," << sample.p << "," << sample.q;
+		std::cerr << std::endl;
+	}
+	return valid;
+}
+
+Bool checkParsing(const fs::path& directory, const fs::path& equidistant) {
+	CSVReader reader("CSVReader_LoadProfiles_Parsing", std::list<fs::path>{}, Logger::Level::off);
+
+	// time stamps of the day are converted to seconds
+	fs::path timeOfDay = writeFile(directory, "time_of_day.csv",
+		"time,p,q\n00:00:00,1,0.5\n00:01:00,2,1\n00:02:30,3,1.5\n01:00:00,4,2\n");
+	Bool valid = checkTable("Time of day", reader.readLoadProfile(timeOfDay, -1, 1, -1, CSVReader::DataFormat::HHMMSS),
+		{ { 0, 1, 0.5 }, { 60, 2, 1 }, { 150, 3, 1.5 }, { 3600, 4, 2 } });
+
+	// the interval is extended to the samples enclosing it, so that its ends can be interpolated
+	valid = checkTable("Cropped interval", reader.readLoadProfile(equidistant, 15, 1, 55),
+		{ equidistantSamples.begin() + 1, equidistantSamples.begin() + 7 }) && valid;
+	valid = checkTable("Cropped at sample", reader.readLoadProfile(equidistant, 20, 1, 40),
+		{ equidistantSamples.begin() + 2, equidistantSamples.begin() + 6 }) && valid;
+
+	// a row going back in time, a row without reactive power and a row without values are skipped
+	fs::path skipped = writeFile(directory, "skipped.csv",
+		"time,p,q\n0,1,0\n10,2,1\n5,9,9\n20,3,2\n30,4\n35,,1\n40\n\n50,5,3\n");
+	valid = checkTable("Skipped rows", reader.readLoadProfile(skipped),
+		{ { 0, 1, 0 }, { 10, 2, 1 }, { 20, 3, 2 }, { 50, 5, 3 } }) && valid;
+
+	// csv2Eigen skips rows whose number of columns differs from the first row
+	fs::path matrixFile = writeFile(directory, "matrix.csv", "1,2,3\n4,5\n\n6,7,8\n9,10,11,12\n");
+	MatrixRow matrix = reader.csv2Eigen(matrixFile.string());
+	MatrixRow expected(2, 3);
+	expected << 1, 2, 3, 6, 7, 8;
+	if (matrix.rows() != expected.rows() || matrix.cols() != expected.cols() || matrix != expected) {
+		std::cerr << "Matrix file: " << matrix.rows() << "x" << matrix.cols() << " matrix instead of [1 2 3; 6 7 8]" << std::endl;
+		valid = false;
+	}
+	return valid;
+}
+
+int main(int argc, char* argv[]) {
+	fs::path directory = fs::temp_directory_path() / "CSVReader_LoadProfiles";
+	fs::create_directories(directory);
+	fs::path equidistant = writeProfile(directory, "equidistant", equidistantSamples);
+	fs::path irregular = writeProfile(directory, "irregular", irregularSamples);
+
+	CSVReader reader("CSVReader_LoadProfiles", std::list<fs::path>{ equidistant, irregular }, Logger::Level::off);
+	Bool valid = checkProfile("Equidistant profile", reader, equidistant, equidistantSamples, true);
+	valid = checkProfile("Non-equidistant profile", reader, irregular, irregularSamples, false) && valid;
+	valid = checkSharedTable(directory, irregularSamples) && valid;
+	valid = checkParsing(directory, equidistant) && valid;
+
+	fs::remove_all(directory);
+	return valid ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+
+using namespace DPsim;
+
+// Checks that a component which reports its right vector stamp nodes, and is therefore
+// only gathered at these rows, does not stamp into other rows. Otherwise the sparse
+// right side vector would differ from the sum of the complete stamps.
+template <typename VarType>
+void checkComponent(const typename CPS::SimPowerComp<VarType>::Ptr& comp, UInt& numSparse, Bool& stamped, Bool& valid) {
+	for (auto subComp : comp->subComponents())
+		checkComponent<VarType>(subComp, numSparse, stamped, valid);
+
+	auto mnaComp = std::dynamic_pointer_cast<CPS::MNAInterface>(comp);
+	if (!mnaComp)
+		return;
+
+	const Matrix& stamp = **mnaComp->getRightVector();
+	std::vector<UInt> matrixNodeIndices;
+	if (stamp.size() == 0 || !mnaComp->mnaRightVectorStampNodes(matrixNodeIndices))
+		return;
+	++numSparse;
+
+	auto rows = std::is_same<VarType, Complex>::value
+		? CPS::Math::complexVectorElementRows(matrixNodeIndices, stamp.rows())
+		: CPS::Math::vectorElementRows(matrixNodeIndices);
+	Matrix outside = stamp;
+	for (auto row : rows) {
+		stamped = stamped || outside(row, 0) != 0;
+		outside(row, 0) = 0;
+	}
+	if (!outside.isZero(0)) {
+		std::cerr << comp->name() << " stamps outside of its nodes" << std::endl;
+		valid = false;
+	}
+}
+
+template <typename VarType>
+Bool checkStamps(const String& simName, SystemTopology& sys, Real finalTime) {
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(sys);
+	sim.setDomain(std::is_same<VarType, Complex>::value ? CPS::Domain::DP : CPS::Domain::EMT);
+	sim.setTimeStep(0.0001);
+	sim.setFinalTime(finalTime);
+
+	UInt numSparse = 0;
+	Bool stamped = false;
+	Bool valid = true;
+	sim.start();
+	while (sim.next() < finalTime) {
+		for (auto comp : sys.mComponents) {
+			if (auto powerComp = std::dynamic_pointer_cast<CPS::SimPowerComp<VarType>>(comp))
+				checkComponent<VarType>(powerComp, numSparse, stamped, valid);
+		}
+	}
+	sim.stop();
+
+	if (numSparse == 0 || !stamped) {
+		std::cerr << simName << ": no component with known stamp nodes" << std::endl;
+		valid = false;
+	}
+	return valid;
+}
+
+Bool checkDP() {
+	using namespace CPS::DP;
+
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+	auto n3 = SimNode::make("n3");
+
+	auto vs = Ph1::VoltageSource::make("vs");
+	vs->setParameters(CPS::Math::polar(100000, 0));
+	auto line = Ph1::PiLine::make("line");
+	line->setParameters(5, 0.16, 1e-6, 1e-6);
+	auto load = Ph1::RXLoad::make("load");
+	load->setParameters(1e6, 5e5, 100000);
+	auto ind = Ph1::Inductor::make("ind");
+	ind->setParameters(0.1);
+	auto cs = Ph1::CurrentSource::make("cs");
+	cs->setParameters(Complex(10, 0));
+	auto res = Ph1::Resistor::make("res");
+	res->setParameters(1000);
+
+	vs->connect({ SimNode::GND, n1 });
+	line->connect({ n1, n2 });
+	load->connect({ n2 });
+	ind->connect({ n2, n3 });
+	cs->connect({ SimNode::GND, n3 });
+	res->connect({ n3, SimNode::GND });
+
+	auto sys = SystemTopology(50,
+		SystemNodeList{n1, n2, n3},
+		SystemComponentList{vs, line, load, ind, cs, res});
+
+	return checkStamps<Complex>("DP_RightVectorStamps", sys, 0.05);
+}
+
+Bool checkEMT() {
+	using namespace CPS::EMT;
+
+	auto n1 = SimNode::make("n1", PhaseType::ABC);
+	auto n2 = SimNode::make("n2", PhaseType::ABC);
+
+	auto vs = Ph3::VoltageSource::make("vs");
+	vs->setParameters(CPS::Math::singlePhaseVariableToThreePhase(CPS::Math::polar(100000, 0)), 50);
+	auto line = Ph3::PiLine::make("line");
+	line->setParameters(CPS::Math::singlePhaseParameterToThreePhase(5), CPS::Math::singlePhaseParameterToThreePhase(0.16),
+		CPS::Math::singlePhaseParameterToThreePhase(1e-6), CPS::Math::singlePhaseParameterToThreePhase(1e-6));
+	auto load = Ph3::RXLoad::make("load");
+	load->setParameters(CPS::Math::singlePhasePowerToThreePhase(1e6), CPS::Math::singlePhasePowerToThreePhase(5e5), 100000);
+
+	vs->connect({ SimNode::GND, n1 });
+	line->connect({ n1, n2 });
+	load->connect({ n2 });
+
+	auto sys = SystemTopology(50,
+		SystemNodeList{n1, n2},
+		SystemComponentList{vs, line, load});
+
+	return checkStamps<Real>("EMT_RightVectorStamps", sys, 0.05);
+}
+
+int main(int argc, char* argv[]) {
+	Bool valid = checkDP();
+	valid = checkEMT() && valid;
+	return valid ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <atomic>
+#include <cstdlib>
+
+#include <DPsim.h>
+#include <dpsim/DenseLUAdapter.h>
+#ifdef WITH_KLU
+#include <dpsim/KLUAdapter.h>
+#endif
+
+using namespace DPsim;
+
+// Counts the heap allocations of the in-place solve of the direct linear solver adapters.
+// Allocations of Eigen go through malloc of the C library, which is replaced here. Only the
+// thread that solves counts, and only while it is inside the solve call under test.
+static thread_local bool countAllocations = false;
+static std::atomic<UInt> numAllocations(0);
+
+#ifdef __GLIBC__
+extern "C" {
+	void* __libc_malloc(std::size_t size);
+	void* __libc_calloc(std::size_t num, std::size_t size);
+	void* __libc_realloc(void* ptr, std::size_t size);
+
+	void* malloc(std::size_t size) {
+		if (countAllocations)
+			++numAllocations;
+		return __libc_malloc(size);
+	}
+
+	void* calloc(std::size_t num, std::size_t size) {
+		if (countAllocations)
+			++numAllocations;
+		return __libc_calloc(num, size);
+	}
+
+	void* realloc(void* ptr, std::size_t size) {
+		if (countAllocations)
+			++numAllocations;
+		return __libc_realloc(ptr, size);
+	}
+}
+#endif
+
+// System matrix of a ladder network of RL line sections with a load at each node. In the EMT domain
+// the matrix contains the conductances, in the DP domain it is the real representation [G -B; B G]
+// of the complex admittance matrix as stamped by the MNA solver.
+SparseMatrix ladderMatrix(UInt numNodes, CPS::Domain domain) {
+	const Complex line(1. / 0.5, -1. / 3.), load(1. / 100., 0);
+	Bool complex = domain == CPS::Domain::DP;
+	UInt size = complex ? 2 * numNodes : numNodes;
+
+	std::vector<Eigen::Triplet<Real>> entries;
+	auto stamp = [&](UInt row, UInt col, Complex value) {
+		entries.emplace_back(row, col, value.real());
+		if (complex) {
+			entries.emplace_back(row + numNodes, col + numNodes, value.real());
+			entries.emplace_back(row, col + numNodes, -value.imag());
+			entries.emplace_back(row + numNodes, col, value.imag());
+		}
+	};
+	for (UInt node = 0; node < numNodes; ++node) {
+		stamp(node, node, load + line + (node + 1 < numNodes ? line : Complex(0, 0)));
+		if (node + 1 < numNodes) {
+			stamp(node, node + 1, -line);
+			stamp(node + 1, node, -line);
+		}
+	}
+
+	SparseMatrix matrix(size, size);
+	matrix.setFromTriplets(entries.begin(), entries.end());
+	matrix.makeCompressed();
+	return matrix;
+}
+
+// Factorizes the matrix, solves once to size the solution vector and then counts the allocations
+// of further solves, which should not allocate with a preallocated solution vector.
+Bool checkAllocations(const String& name, DirectLinearSolver& solver, SparseMatrix matrix) {
+	std::vector<std::pair<UInt, UInt>> variableEntries;
+	solver.preprocessing(matrix, variableEntries);
+	solver.factorize(matrix);
+
+	Matrix rightSideVector = Matrix::Ones(matrix.rows(), 1);
+	Matrix leftSideVector;
+	solver.solve(rightSideVector, leftSideVector);
+
+	numAllocations = 0;
+	countAllocations = true;
+	for (int step = 0; step < 10; ++step)
+		solver.solve(rightSideVector, leftSideVector);
+	countAllocations = false;
+
+	Bool valid = true;
+	if (numAllocations != 0) {
+		std::cerr << name << ": " << numAllocations << " allocations in 10 solves" << std::endl;
+		valid = false;
+	}
+	Real residual = (matrix * leftSideVector - rightSideVector).norm();
+	if (residual > 1e-9 * rightSideVector.norm()) {
+		std::cerr << name << ": residual " << residual << " of the solution" << std::endl;
+		valid = false;
+	}
+	return valid;
+}
+
+// SparseLUAdapter is not checked, the supernodal triangular solve of Eigen::SparseLU
+// allocates its own work vector in every solve.
+Bool checkAdapters(const String& name, const SparseMatrix& matrix) {
+	DenseLUAdapter denseLU;
+	Bool valid = checkAllocations(name + " DenseLU", denseLU, matrix);
+#ifdef WITH_KLU
+	KLUAdapter klu;
+	valid = checkAllocations(name + " KLU", klu, matrix) && valid;
+#endif
+	return valid;
+}
+
+int main(int argc, char* argv[]) {
+#ifdef __GLIBC__
+	Bool valid = true;
+	// small systems and systems beyond the stack allocation limits of Eigen
+	for (UInt numNodes : { 2, 300 }) {
+		valid = checkAdapters("DP " + std::to_string(numNodes) + " nodes", ladderMatrix(numNodes, CPS::Domain::DP)) && valid;
+		valid = checkAdapters("EMT " + std::to_string(numNodes) + " nodes", ladderMatrix(numNodes, CPS::Domain::EMT)) && valid;
+	}
+	return valid ? 0 : 1;
+#else
+	std::cout << "Allocations can only be counted with glibc" << std::endl;
+	return 0;
+#endif
+}
@@ -0,0 +1,126 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+
+// Compares the frequency-parallel solution of an inverter feeding a resistive network,
+// whose system matrices are identical for all frequencies, with and without solving
+// the frequencies together as one multi-column system.
+
+const Real timeStep = 0.000001;
+const Real finalTime = 0.002;
+
+struct HarmonicRun {
+	/// Voltages of all nodes and frequencies after each step
+	std::vector<Complex> voltages;
+	/// Number of frequency groups with a solve task of their own
+	Int solveGroups = 0;
+};
+
+HarmonicRun simulate(const String& simName, Bool grouping, Bool inductive) {
+	Matrix frequencies(9,1);
+	frequencies << 50, 19850, 19950, 20050, 20150, 39750, 39950, 40050, 40250;
+
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+	auto n3 = SimNode::make("n3");
+
+	auto inv = Ph1::Inverter::make("inv");
+	inv->setParameters(
+		std::vector<CPS::Int>{2,2,2,2,4,4,4,4},
+		std::vector<CPS::Int>{-3,-1,1,3,-5,-1,1,5},
+		360, 0.87, 0);
+	auto r1 = Ph1::Resistor::make("r_1");
+	r1->setParameters(0.1);
+	auto r2 = Ph1::Resistor::make("r_2");
+	r2->setParameters(10);
+	auto load = Ph1::Resistor::make("load");
+	load->setParameters(20);
+
+	inv->connect({ n1 });
+	r1->connect({ n1, n2 });
+	r2->connect({ n2, SimNode::GND });
+	load->connect({ n3, SimNode::GND });
+
+	SystemComponentList components{ inv, r1, r2, load };
+	// an inductance makes the system matrices differ between the frequencies
+	if (inductive) {
+		auto l1 = Ph1::Inductor::make("l_1");
+		l1->setParameters(600e-6);
+		l1->connect({ n2, n3 });
+		components.push_back(l1);
+	} else {
+		auto r3 = Ph1::Resistor::make("r_3");
+		r3->setParameters(0.5);
+		r3->connect({ n2, n3 });
+		components.push_back(r3);
+	}
+
+	auto sys = SystemTopology(50, frequencies, SystemNodeList{ n1, n2, n3 }, components);
+
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(sys);
+	sim.setTimeStep(timeStep);
+	sim.setFinalTime(finalTime);
+	sim.doFrequencyParallelization(true);
+	sim.doHarmonicSolveGrouping(grouping);
+
+	HarmonicRun run;
+	sim.start();
+	run.solveGroups = std::dynamic_pointer_cast<CPS::Attribute<Int>>(
+		sim.getIdObjAttribute(sim.name(), "harmonic_solve_groups").getPtr())->get();
+	while (sim.next() < finalTime) {
+		for (auto node : { n1, n2, n3 }) {
+			const MatrixComp& voltage = **node->mVoltage;
+			run.voltages.insert(run.voltages.end(), voltage.data(), voltage.data() + voltage.size());
+		}
+	}
+	sim.stop();
+	return run;
+}
+
+Bool check(const String& name, const HarmonicRun& reference, const HarmonicRun& run, Int solveGroups) {
+	Bool valid = true;
+	if (run.solveGroups != solveGroups) {
+		std::cerr << name << ": " << run.solveGroups << " solve groups instead of " << solveGroups << std::endl;
+		valid = false;
+	}
+	if (run.voltages.size() != reference.voltages.size()) {
+		std::cerr << name << ": " << run.voltages.size() << " voltages instead of " << reference.voltages.size() << std::endl;
+		return false;
+	}
+
+	Real maxVoltage = 0, maxDeviation = 0;
+	for (std::size_t k = 0; k < reference.voltages.size(); ++k) {
+		maxVoltage = std::max(maxVoltage, std::abs(reference.voltages[k]));
+		maxDeviation = std::max(maxDeviation, std::abs(run.voltages[k] - reference.voltages[k]));
+	}
+	if (maxVoltage == 0 || maxDeviation > 1e-10 * maxVoltage) {
+		std::cerr << name << ": relative deviation " << maxDeviation / maxVoltage << " from the separate solves" << std::endl;
+		valid = false;
+	}
+	return valid;
+}
+
+int main(int argc, char* argv[]) {
+	// all nine frequencies of the resistive network are solved by one task
+	auto separate = simulate("DP_HarmonicSolveGroups_Separate", false, false);
+	auto grouped = simulate("DP_HarmonicSolveGroups_Grouped", true, false);
+	Bool valid = check("Separate frequencies", separate, separate, 9);
+	valid = check("Grouped frequencies", separate, grouped, 1) && valid;
+
+	// frequencies with different system matrices are not grouped
+	auto inductiveSeparate = simulate("DP_HarmonicSolveGroups_InductiveSeparate", false, true);
+	auto inductiveGrouped = simulate("DP_HarmonicSolveGroups_InductiveGrouped", true, true);
+	valid = check("Inductive network", inductiveSeparate, inductiveGrouped, 9) && valid;
+
+	return valid ? 0 : 1;
+}
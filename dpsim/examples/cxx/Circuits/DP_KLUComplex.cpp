@@ -0,0 +1,119 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+
+// Compares the solution of a DP circuit factored in complex arithmetic by the KLUComplex adapter
+// against the real-expanded factorization of the KLU adapter. A fault switch is simulated once with
+// precomputed switched system matrices and once as variable resistance, which refactorizes the system
+// matrix in every step of its transition.
+
+const Real timeStep = 0.0001;
+const Real finalTime = 0.1;
+
+std::vector<Complex> simulate(const String& simName, DirectLinearSolverImpl implementation, Bool recomputation) {
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+	auto n3 = SimNode::make("n3");
+	auto n4 = SimNode::make("n4");
+
+	auto vs = Ph1::VoltageSource::make("vs");
+	vs->setParameters(Complex(10000, 0));
+	auto r1 = Ph1::Resistor::make("r_1");
+	r1->setParameters(1);
+	auto l1 = Ph1::Inductor::make("l_1");
+	l1->setParameters(0.02);
+	auto c1 = Ph1::Capacitor::make("c_1");
+	c1->setParameters(10e-6);
+	auto r2 = Ph1::Resistor::make("r_2");
+	r2->setParameters(2);
+	auto load = Ph1::Resistor::make("load");
+	load->setParameters(100);
+
+	vs->connect({ SimNode::GND, n1 });
+	r1->connect({ n1, n2 });
+	l1->connect({ n2, n3 });
+	c1->connect({ n3, SimNode::GND });
+	r2->connect({ n3, n4 });
+	load->connect({ n4, SimNode::GND });
+
+	SystemComponentList components{ vs, r1, l1, c1, r2, load };
+	std::shared_ptr<CPS::Base::Ph1::Switch> fault;
+	if (recomputation) {
+		auto sw = Ph1::varResSwitch::make("fault");
+		sw->setParameters(1e9, 1);
+		sw->setInitParameters(timeStep);
+		sw->connect({ n4, SimNode::GND });
+		components.push_back(sw);
+		fault = sw;
+	} else {
+		auto sw = Ph1::Switch::make("fault");
+		sw->setParameters(1e9, 1);
+		sw->connect({ n4, SimNode::GND });
+		components.push_back(sw);
+		fault = sw;
+	}
+
+	auto sys = SystemTopology(50, SystemNodeList{ n1, n2, n3, n4 }, components);
+
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(sys);
+	sim.setDomain(CPS::Domain::DP);
+	sim.setTimeStep(timeStep);
+	sim.setFinalTime(finalTime);
+	sim.setDirectLinearSolverImplementation(implementation);
+	sim.doSystemMatrixRecomputation(recomputation);
+	sim.addEvent(SwitchEvent::make(0.03, fault, true));
+	sim.addEvent(SwitchEvent::make(0.06, fault, false));
+
+	std::vector<Complex> voltages;
+	sim.start();
+	while (sim.next() < finalTime) {
+		for (auto node : { n1, n2, n3, n4 })
+			voltages.push_back(node->singleVoltage());
+	}
+	sim.stop();
+	return voltages;
+}
+
+Bool compare(const String& name, const std::vector<Complex>& reference, const std::vector<Complex>& voltages) {
+	if (voltages.size() != reference.size()) {
+		std::cerr << name << ": " << voltages.size() << " voltages instead of " << reference.size() << std::endl;
+		return false;
+	}
+
+	Real maxVoltage = 0, maxDeviation = 0;
+	for (std::size_t k = 0; k < reference.size(); ++k) {
+		maxVoltage = std::max(maxVoltage, std::abs(reference[k]));
+		maxDeviation = std::max(maxDeviation, std::abs(voltages[k] - reference[k]));
+	}
+	if (maxDeviation > 1e-10 * maxVoltage) {
+		std::cerr << name << ": relative deviation " << maxDeviation / maxVoltage << " from the KLU adapter" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+#ifdef WITH_KLU
+	Bool valid = true;
+	for (Bool recomputation : { false, true }) {
+		String suffix = recomputation ? "_Recomputation" : "_Switched";
+		auto real = simulate("DP_KLUComplex_Real" + suffix, DirectLinearSolverImpl::KLU, recomputation);
+		auto complex = simulate("DP_KLUComplex_Complex" + suffix, DirectLinearSolverImpl::KLUComplex, recomputation);
+		valid = compare(recomputation ? "Recomputed system matrix" : "Switched system matrices", real, complex) && valid;
+	}
+	return valid ? 0 : 1;
+#else
+	std::cout << "The KLU adapters are not available" << std::endl;
+	return 0;
+#endif
+}
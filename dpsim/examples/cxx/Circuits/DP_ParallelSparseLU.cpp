@@ -0,0 +1,197 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+#include <dpsim/ParallelSparseLUAdapter.h>
+#include <dpsim/SparseLUAdapter.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+
+// Compares the ParallelSparseLU adapter against the SparseLU adapter (and KLU, if available).
+// A DP circuit with a fault switch is simulated once with precomputed switched system matrices,
+// which are factorized, and once with a switch of variable resistance, whose system matrix is
+// refactorized with the pivot sequence of the first factorization in every step of its transition.
+// The level-scheduled refactorization and substitutions are only run in parallel for large systems,
+// so they are checked directly on a ladder network with different numbers of threads.
+
+const Real timeStep = 0.0001;
+const Real finalTime = 0.1;
+
+std::vector<Complex> simulate(const String& simName, DirectLinearSolverImpl implementation, Bool recomputation) {
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+	auto n3 = SimNode::make("n3");
+	auto n4 = SimNode::make("n4");
+
+	auto vs = Ph1::VoltageSource::make("vs");
+	vs->setParameters(Complex(10000, 0));
+	auto r1 = Ph1::Resistor::make("r_1");
+	r1->setParameters(1);
+	auto l1 = Ph1::Inductor::make("l_1");
+	l1->setParameters(0.02);
+	auto c1 = Ph1::Capacitor::make("c_1");
+	c1->setParameters(10e-6);
+	auto r2 = Ph1::Resistor::make("r_2");
+	r2->setParameters(2);
+	auto load = Ph1::Resistor::make("load");
+	load->setParameters(100);
+
+	vs->connect({ SimNode::GND, n1 });
+	r1->connect({ n1, n2 });
+	l1->connect({ n2, n3 });
+	c1->connect({ n3, SimNode::GND });
+	r2->connect({ n3, n4 });
+	load->connect({ n4, SimNode::GND });
+
+	SystemComponentList components{ vs, r1, l1, c1, r2, load };
+	std::shared_ptr<CPS::Base::Ph1::Switch> fault;
+	if (recomputation) {
+		auto sw = Ph1::varResSwitch::make("fault");
+		sw->setParameters(1e9, 1);
+		sw->setInitParameters(timeStep);
+		sw->connect({ n4, SimNode::GND });
+		components.push_back(sw);
+		fault = sw;
+	} else {
+		auto sw = Ph1::Switch::make("fault");
+		sw->setParameters(1e9, 1);
+		sw->connect({ n4, SimNode::GND });
+		components.push_back(sw);
+		fault = sw;
+	}
+
+	auto sys = SystemTopology(50, SystemNodeList{ n1, n2, n3, n4 }, components);
+
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(sys);
+	sim.setDomain(CPS::Domain::DP);
+	sim.setTimeStep(timeStep);
+	sim.setFinalTime(finalTime);
+	sim.setDirectLinearSolverImplementation(implementation);
+	sim.doSystemMatrixRecomputation(recomputation);
+	sim.addEvent(SwitchEvent::make(0.03, fault, true));
+	sim.addEvent(SwitchEvent::make(0.06, fault, false));
+
+	std::vector<Complex> voltages;
+	sim.start();
+	while (sim.next() < finalTime) {
+		for (auto node : { n1, n2, n3, n4 })
+			voltages.push_back(node->singleVoltage());
+	}
+	sim.stop();
+	return voltages;
+}
+
+Bool compare(const String& name, const std::vector<Complex>& reference, const std::vector<Complex>& voltages) {
+	if (voltages.size() != reference.size()) {
+		std::cerr << name << ": " << voltages.size() << " voltages instead of " << reference.size() << std::endl;
+		return false;
+	}
+
+	Real maxVoltage = 0, maxDeviation = 0;
+	for (std::size_t k = 0; k < reference.size(); ++k) {
+		maxVoltage = std::max(maxVoltage, std::abs(reference[k]));
+		maxDeviation = std::max(maxDeviation, std::abs(voltages[k] - reference[k]));
+	}
+	if (maxVoltage == 0 || maxDeviation > 1e-10 * maxVoltage) {
+		std::cerr << name << ": relative deviation " << maxDeviation / maxVoltage << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Real representation [G -B; B G] of the admittance matrix of a ladder network of RL line sections
+// with a load at each node, as stamped by the MNA solver in the DP domain
+SparseMatrix ladderMatrix(UInt numNodes, Real loadConductance) {
+	const Complex line(1. / 0.5, -1. / 3.), load(loadConductance, 0);
+
+	std::vector<Eigen::Triplet<Real>> entries;
+	auto stamp = [&](UInt row, UInt col, Complex value) {
+		entries.emplace_back(row, col, value.real());
+		entries.emplace_back(row + numNodes, col + numNodes, value.real());
+		entries.emplace_back(row, col + numNodes, -value.imag());
+		entries.emplace_back(row + numNodes, col, value.imag());
+	};
+	for (UInt node = 0; node < numNodes; ++node) {
+		stamp(node, node, load + line + (node + 1 < numNodes ? line : Complex(0, 0)));
+		if (node + 1 < numNodes) {
+			stamp(node, node + 1, -line);
+			stamp(node + 1, node, -line);
+		}
+	}
+
+	SparseMatrix matrix(2 * numNodes, 2 * numNodes);
+	matrix.setFromTriplets(entries.begin(), entries.end());
+	matrix.makeCompressed();
+	return matrix;
+}
+
+Bool compareSolutions(const String& name, const Matrix& reference, const Matrix& solution) {
+	Real deviation = (solution - reference).norm();
+	if (solution.rows() != reference.rows() || deviation > 1e-10 * reference.norm()) {
+		std::cerr << name << ": relative deviation " << deviation / reference.norm() << " from SparseLU" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Factorizes a ladder network above the parallelization threshold of the adapter and refactorizes it
+// after its loads changed, comparing both solutions against SparseLU.
+Bool checkThreads(Int numThreads) {
+	const String name = "Ladder network with " + std::to_string(numThreads) + " threads";
+	const UInt numNodes = 600;
+	SparseMatrix matrix = ladderMatrix(numNodes, 1. / 100.);
+	Matrix rightSideVector = Matrix::Zero(matrix.rows(), 2);
+	rightSideVector(0, 0) = 1000;
+	rightSideVector(numNodes, 1) = 1000;
+	rightSideVector(numNodes - 1, 1) = 10;
+
+	ParallelSparseLUAdapter parallelLU;
+	parallelLU.setNumberOfThreads(numThreads);
+	SparseLUAdapter sparseLU;
+	std::vector<std::pair<UInt, UInt>> variableEntries;
+	parallelLU.preprocessing(matrix, variableEntries);
+	sparseLU.preprocessing(matrix, variableEntries);
+
+	parallelLU.factorize(matrix);
+	sparseLU.factorize(matrix);
+	Matrix solution, reference;
+	parallelLU.solve(rightSideVector, solution);
+	sparseLU.solve(rightSideVector, reference);
+	Bool valid = compareSolutions(name + ", factorization", reference, solution);
+
+	// the loads change by orders of magnitude while the pattern stays the same
+	matrix = ladderMatrix(numNodes, 1. / 0.1);
+	parallelLU.refactorize(matrix);
+	sparseLU.factorize(matrix);
+	parallelLU.solve(rightSideVector, solution);
+	sparseLU.solve(rightSideVector, reference);
+	valid = compareSolutions(name + ", refactorization", reference, solution) && valid;
+	return valid;
+}
+
+int main(int argc, char* argv[]) {
+	Bool valid = true;
+	for (Bool recomputation : { false, true }) {
+		String suffix = recomputation ? "_Recomputation" : "_Switched";
+		String name = recomputation ? "Refactorized system matrix" : "Switched system matrices";
+		auto parallel = simulate("DP_ParallelSparseLU_Parallel" + suffix, DirectLinearSolverImpl::ParallelSparseLU, recomputation);
+		auto sparse = simulate("DP_ParallelSparseLU_SparseLU" + suffix, DirectLinearSolverImpl::SparseLU, recomputation);
+		valid = compare(name + " against SparseLU", sparse, parallel) && valid;
+#ifdef WITH_KLU
+		auto klu = simulate("DP_ParallelSparseLU_KLU" + suffix, DirectLinearSolverImpl::KLU, recomputation);
+		valid = compare(name + " against KLU", klu, parallel) && valid;
+#endif
+	}
+
+	for (Int numThreads : { 1, 2, 4 })
+		valid = checkThreads(numThreads) && valid;
+
+	return valid ? 0 : 1;
+}
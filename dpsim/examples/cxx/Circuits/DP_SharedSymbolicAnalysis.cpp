@@ -0,0 +1,132 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+
+// Compares the solution of three decoupled, structurally identical subnets with and without
+// sharing the symbolic analysis of their system matrices between the subnet solvers.
+// The subnets have different parameters and only the first one is faulted.
+
+const Real timeStep = 0.0001;
+const Real finalTime = 0.05;
+const UInt numSubnets = 3;
+
+struct SharedRun {
+	/// Voltages of all nodes after each step
+	std::vector<Complex> voltages;
+	/// Registered and reused symbolic analyses of the pool, -1 without pool
+	Int numAnalyses = -1;
+	Int numShared = -1;
+};
+
+SharedRun simulate(const String& simName, Bool shared) {
+	SystemNodeList nodes;
+	SystemComponentList components;
+	std::shared_ptr<CPS::Base::Ph1::Switch> fault;
+
+	for (UInt net = 0; net < numSubnets; ++net) {
+		String suffix = "_" + std::to_string(net);
+		auto n1 = SimNode::make("n1" + suffix);
+		auto n2 = SimNode::make("n2" + suffix);
+		auto n3 = SimNode::make("n3" + suffix);
+
+		auto vs = Ph1::VoltageSource::make("vs" + suffix);
+		vs->setParameters(Complex(10000. * (net + 1), 0));
+		auto r1 = Ph1::Resistor::make("r_1" + suffix);
+		r1->setParameters(1. + net);
+		auto l1 = Ph1::Inductor::make("l_1" + suffix);
+		l1->setParameters(0.02);
+		auto load = Ph1::Resistor::make("load" + suffix);
+		load->setParameters(100. / (net + 1));
+		auto sw = Ph1::Switch::make("fault" + suffix);
+		sw->setParameters(1e9, 1);
+
+		vs->connect({ SimNode::GND, n1 });
+		r1->connect({ n1, n2 });
+		l1->connect({ n2, n3 });
+		load->connect({ n3, SimNode::GND });
+		sw->connect({ n3, SimNode::GND });
+
+		nodes.insert(nodes.end(), { n1, n2, n3 });
+		components.insert(components.end(), { vs, r1, l1, load, sw });
+		if (net == 0)
+			fault = sw;
+	}
+
+	auto sys = SystemTopology(50, nodes, components);
+
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(sys);
+	sim.setDomain(CPS::Domain::DP);
+	sim.setTimeStep(timeStep);
+	sim.setFinalTime(finalTime);
+	sim.setDirectLinearSolverImplementation(DirectLinearSolverImpl::KLU);
+	sim.doSplitSubnets(true);
+	sim.doSharedSymbolicAnalysis(shared);
+	sim.addEvent(SwitchEvent::make(0.02, fault, true));
+	sim.addEvent(SwitchEvent::make(0.04, fault, false));
+
+	SharedRun run;
+	sim.start();
+	if (auto pool = sim.symbolicAnalysisPool()) {
+		run.numAnalyses = static_cast<Int>(pool->size());
+		run.numShared = static_cast<Int>(pool->numShared());
+	}
+	while (sim.next() < finalTime) {
+		for (auto node : sys.mNodes)
+			run.voltages.push_back(std::dynamic_pointer_cast<CPS::SimNode<Complex>>(node)->singleVoltage());
+	}
+	sim.stop();
+	return run;
+}
+
+Bool compare(const String& name, const SharedRun& reference, const SharedRun& run) {
+	if (run.voltages.size() != reference.voltages.size()) {
+		std::cerr << name << ": " << run.voltages.size() << " voltages instead of " << reference.voltages.size() << std::endl;
+		return false;
+	}
+
+	Real maxVoltage = 0, maxDeviation = 0;
+	for (std::size_t k = 0; k < reference.voltages.size(); ++k) {
+		maxVoltage = std::max(maxVoltage, std::abs(reference.voltages[k]));
+		maxDeviation = std::max(maxDeviation, std::abs(run.voltages[k] - reference.voltages[k]));
+	}
+	if (maxVoltage == 0 || maxDeviation > 1e-12 * maxVoltage) {
+		std::cerr << name << ": relative deviation " << maxDeviation / maxVoltage << " from the separate analyses" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+#ifdef WITH_KLU
+	auto separate = simulate("DP_SharedSymbolicAnalysis_Separate", false);
+	auto shared = simulate("DP_SharedSymbolicAnalysis_Shared", true);
+
+	Bool valid = true;
+	if (separate.numAnalyses != -1 || separate.numShared != -1) {
+		std::cerr << "Separate analyses: symbolic analysis pool created without sharing" << std::endl;
+		valid = false;
+	}
+	// the first subnet registers the analysis of its initial switch state, the other subnets adopt it,
+	// the faulted switch state reuses the analysis within each subnet solver
+	if (shared.numAnalyses != 1 || shared.numShared != static_cast<Int>(numSubnets) - 1) {
+		std::cerr << "Shared analyses: " << shared.numAnalyses << " registered and " << shared.numShared
+			<< " reused analyses instead of 1 and " << numSubnets - 1 << std::endl;
+		valid = false;
+	}
+	valid = compare("Shared analyses", separate, shared) && valid;
+	return valid ? 0 : 1;
+#else
+	std::cout << "Symbolic analyses can only be shared by the KLU adapter" << std::endl;
+	return 0;
+#endif
+}
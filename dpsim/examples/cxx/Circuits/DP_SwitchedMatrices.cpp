@@ -0,0 +1,225 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <functional>
+
+#include <DPsim.h>
+
+using namespace DPsim;
+using namespace CPS::DP;
+
+// Compares the solutions of a circuit with three switches obtained with the switched system matrices
+// factorized on first use and kept in a bounded cache against the precomputed matrices of all switch states.
+// Low-rank updates of the initial factorization are compared within the accuracy of the update.
+// With switches of variable resistance, the system matrix re-assembled through stamp slots is compared
+// against a full restamp of the matrix after every switch and resistance change.
+
+const Real timeStep = 0.0001;
+const Real finalTime = 0.08;
+
+struct SwitchedRun {
+	/// Voltages of all nodes after each step
+	std::vector<Complex> voltages;
+	/// Solver statistics after the start and at the end of the simulation
+	Int factorizationsAtStart = 0;
+	Int factorizations = 0;
+	Int cachedMatrices = 0;
+	Int evictions = 0;
+	Int lowRankSolves = 0;
+	Int cachedLowRankUpdates = 0;
+	Int stampSlotFallbacks = 0;
+	/// Number of system matrix recomputations
+	UInt recomputations = 0;
+};
+
+Int solverStatistic(Simulation& sim, const String& name) {
+	return std::dynamic_pointer_cast<CPS::Attribute<Int>>(sim.getIdObjAttribute(sim.name(), name).getPtr())->get();
+}
+
+SwitchedRun simulate(const String& simName, const std::function<void(Simulation&)>& configure, Bool variableResistance = false) {
+	auto n1 = SimNode::make("n1");
+	auto n2 = SimNode::make("n2");
+	auto n3 = SimNode::make("n3");
+	auto n4 = SimNode::make("n4");
+	auto n5 = SimNode::make("n5");
+
+	auto vs = Ph1::VoltageSource::make("vs");
+	vs->setParameters(Complex(10000, 0));
+	auto r1 = Ph1::Resistor::make("r_1");
+	r1->setParameters(1);
+	auto l1 = Ph1::Inductor::make("l_1");
+	l1->setParameters(0.01);
+	auto r2 = Ph1::Resistor::make("r_2");
+	r2->setParameters(1);
+	auto l2 = Ph1::Inductor::make("l_2");
+	l2->setParameters(0.01);
+	auto load = Ph1::Resistor::make("load");
+	load->setParameters(100);
+
+	vs->connect({ SimNode::GND, n1 });
+	r1->connect({ n1, n2 });
+	l1->connect({ n2, n3 });
+	r2->connect({ n3, n4 });
+	l2->connect({ n4, n5 });
+	load->connect({ n5, SimNode::GND });
+
+	SystemComponentList components{vs, r1, l1, r2, l2, load};
+	std::vector<std::shared_ptr<CPS::Base::Ph1::Switch>> switches;
+	auto addSwitch = [&](auto sw, Real closedResistance, SimNode::Ptr node0, SimNode::Ptr node1) {
+		sw->setParameters(1e9, closedResistance);
+		sw->connect({ node0, node1 });
+		components.push_back(sw);
+		switches.push_back(sw);
+		return sw;
+	};
+
+	// a fault at the middle of the line, an additional load and a bypass of the second line section
+	if (variableResistance) {
+		// the resistance of an opened switch rises over several steps, each changing the system matrix
+		addSwitch(Ph1::varResSwitch::make("fault"), 5, n3, SimNode::GND)->setInitParameters(timeStep);
+		addSwitch(Ph1::varResSwitch::make("step"), 50, n5, SimNode::GND)->setInitParameters(timeStep);
+		addSwitch(Ph1::varResSwitch::make("bypass"), 0.1, n3, n5)->setInitParameters(timeStep);
+	} else {
+		addSwitch(Ph1::Switch::make("fault"), 5, n3, SimNode::GND);
+		addSwitch(Ph1::Switch::make("step"), 50, n5, SimNode::GND);
+		addSwitch(Ph1::Switch::make("bypass"), 0.1, n3, n5);
+	}
+
+	auto sys = SystemTopology(50, SystemNodeList{n1, n2, n3, n4, n5}, components);
+
+	Simulation sim(simName, CPS::Logger::Level::off);
+	sim.setSystem(sys);
+	sim.setDomain(CPS::Domain::DP);
+	sim.setTimeStep(timeStep);
+	sim.setFinalTime(finalTime);
+
+	// each switch is closed once, the initial state is reached again in between
+	Real time = 0.01;
+	for (auto sw : switches) {
+		sim.addEvent(SwitchEvent::make(time, sw, true));
+		sim.addEvent(SwitchEvent::make(time + 0.01, sw, false));
+		time += 0.02;
+	}
+	configure(sim);
+
+	SwitchedRun run;
+	sim.start();
+	run.factorizationsAtStart = solverStatistic(sim, "factorizations");
+	while (sim.next() < finalTime) {
+		for (auto node : sys.mNodes)
+			run.voltages.push_back(std::dynamic_pointer_cast<CPS::SimNode<Complex>>(node)->singleVoltage());
+	}
+	sim.stop();
+
+	run.factorizations = solverStatistic(sim, "factorizations");
+	run.cachedMatrices = solverStatistic(sim, "cached_matrices");
+	run.evictions = solverStatistic(sim, "evictions");
+	run.lowRankSolves = solverStatistic(sim, "low_rank_solves");
+	run.cachedLowRankUpdates = solverStatistic(sim, "cached_low_rank_updates");
+	run.stampSlotFallbacks = solverStatistic(sim, "stamp_slot_fallbacks");
+	run.recomputations = static_cast<UInt>(sim.timingStatistics().at(sim.name() + ".recomputation").get().count());
+	return run;
+}
+
+Bool compare(const String& name, const SwitchedRun& reference, const SwitchedRun& run, Real tolerance) {
+	if (run.voltages.size() != reference.voltages.size()) {
+		std::cerr << name << ": " << run.voltages.size() << " voltages instead of " << reference.voltages.size() << std::endl;
+		return false;
+	}
+
+	Real maxVoltage = 0, maxDeviation = 0;
+	for (std::size_t k = 0; k < reference.voltages.size(); ++k) {
+		maxVoltage = std::max(maxVoltage, std::abs(reference.voltages[k]));
+		maxDeviation = std::max(maxDeviation, std::abs(run.voltages[k] - reference.voltages[k]));
+	}
+	if (maxDeviation > tolerance * maxVoltage) {
+		std::cerr << name << ": relative deviation " << maxDeviation / maxVoltage << " from the reference" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+Bool checkStatistics(const String& name, const SwitchedRun& run, Int factorizationsAtStart, Int factorizations, Int cachedMatrices, Int evictions) {
+	if (run.factorizationsAtStart != factorizationsAtStart || run.factorizations != factorizations
+		|| run.cachedMatrices != cachedMatrices || run.evictions != evictions) {
+		std::cerr << name << ": " << run.factorizationsAtStart << " factorizations at the start, "
+			<< run.factorizations << " in total, " << run.cachedMatrices << " cached and " << run.evictions
+			<< " evicted matrices instead of " << factorizationsAtStart << ", " << factorizations << ", "
+			<< cachedMatrices << " and " << evictions << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	// the switch states 000, 001, 000, 010, 000, 100 and 000 are reached in this order
+	auto eager = simulate("DP_SwitchedMatrices_Eager", [](Simulation& sim) { });
+	Bool valid = checkStatistics("Precomputed matrices", eager, 8, 8, 0, 0);
+
+	// the scheduled switch states are factorized when the simulation starts
+	auto lazy = simulate("DP_SwitchedMatrices_Lazy", [](Simulation& sim) {
+		sim.doLazySwitchedMatrices(true);
+	});
+	valid = compare("Lazy matrices", eager, lazy, 1e-10) && valid;
+	valid = checkStatistics("Lazy matrices", lazy, 4, 4, 4, 0) && valid;
+
+	// two matrices fit into the cache: prewarming stops after the first change and each new state
+	// evicts the least recently used one, which is never the initial state reached in between
+	auto limited = simulate("DP_SwitchedMatrices_Limited", [](Simulation& sim) {
+		sim.doLazySwitchedMatrices(true);
+		sim.setSwitchedMatrixCacheLimits(2);
+	});
+	valid = compare("Cache limited to two matrices", eager, limited, 1e-10) && valid;
+	valid = checkStatistics("Cache limited to two matrices", limited, 2, 4, 2, 2) && valid;
+
+	// the memory budget only leaves room for the matrix in use, every change refactorizes
+	auto memory = simulate("DP_SwitchedMatrices_Memory", [](Simulation& sim) {
+		sim.doLazySwitchedMatrices(true);
+		sim.setSwitchedMatrixCacheLimits(0, 1);
+	});
+	valid = compare("Cache limited by memory", eager, memory, 1e-10) && valid;
+	valid = checkStatistics("Cache limited by memory", memory, 1, 7, 1, 6) && valid;
+
+	// only the initial state is factorized, the other states are solved as updates of it,
+	// of which only the one in use is kept
+	auto lowRank = simulate("DP_SwitchedMatrices_LowRank", [](Simulation& sim) {
+		sim.doLowRankSwitchUpdates(true);
+		sim.setSwitchedMatrixCacheLimits(1);
+	});
+	valid = compare("Low-rank updates", eager, lowRank, 1e-8) && valid;
+	valid = checkStatistics("Low-rank updates", lowRank, 1, 1, 1, 0) && valid;
+	if (lowRank.lowRankSolves == 0 || lowRank.cachedLowRankUpdates != 1) {
+		std::cerr << "Low-rank updates: " << lowRank.lowRankSolves << " solves and " << lowRank.cachedLowRankUpdates
+			<< " cached updates instead of at least one solve and one cached update" << std::endl;
+		valid = false;
+	}
+
+	// the system matrix is restamped completely after each switch and resistance change
+	auto restamped = simulate("DP_SwitchedMatrices_Restamped", [](Simulation& sim) {
+		sim.doSystemMatrixRecomputation(true);
+	}, true);
+	if (restamped.recomputations == 0) {
+		std::cerr << "Restamped matrices: no recomputation of the system matrix" << std::endl;
+		valid = false;
+	}
+
+	// the same matrices are re-assembled from the base matrix and the stamp slots of the switches,
+	// they only differ from the full restamp by the order of the summation
+	auto slots = simulate("DP_SwitchedMatrices_StampSlots", [](Simulation& sim) {
+		sim.doSystemMatrixRecomputation(true);
+		sim.doStampSlotReassembly(true);
+	}, true);
+	valid = compare("Stamp slots", restamped, slots, 1e-12) && valid;
+	if (slots.recomputations != restamped.recomputations || slots.stampSlotFallbacks != 0) {
+		std::cerr << "Stamp slots: " << slots.recomputations << " recomputations and " << slots.stampSlotFallbacks
+			<< " fallbacks to a full restamp instead of " << restamped.recomputations << " and 0" << std::endl;
+		valid = false;
+	}
+
+	return valid ? 0 : 1;
+}
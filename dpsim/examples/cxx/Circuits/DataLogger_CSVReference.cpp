@@ -0,0 +1,89 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <fstream>
+#include <sstream>
+
+#include <DPsim.h>
+
+using namespace DPsim;
+
+// Compares the CSV file of the data logger byte by byte against a reference written by the
+// previous implementation, which logged derived attributes for each matrix coefficient and each
+// real and imaginary part. The reference covers the column names of scalars, 1x1, Nx1 and 1xN
+// matrices, complex values, coefficients named by a list and attributes converted to strings.
+
+const String reference =
+	"          time,             a,          c.im,          c.re,            m1,       m1n_0_0,       m1n_0_1,"
+	"        mc1.im,        mc1.re,       mc_0.im,       mc_0.re,       mc_1.im,       mc_1.re,          mn_0,"
+	"          mn_1,          mn_2,             n,            v1,            v2\n"
+	"  0.000000e+00,      1.500000,     -0.250000,      2.000000,      3.000000,      4.000000,      5.000000,"
+	"      0.001000,     -7.000000,     -1.000000,      1.000000,      2.000000,      0.500000,      1.000000,"
+	"      2.000000,      3.000000,             7,     10.000000,    -20.000000\n"
+	"  1.000000e-04,      2.500000,     -0.250000,      4.000000,      2.000000,      4.125000,      5.125000,"
+	"      0.002000,     -7.000000,     -1.000000,      2.000000,      2.000000,      1.000000,      2.000000,"
+	"      4.000000,      6.000000,             8,     11.000000,    -20.000000\n";
+
+int main(int argc, char* argv[]) {
+	auto scalar = CPS::AttributeStatic<Real>::make(0);
+	auto complex = CPS::AttributeStatic<Complex>::make();
+	auto single = CPS::AttributeStatic<Matrix>::make(Matrix::Zero(1, 1));
+	auto column = CPS::AttributeStatic<Matrix>::make(Matrix::Zero(3, 1));
+	auto row = CPS::AttributeStatic<Matrix>::make(Matrix::Zero(1, 2));
+	auto complexColumn = CPS::AttributeStatic<MatrixComp>::make(MatrixComp::Zero(2, 1));
+	auto complexSingle = CPS::AttributeStatic<MatrixComp>::make(MatrixComp::Zero(1, 1));
+	auto named = CPS::AttributeStatic<Matrix>::make(Matrix::Zero(2, 1));
+	auto counter = CPS::AttributeStatic<Int>::make(0);
+
+	String name = "DataLogger_CSVReference";
+	String logDir = CPS::Logger::logDir();
+	fs::path directory = fs::temp_directory_path() / name;
+	CPS::Logger::setLogDir(directory.string());
+	auto logger = DataLogger::make(name);
+	logger->logAttribute("a", scalar);
+	logger->logAttribute("c", complex);
+	logger->logAttribute("m1", single);
+	logger->logAttribute("mn", column);
+	logger->logAttribute("m1n", row);
+	logger->logAttribute("mc", complexColumn);
+	logger->logAttribute("mc1", complexSingle);
+	logger->logAttribute(std::vector<String>{ "v1", "v2" }, named);
+	logger->logAttribute("n", counter);
+
+	for (Int step = 0; step < 2; ++step) {
+		**scalar = 1.5 + step;
+		**complex = Complex(2. * (step + 1), -0.25);
+		(**single)(0, 0) = 3. - step;
+		**column = Matrix::Constant(3, 1, step + 1.);
+		(**column)(1, 0) *= 2;
+		(**column)(2, 0) *= 3;
+		(**row)(0, 0) = 4 + 0.125 * step;
+		(**row)(0, 1) = 5 + 0.125 * step;
+		(**complexColumn)(0, 0) = Complex(step + 1., -1);
+		(**complexColumn)(1, 0) = Complex(0.5 * (step + 1), 2);
+		(**complexSingle)(0, 0) = Complex(-7, 1e-3 * (step + 1));
+		(**named)(0, 0) = 10. + step;
+		(**named)(1, 0) = -20.;
+		**counter = 7 + step;
+		logger->log(step * 1e-4, step);
+	}
+	logger->close();
+	CPS::Logger::setLogDir(logDir);
+
+	std::ifstream csv(directory / (name + ".csv"), std::ios::binary);
+	std::stringstream contents;
+	contents << csv.rdbuf();
+	csv.close();
+	fs::remove_all(directory);
+
+	if (contents.str() != reference) {
+		std::cerr << "CSV file differs from the reference:" << std::endl << contents.str() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,110 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <cmath>
+
+#include <DPsim.h>
+#include <dpsim-models/DiscreteStateSpace.h>
+
+using namespace DPsim;
+
+// Compares the cached discretization of CPS::DiscreteStateSpace against Math::StateSpaceTrapezoidal,
+// which discretizes A and B again in every step. The input matrix changes during the integration like
+// the one of the power controller, the system matrix and the time step change once.
+
+const UInt numSteps = 200;
+
+template <int States, int Inputs>
+Bool checkStateSpace(const String& name, const Matrix& systemMatrix, const Matrix& inputMatrix) {
+	const Int numStates = static_cast<Int>(systemMatrix.rows());
+	const Int numInputs = static_cast<Int>(inputMatrix.cols());
+	typedef Eigen::Matrix<Real, States, 1> StateVector;
+	typedef Eigen::Matrix<Real, Inputs, 1> InputVector;
+
+	CPS::DiscreteStateSpace<States, Inputs> stateSpace;
+	Matrix A = systemMatrix, B = inputMatrix;
+	Real timeStep = 1e-4;
+	stateSpace.setSystemMatrix(A);
+	stateSpace.setInputMatrix(B);
+	stateSpace.setTimeStep(timeStep);
+
+	StateVector statePrev = StateVector::Zero(numStates), stateCurr = StateVector::Zero(numStates);
+	InputVector inputPrev = InputVector::Zero(numInputs), inputCurr = InputVector::Zero(numInputs);
+	Matrix reference = Matrix::Zero(numStates, 1);
+
+	Real maxState = 0, maxDeviation = 0;
+	for (UInt step = 0; step < numSteps; ++step) {
+		for (Int input = 0; input < numInputs; ++input)
+			inputCurr(input) = std::sin(0.1 * step + input) + 0.5 * input;
+
+		// the input matrix depends on the operating point, e.g. the measured voltage
+		if (step % 10 == 5) {
+			B *= 1.1;
+			B(0, 0) += 0.01 * step;
+			stateSpace.setInputMatrix(B);
+		}
+		if (step == numSteps / 2) {
+			A -= 0.5 * Matrix::Identity(numStates, numStates);
+			timeStep = 5e-5;
+			stateSpace.setSystemMatrix(A);
+			stateSpace.setTimeStep(timeStep);
+		}
+
+		stateSpace.step(statePrev, inputCurr, inputPrev, stateCurr);
+		reference = CPS::Math::StateSpaceTrapezoidal(reference, A, B, timeStep, Matrix(inputCurr), Matrix(inputPrev));
+
+		maxState = std::max(maxState, reference.cwiseAbs().maxCoeff());
+		maxDeviation = std::max(maxDeviation, (Matrix(stateCurr) - reference).cwiseAbs().maxCoeff());
+		statePrev = stateCurr;
+		inputPrev = inputCurr;
+	}
+
+	if (maxState == 0 || maxDeviation > 1e-12 * maxState) {
+		std::cerr << name << ": relative deviation " << maxDeviation / maxState << " from Math::StateSpaceTrapezoidal" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	// loop filter and integrator of the PLL
+	Matrix pllA(2, 2), pllB(2, 2);
+	pllA << 0, 0, 1, 0;
+	pllB << 20, 200, 0, 1;
+
+	// power controller with filters of the measured powers and PI controllers
+	Matrix controllerA = Matrix::Zero(6, 6), controllerB = Matrix::Zero(6, 6);
+	for (Int state = 0; state < 6; ++state) {
+		controllerA(state, state) = -1000. / (state + 1);
+		controllerB(state, state) = 1000. / (state + 1);
+		controllerB(state, (state + 1) % 6) = 0.5;
+	}
+	controllerA(2, 0) = -1;
+	controllerA(3, 1) = 1;
+	controllerA(4, 2) = 0.1;
+
+	Bool valid = checkStateSpace<2, 2>("PLL with fixed dimensions", pllA, pllB);
+	valid = checkStateSpace<Eigen::Dynamic, Eigen::Dynamic>("PLL with dynamic dimensions", pllA, pllB) && valid;
+	valid = checkStateSpace<6, 6>("Power controller with fixed dimensions", controllerA, controllerB) && valid;
+	valid = checkStateSpace<Eigen::Dynamic, Eigen::Dynamic>("Power controller with dynamic dimensions", controllerA, controllerB) && valid;
+
+	// the discretized matrices are the ones of Math::calculateStateSpaceTrapezoidalMatrices
+	CPS::DiscreteStateSpace<6, 6> stateSpace;
+	stateSpace.setSystemMatrix(controllerA);
+	stateSpace.setInputMatrix(controllerB);
+	stateSpace.setTimeStep(1e-4);
+	Matrix Ad, Bd, Cd;
+	CPS::Math::calculateStateSpaceTrapezoidalMatrices(controllerA, controllerB, Matrix::Zero(6, 1), 1e-4, Ad, Bd, Cd);
+	if ((Matrix(stateSpace.discreteSystemMatrix()) - Ad).norm() > 1e-14 * Ad.norm()
+		|| (Matrix(stateSpace.discreteInputMatrix()) - Bd).norm() > 1e-14 * Bd.norm()) {
+		std::cerr << "Discretized matrices differ from Math::calculateStateSpaceTrapezoidalMatrices" << std::endl;
+		valid = false;
+	}
+
+	return valid ? 0 : 1;
+}
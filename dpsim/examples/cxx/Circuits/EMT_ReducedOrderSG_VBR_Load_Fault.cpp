@@ -163,6 +163,7 @@ int main(int argc, char* argv[]) {
 	auto sw2 = SwitchEvent3Ph::make(endTimeFault, fault, false);
 	simEMT.addEvent(sw2);
 
+	simEMT.doTimingTrace();
 	simEMT.run();
 	simEMT.logStepTimes(simNameEMT + "_step_times");
 }
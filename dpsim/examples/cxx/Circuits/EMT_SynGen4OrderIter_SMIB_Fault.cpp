@@ -170,6 +170,7 @@ void EMT_3ph_4OrderSynGenIter(String simName, Real timeStep, Real finalTime, Rea
 	auto sw2 = SwitchEvent3Ph::make(endTimeFault, fault, false);
 	simEMT.addEvent(sw2);
 
+	simEMT.doTimingTrace();
 	simEMT.run();
 	simEMT.logStepTimes(simNameEMT + "_step_times");
 }
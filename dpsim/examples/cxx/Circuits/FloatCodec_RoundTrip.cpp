@@ -0,0 +1,125 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include <DPsim.h>
+#include <dpsim/CompressedResultReader.h>
+#include <dpsim/CompressedResultWriter.h>
+#include <dpsim/FloatCodec.h>
+
+using namespace DPsim;
+
+// Checks that the compressed result format restores every value bit-exactly,
+// including NaN, infinities, signed zeros and subnormal numbers.
+
+Bool sameBits(Real a, Real b) {
+	return std::memcmp(&a, &b, sizeof(Real)) == 0;
+}
+
+std::vector<Real> testValues() {
+	std::vector<Real> values = {
+		0., -0., 1., -1., std::numeric_limits<Real>::quiet_NaN(), -std::numeric_limits<Real>::quiet_NaN(),
+		std::numeric_limits<Real>::infinity(), -std::numeric_limits<Real>::infinity(),
+		std::numeric_limits<Real>::denorm_min(), -std::numeric_limits<Real>::denorm_min(),
+		std::numeric_limits<Real>::min(), std::numeric_limits<Real>::max(), std::numeric_limits<Real>::lowest(),
+		std::numeric_limits<Real>::epsilon()
+	};
+
+	// NaN with a payload, which arithmetic would not preserve
+	std::uint64_t payload = 0x7ff4000000000123;
+	Real signalingNaN;
+	std::memcpy(&signalingNaN, &payload, sizeof(Real));
+	values.push_back(signalingNaN);
+
+	// constant, linear and smooth sections, special values in between
+	for (int k = 0; k < 100; ++k)
+		values.push_back(42.);
+	for (int k = 0; k < 100; ++k)
+		values.push_back(1e-4 * k);
+	values.push_back(std::numeric_limits<Real>::quiet_NaN());
+	for (int k = 0; k < 1000; ++k)
+		values.push_back(325. * std::sin(2 * M_PI * 50 * 1e-4 * k));
+	values.push_back(std::numeric_limits<Real>::infinity());
+	values.push_back(std::numeric_limits<Real>::infinity());
+	values.push_back(-std::numeric_limits<Real>::infinity());
+
+	std::mt19937_64 generator(42);
+	for (int k = 0; k < 1000; ++k) {
+		std::uint64_t bits = generator();
+		Real value;
+		std::memcpy(&value, &bits, sizeof(Real));
+		values.push_back(value);
+	}
+	return values;
+}
+
+Bool checkCodec(const std::vector<Real>& values) {
+	Bool valid = true;
+	for (auto predictor : { FloatCodec::Predictor::PREVIOUS, FloatCodec::Predictor::LINEAR }) {
+		std::vector<std::uint8_t> stream;
+		FloatCodec::encode(values.data(), static_cast<UInt>(values.size()), predictor, stream);
+
+		std::vector<Real> decoded(values.size());
+		FloatCodec::decode(stream.data(), stream.size(), static_cast<UInt>(values.size()), predictor, decoded.data());
+		for (std::size_t k = 0; k < values.size(); ++k) {
+			if (!sameBits(decoded[k], values[k])) {
+				std::cerr << "Predictor " << static_cast<int>(predictor) << ": value " << k << " decoded as "
+					<< decoded[k] << " instead of " << values[k] << std::endl;
+				valid = false;
+				break;
+			}
+		}
+	}
+	return valid;
+}
+
+Bool checkFile(const std::vector<Real>& values) {
+	fs::path filename = CPS::Logger::logDir() + "/FloatCodec_RoundTrip.dpz";
+	if (!fs::exists(filename.parent_path()))
+		fs::create_directory(filename.parent_path());
+
+	// several chunks, the last one partially filled
+	std::vector<Real> times(values.size());
+	{
+		CompressedResultWriter writer(filename, 256, 2);
+		writer.open({ "value", "reversed" }, { "V", "" });
+		for (std::size_t k = 0; k < values.size(); ++k) {
+			times[k] = 1e-4 * k;
+			Real row[2] = { values[k], values[values.size() - 1 - k] };
+			writer.write(times[k], row);
+		}
+		writer.close();
+	}
+
+	CompressedResultReader reader(filename);
+	auto time = reader.time();
+	auto value = reader.column("value");
+	auto reversed = reader.column("reversed");
+	if (reader.rows() != values.size() || reader.units()[0] != "V") {
+		std::cerr << "Compressed file has " << reader.rows() << " rows instead of " << values.size() << std::endl;
+		return false;
+	}
+	for (std::size_t k = 0; k < values.size(); ++k) {
+		if (!sameBits(time[k], times[k]) || !sameBits(value[k], values[k]) || !sameBits(reversed[k], values[values.size() - 1 - k])) {
+			std::cerr << "Row " << k << " of the compressed file differs" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	auto values = testValues();
+	Bool valid = checkCodec(values);
+	valid = checkFile(values) && valid;
+	return valid ? 0 : 1;
+}
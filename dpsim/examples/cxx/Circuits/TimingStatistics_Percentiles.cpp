@@ -0,0 +1,75 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <cmath>
+
+#include <DPsim.h>
+
+using namespace DPsim;
+
+// Checks the streaming timing statistics against known durations.
+
+Bool checkValue(const String& name, Real value, Real expected, Real tolerance) {
+	if (std::abs(value - expected) > tolerance * std::abs(expected)) {
+		std::cerr << name << ": " << value << " instead of " << expected << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	Bool valid = true;
+
+	TimingStatistics empty;
+	valid = checkValue("Empty count", static_cast<Real>(empty.count()), 0, 0) && valid;
+	valid = checkValue("Empty percentile", empty.percentile(50), 0, 0) && valid;
+
+	// 1 to 1000 microseconds in shuffled order
+	TimingStatistics micro;
+	for (UInt k = 0; k < 1000; ++k)
+		micro.update(static_cast<Real>((k * 337) % 1000 + 1) * 1e-6);
+
+	valid = checkValue("Count", static_cast<Real>(micro.count()), 1000, 0) && valid;
+	valid = checkValue("Sum", micro.sum(), 500500e-6, 1e-12) && valid;
+	valid = checkValue("Mean", micro.mean(), 500.5e-6, 1e-12) && valid;
+	valid = checkValue("Minimum", micro.min(), 1e-6, 0) && valid;
+	valid = checkValue("Maximum", micro.max(), 1000e-6, 0) && valid;
+	valid = checkValue("Variance", micro.variance(), 1000. * 1001. / 12. * 1e-12, 1e-9) && valid;
+	valid = checkValue("Standard deviation", micro.stddev(), std::sqrt(1000. * 1001. / 12.) * 1e-6, 1e-9) && valid;
+
+	// the histogram estimates percentiles within 1/32 of the exact value
+	for (Real percent : { 1., 10., 25., 50., 75., 90., 99., 99.9 })
+		valid = checkValue("Percentile " + std::to_string(percent), micro.percentile(percent),
+			std::ceil(percent * 10.) * 1e-6, 1. / 32.) && valid;
+	valid = checkValue("Percentile 0", micro.percentile(0), 1e-6, 1. / 32.) && valid;
+	valid = checkValue("Percentile 100", micro.percentile(100), 1000e-6, 0) && valid;
+
+	// durations below 32 nanoseconds have their own buckets
+	TimingStatistics nano;
+	for (UInt k = 1; k <= 20; ++k)
+		nano.update(static_cast<Real>(k) * 1e-9);
+	valid = checkValue("Nanosecond percentile 50", nano.percentile(50), 10e-9, 1e-12) && valid;
+	valid = checkValue("Nanosecond percentile 95", nano.percentile(95), 19e-9, 1e-12) && valid;
+
+	// durations beyond the histogram range are clamped to the maximum
+	TimingStatistics slow;
+	slow.update(1e-3);
+	slow.update(3600);
+	valid = checkValue("Long duration maximum", slow.max(), 3600, 0) && valid;
+	valid = checkValue("Long duration percentile 50", slow.percentile(50), 1e-3, 1. / 32.) && valid;
+	valid = checkValue("Long duration percentile 100", slow.percentile(100), 3600, 0) && valid;
+
+	// reset discards all samples
+	micro.reset();
+	valid = checkValue("Reset count", static_cast<Real>(micro.count()), 0, 0) && valid;
+	valid = checkValue("Reset maximum", micro.max(), 0, 0) && valid;
+	micro.update(2e-6);
+	valid = checkValue("Percentile after reset", micro.percentile(50), 2e-6, 1. / 32.) && valid;
+
+	return valid ? 0 : 1;
+}
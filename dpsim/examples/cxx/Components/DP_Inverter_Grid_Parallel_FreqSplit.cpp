@@ -95,6 +95,7 @@ int main(int argc, char* argv[]) {
 		sim.setScheduler(scheduler);
 	}
 
+	sim.doTimingTrace();
 	sim.run();
 	sim.logStepTimes(simName + "_step_times");
 }
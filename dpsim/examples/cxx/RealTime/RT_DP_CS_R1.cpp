@@ -49,6 +49,7 @@ void RT_DP_CS_R1() {
 	sim.setTimeStep(timeStep);
 	sim.setFinalTime(finalTime);
 
+	sim.doTimingTrace();
 	sim.run();
 	sim.logStepTimes(simName + "_step_times");
 }
@@ -82,6 +83,7 @@ void Ref_DP_CS_R1() {
 	sim.setTimeStep(timeStep);
 	sim.setFinalTime(finalTime);
 
+	sim.doTimingTrace();
 	sim.run();
 	sim.logStepTimes(simName + "_step_times");
 }
@@ -0,0 +1,60 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+
+#include <dpsim/ResultWriter.h>
+#include <dpsim-models/Filesystem.h>
+
+namespace DPsim {
+	/// Columnar binary result file that can be memory-mapped without parsing.
+	///
+	/// The file starts with a header whose size is a multiple of 64 bytes:
+	/// the magic "DPSIMBIN", uint32 version, uint32 bytes per value (8 or 4), uint32 number of columns,
+	/// uint32 rows per chunk, uint64 header size and uint64 chunk size in bytes, followed by the name
+	/// and the unit of each column as uint16 length and characters.
+	/// All chunks have the same size: uint64 number of valid rows, the time of each row as float64 and
+	/// then the values of one column after the other, padded to a multiple of 8 bytes. Numbers are stored
+	/// in little-endian byte order. Complete chunks are appended and flushed while the simulation runs, the last
+	/// chunk written on close may be partially filled.
+	class BinaryResultWriter : public ResultWriter {
+	public:
+		enum class Precision { FLOAT64, FLOAT32 };
+
+		static constexpr std::uint32_t VERSION = 1;
+
+		BinaryResultWriter(const fs::path& filename, Precision precision = Precision::FLOAT64, UInt chunkRows = 1024);
+		~BinaryResultWriter() override;
+
+		void open(const std::vector<String>& names, const std::vector<String>& units) override;
+		void write(Real time, const Real* values) override;
+		void close() override;
+
+	protected:
+		///
+		std::ofstream mFile;
+		///
+		fs::path mFilename;
+		///
+		Precision mPrecision;
+		/// Number of rows per chunk
+		UInt mChunkRows;
+		/// Number of value columns, without the time
+		UInt mNumColumns = 0;
+		/// Number of rows in the current chunk
+		UInt mRows = 0;
+		/// Current chunk in the layout of the file
+		std::vector<char> mChunk;
+
+		/// Append the current chunk to the file
+		void writeChunk();
+	};
+}
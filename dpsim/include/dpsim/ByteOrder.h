@@ -0,0 +1,27 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+namespace DPsim {
+	/// Convert a number between host and little-endian byte order, in which the result files are stored.
+	/// The conversion is its own inverse and does nothing on little-endian hosts.
+	template<typename T>
+	T littleEndian(T value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		unsigned char bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+		std::reverse(bytes, bytes + sizeof(T));
+		std::memcpy(&value, bytes, sizeof(T));
+#endif
+		return value;
+	}
+}
@@ -0,0 +1,35 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <fstream>
+
+#include <dpsim/ResultWriter.h>
+#include <dpsim-models/Filesystem.h>
+
+namespace DPsim {
+	/// Writes rows in the padded CSV layout of DataLogger.
+	/// Values are formatted like the string representation of real attributes.
+	class CSVResultWriter : public ResultWriter {
+	public:
+		CSVResultWriter(const fs::path& filename) : mFilename(filename) { }
+
+		void open(const std::vector<String>& names, const std::vector<String>& units) override;
+		void write(Real time, const Real* values) override;
+		void close() override;
+
+	protected:
+		///
+		std::ofstream mFile;
+		///
+		fs::path mFilename;
+		/// Number of value columns, without the time
+		UInt mNumColumns = 0;
+	};
+}
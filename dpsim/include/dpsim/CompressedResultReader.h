@@ -0,0 +1,64 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <dpsim/Definitions.h>
+#include <dpsim-models/Filesystem.h>
+
+namespace DPsim {
+	/// Reader of the files written by CompressedResultWriter.
+	///
+	/// The file is read at once, but only the chunk directory is parsed. Each column is decoded
+	/// on request from its streams in all chunks, so that single columns of large results are cheap.
+	class CompressedResultReader {
+	public:
+		CompressedResultReader(const fs::path& filename);
+
+		///
+		const std::vector<String>& names() const { return mNames; }
+		///
+		const std::vector<String>& units() const { return mUnits; }
+		/// Total number of rows
+		UInt rows() const { return mRows; }
+
+		/// Times of all rows
+		CPS::Vector time() const { return stream(0); }
+		/// Values of a column in all rows
+		CPS::Vector column(const String& name) const;
+
+	protected:
+		struct Stream {
+			std::size_t offset;
+			std::size_t size;
+			std::uint32_t predictor;
+		};
+		struct Chunk {
+			UInt rows;
+			/// Time first, then one stream per column
+			std::vector<Stream> streams;
+		};
+
+		///
+		std::vector<std::uint8_t> mData;
+		///
+		std::vector<String> mNames;
+		///
+		std::vector<String> mUnits;
+		///
+		std::vector<Chunk> mChunks;
+		///
+		UInt mRows = 0;
+
+		/// Decode a stream of all chunks
+		CPS::Vector stream(UInt index) const;
+	};
+}
@@ -0,0 +1,76 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#include <readerwriterqueue.h>
+
+#include <dpsim/ResultWriter.h>
+#include <dpsim-models/Filesystem.h>
+
+namespace DPsim {
+	/// Result file with losslessly compressed float64 values (see FloatCodec).
+	///
+	/// The file starts with a header: the magic "DPSIMCMP", uint32 version, uint32 number of columns,
+	/// uint32 rows per chunk, uint32 reserved and uint64 header size, followed by the name and the unit
+	/// of each column as uint16 length and characters.
+	/// Each chunk can be decoded on its own: uint64 size of the rest of the chunk in bytes, uint32 number
+	/// of rows and uint32 number of streams, then uint32 size in bytes and uint32 predictor of each stream
+	/// followed by the streams themselves. The first stream holds the time, the others one column each.
+	/// Numbers are stored in little-endian byte order, the streams are independent of the byte order.
+	///
+	/// Rows are collected in preallocated chunks on the calling thread. Full chunks are compressed and
+	/// written by a background thread, so that the simulation only waits if all chunks are in use.
+	class CompressedResultWriter : public ResultWriter {
+	public:
+		static constexpr std::uint32_t VERSION = 1;
+
+		CompressedResultWriter(const fs::path& filename, UInt chunkRows = 4096, UInt numChunks = 4);
+		~CompressedResultWriter() override;
+
+		void open(const std::vector<String>& names, const std::vector<String>& units) override;
+		void write(Real time, const Real* values) override;
+		void close() override;
+
+	protected:
+		///
+		std::ofstream mFile;
+		///
+		fs::path mFilename;
+		/// Number of rows per chunk
+		UInt mChunkRows;
+		/// Number of chunks that can be filled while others are compressed
+		UInt mNumChunks;
+		/// Number of value columns, without the time
+		UInt mNumColumns = 0;
+		/// Set between open and close, only accessed by the calling thread as the compression thread writes to mFile
+		Bool mOpen = false;
+
+		/// Time and values of all chunks, one column after the other
+		std::vector<Real> mChunks;
+		/// Number of rows in each chunk
+		std::vector<UInt> mChunkSizes;
+		/// Chunk that is currently filled, mNumChunks if none
+		UInt mChunk;
+		/// Indices of the chunks to be compressed and of the chunks free to be filled
+		std::unique_ptr<moodycamel::BlockingReaderWriterQueue<UInt>> mFilledChunks;
+		std::unique_ptr<moodycamel::BlockingReaderWriterQueue<UInt>> mFreeChunks;
+		/// Thread compressing and writing the filled chunks
+		std::thread mCompressionThread;
+
+		/// Compress the chunk and append it to the file
+		void writeChunk(UInt chunk, std::vector<std::uint8_t>& buffer);
+		/// Pass the current chunk to the compression thread
+		void submitChunk();
+	};
+}
@@ -8,12 +8,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <iostream>
 #include <fstream>
+#include <thread>
+
+#include <readerwriterqueue.h>
 
 #include <dpsim/Definitions.h>
 #include <dpsim/Scheduler.h>
+#include <dpsim/ResultWriter.h>
 #include <dpsim-models/Filesystem.h>
 #include <dpsim-models/PtrFactory.h>
 #include <dpsim-models/Attribute.h>
@@ -24,15 +30,181 @@ namespace DPsim {
 
 	class DataLogger : public SharedFactory<DataLogger> {
 
+	public:
+		/// Output format. CSV writes padded text, the binary formats write
+		/// columnar files with float64 or float32 values (see BinaryResultWriter)
+		/// and COMPRESSED writes losslessly compressed float64 values (see CompressedResultWriter).
+		/// RING_BUFFER keeps the latest rows in a memory-mapped file in /dev/shm, that other processes
+		/// can read while the simulation runs (see RingBufferResultWriter).
+		enum class Format { CSV, BINARY_FLOAT64, BINARY_FLOAT32, COMPRESSED, RING_BUFFER };
+		/// Behaviour of the asynchronous mode if the writer thread falls behind.
+		/// BLOCK waits for a free slot, DROP discards the row and COUNT discards
+		/// the row and reports the number of discarded rows on close.
+		enum class Overflow { BLOCK, DROP, COUNT };
+		/// Selection of the rows written for logged attributes. ALL writes every row,
+		/// ENVELOPE the minimum, maximum and mean of each column per window of rows,
+		/// TRIGGER the rows around the samples fulfilling a trigger condition and
+		/// DEADBAND the rows in which a column changed by more than its tolerance.
+		enum class Capture { ALL, ENVELOPE, TRIGGER, DEADBAND };
+		/// Trigger condition on the value of a column. ABOVE and BELOW compare the value
+		/// with the threshold, CHANGE compares the change since the previous row.
+		enum class Trigger { ABOVE, BELOW, CHANGE };
+
 	protected:
 		std::ofstream mLogFile;
 		String mName;
 		Bool mEnabled;
 		UInt mDownsampling;
 		fs::path mFilename;
+		Format mFormat;
+
+		/// Attribute whose values are logged in one or more columns
+		struct LoggedAttribute {
+			enum class Type { REAL, COMPLEX, MATRIX, MATRIX_COMP, INT, UINT, BOOL, OTHER };
+
+			CPS::AttributeBase::Ptr attribute;
+			Type type;
+		};
+		/// Position of a logged value in the data of its attribute
+		struct LoggedColumn {
+			/// Index of the attribute in mLoggedAttributes
+			UInt attribute;
+			/// Matrix coefficient, 0 for scalars
+			UInt row;
+			UInt col;
+			/// Real (0) or imaginary (1) part of a complex value
+			UInt part;
+		};
+		/// Values of an attribute in the current row, viewed as an array of reals
+		struct AttributeView {
+			const Real* data;
+			Eigen::Index rows;
+			Eigen::Index cols;
+			/// Number of reals per coefficient
+			UInt width;
+			/// Storage for values converted from integer types
+			Real converted;
+		};
+
+		/// Distinct attributes of all columns
+		std::vector<LoggedAttribute> mLoggedAttributes;
+		/// Index of each attribute in mLoggedAttributes
+		std::map<CPS::AttributeBase*, UInt> mAttributeIndex;
+		/// Columns by name, the order of the map is the order of the columns
+		std::map<String, LoggedColumn> mColumns;
+
+		/// Compiled logging plan: the columns in output order and one view per attribute.
+		/// Each row resolves every attribute once and copies the values of the columns.
+		std::vector<LoggedColumn> mPlan;
+		std::vector<AttributeView> mViews;
+		/// Flag whether the plan reflects the current columns
+		Bool mPlanValid = false;
 
-		std::map<String, CPS::AttributeBase::Ptr> mAttributes;
+		/// Add a column reading the given value of an attribute
+		void addColumn(const String& name, CPS::AttributeBase::Ptr attr, UInt row = 0, UInt col = 0, UInt part = 0);
+		/// Build the logging plan from the columns
+		void compilePlan();
+		/// Names of the columns in output order
+		std::vector<String> columnNames() const;
+		/// Copy the current value of the first size columns into the row
+		void gatherRow(Real* row, UInt size);
 
+		/// Units of the logged columns, by column name
+		std::map<String, String> mUnits;
+
+		/// Writer of the binary and compressed formats
+		ResultWriter::Ptr mWriter;
+		/// Flag whether the columns have been passed to the writer
+		Bool mWriterOpen = false;
+		/// Number of columns passed to the writer
+		UInt mWriterColumns = 0;
+		/// Number of rows kept by the ring buffer format
+		UInt mRingBufferRows = 65536;
+		/// Values of the current row
+		std::vector<Real> mRow;
+
+		/// Flag whether rows are written by a background thread
+		Bool mAsync = false;
+		/// Number of rows buffered for the writer thread
+		UInt mAsyncCapacity = 1024;
+		///
+		Overflow mOverflow = Overflow::BLOCK;
+		/// Number of rows discarded because the buffer was full
+		std::atomic<std::uint64_t> mOverflows;
+		/// Time and values of each buffered row, preallocated for all slots
+		std::vector<Real> mSlots;
+		/// Indices of the slots filled by the simulation and of the slots free to be filled.
+		/// Each queue has a single producer and a single consumer.
+		std::unique_ptr<moodycamel::BlockingReaderWriterQueue<UInt>> mFilledSlots;
+		std::unique_ptr<moodycamel::BlockingReaderWriterQueue<UInt>> mFreeSlots;
+		///
+		std::thread mWriterThread;
+
+		/// Create the writer for the format of this logger
+		void createWriter();
+		/// Allocate the slots and start the writer thread
+		void startWriterThread();
+		/// Write all buffered rows and stop the writer thread
+		void stopWriterThread();
+		/// Pass a row to the writer thread, the current values of the columns if values is null
+		void enqueueRow(Real time, const Real* values = nullptr);
+		/// Pass a row to the writer or the writer thread
+		void writeRow(Real time, const Real* values);
+
+		///
+		Capture mCapture = Capture::ALL;
+		/// Number of rows per envelope
+		UInt mEnvelopeWindow = 1;
+		/// Column, condition and threshold of the trigger
+		String mTriggerColumn;
+		Trigger mTrigger = Trigger::ABOVE;
+		Real mTriggerThreshold = 0;
+		/// Number of rows written before and after each row fulfilling the trigger condition
+		UInt mPreTrigger = 0;
+		UInt mPostTrigger = 0;
+		/// Default tolerance and tolerances by column name of the deadband
+		Real mDeadband = 0;
+		std::map<String, Real> mDeadbands;
+
+		/// Output row of the envelope and last written row of the deadband
+		std::vector<Real> mCaptureRow;
+		/// Minimum, maximum and sum of each column in the current envelope
+		std::vector<Real> mEnvelope;
+		/// Number of rows in the current envelope, or of written rows of the deadband
+		UInt mCaptured = 0;
+		/// Time of the first row of the current envelope, or of the last skipped row of the deadband
+		Real mCaptureTime = 0;
+		/// Flag whether the last row of the deadband has been skipped
+		Bool mCapturePending = false;
+		/// Tolerance of each column of the deadband
+		std::vector<Real> mTolerances;
+		/// Index of the trigger column and its value in the previous row
+		UInt mTriggerIndex = 0;
+		Real mTriggerLast = 0;
+		/// Number of rows still to be written after the last trigger
+		UInt mPostRemaining = 0;
+		/// Ring buffer of the time and values of the rows before a trigger
+		std::vector<Real> mHistory;
+		UInt mHistoryStart = 0;
+		UInt mHistorySize = 0;
+
+		/// Column names of the writer for the capture mode
+		std::vector<String> captureNames() const;
+		/// Reset the state of the capture mode for the current columns
+		void startCapture();
+		/// Pass the current row to the capture mode
+		void captureRow(Real time);
+		/// Write the rows held back by the capture mode
+		void flushCapture();
+		/// Set the capture mode and reopen the file
+		void setCapture(Capture capture);
+		/// True if the column name is the prefix or starts with the prefix followed by '_' or '.'
+		static Bool matchesColumn(const String& prefix, const String& name);
+
+		/// True as long as no column names have been written
+		Bool headerPending();
+		/// Start the binary result with the given columns
+		void openWriter(const std::vector<String>& names);
 		void logDataLine(Real time, Real data);
 		void logDataLine(Real time, const Matrix& data);
 		void logDataLine(Real time, const MatrixComp& data);
@@ -42,7 +214,9 @@ namespace DPsim {
 		typedef std::vector<DataLogger::Ptr> List;
 
 		DataLogger(Bool enabled = true);
-		DataLogger(String name, Bool enabled = true, UInt downsampling = 1);
+		DataLogger(String name, Bool enabled = true, UInt downsampling = 1, Format format = Format::CSV);
+		///
+		~DataLogger();
 
 		void open();
 		void close();
@@ -55,6 +229,34 @@ namespace DPsim {
 		void logEMTNodeValues(Real time, const Matrix& data);
 
 		void setColumnNames(std::vector<String> names);
+		/// Set the unit of a column, or of all columns derived from a complex or matrix attribute of that name.
+		/// Units are stored in the header of the binary formats.
+		void setUnit(const String& name, const String& unit) { mUnits[name] = unit; }
+
+		/// Move formatting and file I/O of logged attributes to a background thread.
+		/// Each step only copies the values into one of capacity preallocated slots.
+		/// Node values logged with logEMTNodeValues and logPhasorNodeValues are still written directly.
+		void setAsync(Bool async = true, UInt capacity = 1024, Overflow overflow = Overflow::BLOCK);
+		/// Number of rows discarded in the asynchronous mode
+		std::uint64_t overflows() const { return mOverflows; }
+		/// Set the number of latest rows kept by the ring buffer format
+		void setRingBufferRows(UInt rows);
+
+		/// Write the minimum, maximum and mean of each logged attribute column over windows of
+		/// the given number of rows, as columns with the suffixes .min, .max and .mean.
+		/// The time of each row is the time of the first row of its window.
+		void setEnvelope(UInt window);
+		/// Only write rows in which the condition on the given column is fulfilled, together with
+		/// preTrigger rows before and postTrigger rows after. For example, a switch event is captured
+		/// by logging the is_closed attribute of the switch with the condition CHANGE and threshold 0.5.
+		void setTrigger(const String& column, Trigger condition, Real threshold, UInt preTrigger = 100, UInt postTrigger = 1000);
+		/// Only write rows in which a column changed by more than the tolerance since it was last written.
+		/// The last row is always written when the logger is closed.
+		void setDeadband(Real tolerance);
+		/// Set the deadband tolerance of a column, or of all columns derived from an attribute of that name
+		void setDeadband(const String& name, Real tolerance);
+		/// Write every row again
+		void resetCapture() { setCapture(Capture::ALL); }
 
 		void logAttribute(const String &name, CPS::AttributeBase::Ptr attr, UInt rowsMax = 0, UInt colsMax = 0);
 
@@ -69,8 +271,8 @@ namespace DPsim {
 		public:
 			Step(DataLogger& logger) :
 				Task(logger.mName + ".Write"), mLogger(logger) {
-				for (auto attr : logger.mAttributes) {
-					mAttributeDependencies.push_back(attr.second);
+				for (auto& attr : logger.mLoggedAttributes) {
+					mAttributeDependencies.push_back(attr.attribute);
 				}
 				mModifiedAttributes.push_back(Scheduler::external);
 			}
@@ -46,5 +46,11 @@ namespace DPsim
 
 		/// solution function for a right hand side
 		Matrix solve(Matrix& rightSideVector) override;
+
+		/// solution function for a right hand side writing into a preallocated solution vector
+		void solve(const Matrix& rightSideVector, Matrix& leftSideVector) override;
+
+		/// estimated memory footprint of the current factorization in bytes
+		std::size_t factorizationMemory() const override;
     };
 }
@@ -37,6 +37,8 @@ namespace DPsim {
 			UInt sysOff;
 			/// Factorization of the subnet's block
 			CPS::LUFactorized luFactorization;
+			/// Preallocated solution of the subnet's block for the tear currents
+			Matrix tearSolution;
 			/// List of all right side vector contributions
 			std::vector<const Matrix*> rightVectorStamps;
 			/// Left-side vector of the subnet AFTER complete step
@@ -51,6 +51,14 @@ namespace DPsim
 		/// preprocessing function pre-ordering and scaling the matrix
 		virtual void preprocessing(SparseMatrix& systemMatrix, std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries) = 0;
 
+		/// preprocessing function reusing the symbolic analysis of a reference solver that preprocessed
+		/// a matrix with identical sparsity pattern, returns false if the analysis cannot be shared
+		virtual Bool preprocessingShared(SparseMatrix& systemMatrix, const DirectLinearSolver& reference)
+		{
+			// adapters without a separate symbolic analysis always run their own preprocessing
+			return false;
+		}
+
 		/// factorization function with partial pivoting
 		virtual void factorize(SparseMatrix& systemMatrix) = 0;
 
@@ -63,6 +71,21 @@ namespace DPsim
 		/// solution function for a right hand side
 		virtual Matrix solve(Matrix& rightSideVector) = 0;
 
+		/// solution function for a right hand side writing into a preallocated solution vector
+		virtual void solve(const Matrix& rightSideVector, Matrix& leftSideVector)
+		{
+			// adapters without an in-place implementation fall back to the allocating variant
+			Matrix rhs = rightSideVector;
+			leftSideVector = solve(rhs);
+		}
+
+		/// estimated memory footprint of the current factorization in bytes
+		virtual std::size_t factorizationMemory() const
+		{
+			// adapters that cannot report their memory usage are treated as free
+			return 0;
+		}
+
 		virtual void setConfiguration(DirectLinearSolverConfiguration& configuration)
 		{
 			mConfiguration = configuration;
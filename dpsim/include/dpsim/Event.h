@@ -37,6 +37,9 @@ namespace DPsim {
 
 		virtual void execute() = 0;
 
+		///
+		CPS::Real time() const { return mTime; }
+
 		Event(CPS::Real t) :
 			mTime(t)
 		{ }
@@ -90,6 +93,11 @@ namespace DPsim {
 			else
 				mSwitch->open();
 		}
+
+		/// Attribute holding the state of the switch
+		CPS::Attribute<CPS::Bool>::Ptr switchState() const { return mSwitch->mIsClosed; }
+		///
+		CPS::Bool newState() const { return mNewState; }
 	};
 
 	class SwitchEvent3Ph : public Event, public SharedFactory<SwitchEvent3Ph> {
@@ -113,6 +121,11 @@ namespace DPsim {
 			else
 				mSwitch->openSwitch();
 		}
+
+		/// Attribute holding the state of the switch
+		CPS::Attribute<CPS::Bool>::Ptr switchState() const { return mSwitch->mSwitchClosed; }
+		///
+		CPS::Bool newState() const { return mNewState; }
 	};
 
 
@@ -126,6 +139,8 @@ namespace DPsim {
 		void addEvent(Event::Ptr e);
 		///
 		void handleEvents(CPS::Real currentTime);
+		/// Returns all pending events in the order of execution
+		std::vector<Event::Ptr> pendingEvents() const;
 	};
 }
 
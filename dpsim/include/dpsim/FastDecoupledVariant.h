@@ -0,0 +1,19 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+namespace DPsim {
+    /// Approximation of the branch resistances in the matrices of the fast-decoupled powerflow
+    enum class FastDecoupledVariant {
+        /// Resistances neglected in B' (Stott-Alsac)
+        XB,
+        /// Resistances neglected in B'' (van Amerongen)
+        BX
+    };
+}
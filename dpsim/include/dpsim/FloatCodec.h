@@ -0,0 +1,36 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <dpsim/Definitions.h>
+
+namespace DPsim {
+	/// Lossless compression of a series of float64 values in the style of Gorilla.
+	///
+	/// Each value is XORed with a prediction and the result is stored as a bit stream, most significant bit first:
+	/// '0' if the XOR is zero, '10' followed by the bits of the previous window of meaningful bits if the XOR fits
+	/// into it, or '11', 5 bits of leading zeros, 6 bits of length (0 for 64) and the meaningful bits otherwise.
+	/// The prediction of the first value is 0. The predictor PREVIOUS uses the previous value, LINEAR extrapolates
+	/// linearly from the two previous values as (x1 + x1) - x0, falling back to the previous value for the second
+	/// value and for predictions that are NaN. Smooth waveforms and equidistant times leave only a few meaningful
+	/// bits with the linear predictor, constant and piecewise constant signals only need one bit per value.
+	namespace FloatCodec {
+		enum class Predictor : std::uint32_t { PREVIOUS = 0, LINEAR = 1 };
+
+		/// Append the encoded values to the stream
+		void encode(const Real* values, UInt count, Predictor predictor, std::vector<std::uint8_t>& stream);
+		/// Append the values encoded with the predictor that gives the shorter stream and return that predictor
+		Predictor encodeBest(const Real* values, UInt count, std::vector<std::uint8_t>& stream);
+		/// Decode count values from a stream of the given size in bytes
+		void decode(const std::uint8_t* stream, std::size_t size, UInt count, Predictor predictor, Real* values);
+	}
+}
@@ -82,5 +82,7 @@ namespace DPsim
 
 		/// solution function for a right hand side
 		virtual Matrix solve(Matrix& rightSideVector) override;
+
+		using DirectLinearSolver::solve;
     };
 }
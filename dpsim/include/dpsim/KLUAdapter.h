@@ -41,6 +41,8 @@ namespace DPsim
 		klu_common mCommon;
 		klu_numeric* mNumeric = nullptr;
 		klu_symbolic* mSymbolic = nullptr;
+		/// Owner of the symbolic analysis, which may be shared with other adapters
+		std::shared_ptr<klu_symbolic> mSharedSymbolic;
 
 		/// Flags to indicate mode of operation
 		/// Define which ordering to choose in preprocessing
@@ -68,6 +70,9 @@ namespace DPsim
 		/// preprocessing function pre-ordering and scaling the matrix
 		void preprocessing(SparseMatrix& systemMatrix, std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries) override;
 
+		/// preprocessing function reusing the symbolic analysis of another KLU adapter
+		Bool preprocessingShared(SparseMatrix& systemMatrix, const DirectLinearSolver& reference) override;
+
 		/// factorization function with partial pivoting
 		void factorize(SparseMatrix& systemMatrix) override;
 
@@ -80,6 +85,12 @@ namespace DPsim
 		/// solution function for a right hand side
 		Matrix solve(Matrix& rightSideVector) override;
 
+		/// solution function for a right hand side writing into a preallocated solution vector
+		void solve(const Matrix& rightSideVector, Matrix& leftSideVector) override;
+
+		/// estimated memory footprint of the current factorization in bytes
+		std::size_t factorizationMemory() const override;
+
 		protected:
 
 		/// Function to print matrix in MatrixMarket's coo format
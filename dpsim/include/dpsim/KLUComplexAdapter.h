@@ -0,0 +1,126 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <dpsim/KLUAdapter.h>
+
+namespace DPsim
+{
+	/// KLU adapter factoring the phasor system matrix with complex arithmetic.
+	///
+	/// Components stamp complex values as 2x2 real blocks (see Math::addToMatrixElement),
+	/// so each frequency block of the system matrix is laid out as [Re -Im; Im Re].
+	/// The adapter collapses this layout into an N x N complex matrix with a quarter of
+	/// the nonzeros and factors it with the klu_z_* routines. If the matrix does not
+	/// have the complex block structure, the real-expanded matrix is factored instead.
+	///
+	/// The MNA solver still assembles and stamps the real-expanded 2N x 2N matrix. Its
+	/// complex values are gathered into the N x N matrix again on every factorization and
+	/// refactorization, and the right hand side and solution are converted between the
+	/// interleaved complex and the real-expanded layout on every solve. The complex pattern
+	/// and the value offsets are only extracted once during the preprocessing.
+	class KLUComplexAdapter : public DirectLinearSolver
+	{
+		/// Number of frequency blocks in the real-expanded system matrix
+		UInt mNumFreqBlocks = 1;
+		/// Size of one real-expanded frequency block
+		Int mBlockSize = 0;
+		/// Dimension of the complex matrix
+		Int mComplexSize = 0;
+		/// True if the complex factorization is in use
+		Bool mComplexMode = false;
+
+		/// Compressed row pattern of the complex matrix
+		std::vector<Int> mComplexOuter;
+		std::vector<Int> mComplexInner;
+		/// Interleaved real and imaginary values of the complex matrix
+		std::vector<Real> mComplexValues;
+		/// Positions in the real-expanded value array of the real and imaginary parts
+		/// of each complex entry and of their mirrored counterparts, -1 for structural zeros
+		std::vector<Eigen::Index> mRealPartOffsets;
+		std::vector<Eigen::Index> mImagPartOffsets;
+		std::vector<Eigen::Index> mRealMirrorOffsets;
+		std::vector<Eigen::Index> mImagMirrorOffsets;
+		/// Row of the real part in the real-expanded vectors for each complex unknown
+		std::vector<Eigen::Index> mRealRows;
+		/// Interleaved right hand side and solution
+		std::vector<Real> mComplexVector;
+
+		/// Vector of variable entries in system matrix
+		std::vector<std::pair<UInt, UInt>> mChangedEntries;
+
+		/// KLU-specific structs
+		klu_common mCommon;
+		klu_numeric* mNumeric = nullptr;
+		klu_symbolic* mSymbolic = nullptr;
+		/// Owner of the symbolic analysis, which may be shared with other adapters
+		std::shared_ptr<klu_symbolic> mSharedSymbolic;
+
+		/// Real-valued adapter used if the matrix has no complex block structure
+		std::shared_ptr<KLUAdapter> mRealAdapter;
+
+		/// Count Pivot faults
+		int mPivotFaults = 0;
+
+		/// Temporary value to store the number of nonzeros
+		Int nnz;
+
+	public:
+		/// Destructor
+		~KLUComplexAdapter() override;
+
+		/// Constructor
+		KLUComplexAdapter(UInt numFreqBlocks = 1);
+
+		/// Constructor with logging
+		KLUComplexAdapter(CPS::Logger::Log log, UInt numFreqBlocks = 1);
+
+		/// preprocessing function extracting the complex pattern and ordering the matrix
+		void preprocessing(SparseMatrix& systemMatrix, std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries) override;
+
+		/// preprocessing function reusing the symbolic analysis of another complex KLU adapter
+		Bool preprocessingShared(SparseMatrix& systemMatrix, const DirectLinearSolver& reference) override;
+
+		/// factorization function with partial pivoting
+		void factorize(SparseMatrix& systemMatrix) override;
+
+		/// refactorization without partial pivoting
+		void refactorize(SparseMatrix& systemMatrix) override;
+
+		/// partial refactorization, KLU offers no partial variant for complex matrices
+		void partialRefactorize(SparseMatrix& systemMatrix, std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries) override;
+
+		/// solution function for a right hand side
+		Matrix solve(Matrix& rightSideVector) override;
+
+		/// solution function for a right hand side writing into a preallocated solution vector
+		void solve(const Matrix& rightSideVector, Matrix& leftSideVector) override;
+
+		/// estimated memory footprint of the current factorization in bytes
+		std::size_t factorizationMemory() const override;
+
+		/// True if the matrix is factored in complex arithmetic
+		Bool isComplexMode() const { return mComplexMode; }
+
+	protected:
+		/// Apply configuration
+		void applyConfiguration() override;
+
+	private:
+		/// Build the complex pattern, returns false if the matrix has no complex block structure
+		Bool createComplexPattern(SparseMatrix& systemMatrix);
+		/// Gather the complex values, returns false if the values are not complex-consistent
+		Bool gatherComplexValues(const SparseMatrix& systemMatrix);
+		/// Switch to the real-expanded factorization of the fallback adapter
+		void useRealAdapter(SparseMatrix& systemMatrix);
+	};
+}
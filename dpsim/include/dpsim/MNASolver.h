@@ -84,6 +84,10 @@ namespace DPsim {
 		Matrix mRightSideVector;
 		/// List of all right side vector contributions
 		std::vector<const Matrix*> mRightVectorStamps;
+		/// Right side vector contributions without known stamp pattern, which are added completely
+		std::vector<const Matrix*> mDenseRightVectorStamps;
+		/// Right side vector contributions and the rows they are stamping into
+		std::vector<std::pair<const Matrix*, std::vector<UInt>>> mSparseRightVectorStamps;
 
 		// #### MNA specific attributes related to harmonics / additional frequencies ####
 		/// Source vector of known quantities
@@ -115,11 +119,11 @@ namespace DPsim {
 		std::shared_ptr<DataLogger> mRightVectorLog;
 
 		/// LU factorization measurements
-		std::vector<Real> mFactorizeTimes;
+		TimingStatistics& mFactorizeTimes = mTimingStatistics["factorize"];
 		/// Right-hand side solution measurements
-		std::vector<Real> mSolveTimes;
+		TimingStatistics& mSolveTimes = mTimingStatistics["solve"];
 		/// LU refactorization measurements
-		std::vector<Real> mRecomputationTimes;
+		TimingStatistics& mRecomputationTimes = mTimingStatistics["recomputation"];
 
 		/// Constructor should not be called by users but by Simulation
 		MnaSolver(String name,
@@ -148,6 +152,12 @@ namespace DPsim {
 
 		/// Create left and right side vector
 		void createEmptyVectors();
+		/// Registers the right side vector contribution of a component
+		void addRightVectorStamp(const CPS::MNAInterface::Ptr& comp, const Matrix& stamp);
+		/// Converts matrix node indices into rows of the right side vector
+		void rightVectorRows(const std::vector<UInt>& matrixNodeIndices, Matrix::Index numRows, std::vector<UInt>& rows) const;
+		/// Sums up the right side vector contributions of all components
+		void assembleRightSideVector();
 		/// Create system matrix
 		virtual void createEmptySystemMatrix() = 0;
 		/// Sets all entries in the matrix with the given switch index to zero
@@ -176,7 +186,8 @@ namespace DPsim {
 		virtual std::shared_ptr<CPS::Task> createSolveTask() = 0;
 		/// Create a solve task for this solver implementation
 		virtual std::shared_ptr<CPS::Task> createLogTask() = 0;
-		/// Create a solve task for this solver implementation
+		/// Create a solve task for this solver implementation, may return nullptr if the
+		/// frequency is solved by the task of another frequency
 		virtual std::shared_ptr<CPS::Task> createSolveTaskHarm(UInt freqIdx) = 0;
 
 		// #### Scheduler Task Methods ####
@@ -23,8 +23,10 @@
 #include <dpsim/DenseLUAdapter.h>
 #ifdef WITH_KLU
 #include <dpsim/KLUAdapter.h>
+#include <dpsim/KLUComplexAdapter.h>
 #endif
 #include <dpsim/SparseLUAdapter.h>
+#include <dpsim/ParallelSparseLUAdapter.h>
 #ifdef WITH_CUDA
 #include <dpsim/GpuDenseAdapter.h>
 #ifdef WITH_CUDA_SPARSE
@@ -52,12 +54,20 @@ namespace DPsim {
 		CUDADense,
 		CUDASparse,
 		CUDAMagma,
-		Plugin
+		Plugin,
+		KLUComplex,
+		ParallelSparseLU
 	};
 
 	/// Solver class using Modified Nodal Analysis (MNA).
+	///
+	/// Statistics of the switched system matrices are provided as attributes "factorizations",
+	/// "cached_matrices" and "evictions" of the solver, those of the low-rank switch updates as
+	/// "low_rank_solves" and "cached_low_rank_updates", the number of stamp slot re-assemblies
+	/// that fell back to a full restamp as "stamp_slot_fallbacks" and the number of frequency groups
+	/// with a solve task of their own as "harmonic_solve_groups", see Simulation::getIdObjAttribute.
 	template <typename VarType>
-	class MnaSolverDirect : public MnaSolver<VarType> {
+	class MnaSolverDirect : public MnaSolver<VarType>, public CPS::AttributeList {
 
 	protected:
 		// #### Data structures for precomputed switch matrices (optionally with parallel frequencies) ####
@@ -66,6 +76,76 @@ namespace DPsim {
 		/// Map of direct linear solvers related to the system matrices
 		std::unordered_map< std::bitset<SWITCH_NUM>, std::vector< std::shared_ptr< DirectLinearSolver> > > mDirectLinearSolvers;
 
+		/// Switch status and frequency index of the matrices that own a symbolic analysis
+		std::vector< std::pair<std::bitset<SWITCH_NUM>, Int> > mSymbolicReferences;
+		/// Number of factorizations that reuse the symbolic analysis of another matrix
+		UInt mNumSharedSymbolic = 0;
+		/// Frequency indices solved together by the task of the first frequency in the group.
+		/// Frequencies with identical system matrices for all switch states share one factorization.
+		std::vector< std::vector<UInt> > mHarmonicSolveGroups;
+		/// Number of frequency groups solved by a task of their own
+		const CPS::Attribute<Int>::Ptr mNumHarmonicSolveGroups;
+		/// Preallocated multi-column right and left side vectors of the frequency groups
+		std::vector<Matrix> mHarmonicGroupRightSide;
+		std::vector<Matrix> mHarmonicGroupLeftSide;
+
+		// #### Data structures for lazily factorized switch matrices ####
+		/// Bookkeeping of a cached switched system matrix
+		struct SwitchedMatrixCacheEntry {
+			/// Position in the usage list
+			std::list< std::bitset<SWITCH_NUM> >::iterator usage;
+			/// Estimated memory of system matrix and factorization in bytes
+			std::size_t memory;
+		};
+		/// Cached switch states ordered from most to least recently used
+		std::list< std::bitset<SWITCH_NUM> > mSwitchedMatrixUsage;
+		/// Cache entries of the lazily factorized system matrices
+		std::unordered_map< std::bitset<SWITCH_NUM>, SwitchedMatrixCacheEntry > mSwitchedMatrixCache;
+		/// Estimated memory of all cached system matrices and factorizations in bytes
+		std::size_t mSwitchedMatrixMemory = 0;
+		/// Number of factorized switched system matrices since the initialization
+		const CPS::Attribute<Int>::Ptr mNumSwitchedMatrixFactorizations;
+		/// Number of cached switched system matrices
+		const CPS::Attribute<Int>::Ptr mNumCachedSwitchedMatrices;
+		/// Number of system matrices evicted from the cache
+		const CPS::Attribute<Int>::Ptr mNumSwitchedMatrixEvictions;
+
+		// #### Data structures for low-rank switch updates ####
+		/// Woodbury correction of the base factorization for one switch status.
+		/// The switch stamps change the base matrix A by U C U^T, where U selects the
+		/// touched rows and columns, so that the solution becomes
+		/// x = x0 - Z (I + C U^T Z)^-1 C U^T x0 with x0 = A^-1 b and Z = A^-1 U.
+		struct LowRankSwitchUpdate {
+			/// Matrix rows and columns touched by the changed switches
+			std::vector<Eigen::Index> indices;
+			/// Change of the system matrix restricted to the touched rows and columns (C)
+			Matrix coupling;
+			/// Base solution for the unit vectors of the touched rows (Z)
+			Matrix correction;
+			/// Factorization of the capacitance matrix I + C U^T Z
+			Eigen::PartialPivLU<Matrix> capacitance;
+			/// Preallocated vectors of the size of the update rank
+			Matrix reduced;
+			Matrix coupled;
+			/// Position in the usage list
+			std::list< std::bitset<SWITCH_NUM> >::iterator usage;
+			/// Estimated memory of the update in bytes
+			std::size_t memory;
+		};
+		/// Switch status of the factorization the low-rank updates refer to
+		std::bitset<SWITCH_NUM> mLowRankBaseStatus;
+		/// Cached low-rank updates of the base factorization per switch status,
+		/// limited by the entry and memory limits of the switched matrix cache
+		std::unordered_map< std::bitset<SWITCH_NUM>, LowRankSwitchUpdate > mLowRankUpdateCache;
+		/// Switch states of the cached low-rank updates ordered from most to least recently used
+		std::list< std::bitset<SWITCH_NUM> > mLowRankUpdateUsage;
+		/// Estimated memory of all cached low-rank updates in bytes
+		std::size_t mLowRankUpdateMemory = 0;
+		/// Number of solves using a low-rank update
+		const CPS::Attribute<Int>::Ptr mNumLowRankSolves;
+		/// Number of cached low-rank updates
+		const CPS::Attribute<Int>::Ptr mNumCachedLowRankUpdates;
+
 		// #### Data structures for system recomputation over time ####
 		/// System matrix including all static elements
 		SparseMatrix mBaseSystemMatrix;
@@ -77,6 +157,28 @@ namespace DPsim {
 		DirectLinearSolverImpl mImplementationInUse;
 		/// LU factorization configuration
 		DirectLinearSolverConfiguration mConfigurationInUse;
+		/// Symbolic analyses shared with other solvers, if any
+		SymbolicAnalysisPool::Ptr mSymbolicAnalysisPool;
+
+		// #### Data structures for stamp slot re-assembly ####
+		/// Stamp of a switch or variable component and the offsets of its entries
+		/// in the compressed value array of the variable system matrix
+		struct StampSlots {
+			/// Matrix only holding the stamp of the component
+			SparseMatrix stamp;
+			/// Value array offset in the variable system matrix for each stamp entry
+			std::vector<Eigen::Index> offsets;
+		};
+		/// Stamp slots of the switches followed by those of the variable components
+		std::vector<StampSlots> mStampSlots;
+		/// Values of the base system matrix aligned to the pattern of the variable system matrix
+		std::vector<Real> mBaseSystemMatrixValues;
+		/// Number of re-assemblies that fell back to a full restamp
+		const CPS::Attribute<Int>::Ptr mNumStampSlotFallbacks;
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+		/// Number of solves that reallocated the solution vector
+		UInt mNumSolveAllocations = 0;
+#endif
 
 		using MnaSolver<VarType>::mSwitches;
 		using MnaSolver<VarType>::mMNAIntfSwitches;
@@ -93,8 +195,15 @@ namespace DPsim {
 		using MnaSolver<VarType>::mRightSideVectorHarm;
 		using MnaSolver<VarType>::mLeftSideVectorHarm;
 		using MnaSolver<VarType>::mFrequencyParallel;
+		using MnaSolver<VarType>::mHarmonicSolveGrouping;
 		using MnaSolver<VarType>::mSLog;
 		using MnaSolver<VarType>::mSystemMatrixRecomputation;
+		using MnaSolver<VarType>::mLazySwitchedMatrices;
+		using MnaSolver<VarType>::mLowRankSwitchUpdates;
+		using MnaSolver<VarType>::mMaxLowRankSwitchChanges;
+		using MnaSolver<VarType>::mSwitchedMatrixCacheSize;
+		using MnaSolver<VarType>::mSwitchedMatrixCacheMemory;
+		using MnaSolver<VarType>::mStampSlotReassembly;
 		using MnaSolver<VarType>::hasVariableComponentChanged;
 		using MnaSolver<VarType>::mNumRecomputations;
 		using MnaSolver<VarType>::mSyncGen;
@@ -106,6 +215,10 @@ namespace DPsim {
 		// #### General
 		/// Create system matrix
 		void createEmptySystemMatrix() override;
+		/// Initialization of system matrices and source vector
+		void initializeSystem() override;
+		/// Creates the system matrix and linear solver for the given switch state
+		void createSwitchedMatrix(const std::bitset<SWITCH_NUM>& status);
 
 		// #### Methods for precomputed switch matrices (optionally with parallel frequencies) ####
 		/// Sets all entries in the matrix with the given switch index to zero
@@ -114,6 +227,44 @@ namespace DPsim {
 		void switchedMatrixEmpty(std::size_t swIdx, Int freqIdx) override;
 		/// Applies a component stamp to the matrix with the given switch index
 		void switchedMatrixStamp(std::size_t index, std::vector<std::shared_ptr<CPS::MNAInterface>>& comp) override;
+		/// Applies component and switch stamps to the matrix with the given switch and frequency index
+		void switchedMatrixStamp(std::size_t swIdx, Int freqIdx, CPS::MNAInterface::List& components, CPS::MNASwitchInterface::List& switches) override;
+		/// Preprocesses the matrix, reusing the symbolic analysis of a previous matrix with the same pattern
+		void preprocessSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx);
+		/// Preprocesses the matrix, reusing the symbolic analysis of another solver's matrix with the same pattern
+		void preprocessSystemMatrix(SparseMatrix& systemMatrix, const std::shared_ptr<DirectLinearSolver>& solver);
+		/// Checks whether both compressed matrices have the same sparsity pattern
+		static Bool hasSamePattern(const SparseMatrix& first, const SparseMatrix& second);
+		/// Groups frequencies whose system matrices are identical for all switch states
+		void createHarmonicSolveGroups();
+
+		// #### Methods for lazily factorized switch matrices ####
+		/// Checks whether switched system matrices are factorized on first use
+		Bool hasLazySwitchedMatrices() const {
+			return (mLazySwitchedMatrices || mLowRankSwitchUpdates) && !mFrequencyParallel && !mSystemMatrixRecomputation;
+		}
+		/// Checks whether the cache reached its entry or memory limit
+		Bool isSwitchedMatrixCacheFull() const;
+		/// Makes sure the system matrix for the given switch state is factorized and marks it as most recently used
+		void requireSwitchedMatrix(const std::bitset<SWITCH_NUM>& status);
+		/// Registers a freshly factorized system matrix and evicts least recently used ones if required
+		void cacheSwitchedMatrix(const std::bitset<SWITCH_NUM>& status);
+
+		// #### Methods for low-rank switch updates ####
+		/// Checks whether switch changes are applied as low-rank updates of a base factorization
+		Bool hasLowRankSwitchUpdates() const {
+			return mLowRankSwitchUpdates && hasLazySwitchedMatrices();
+		}
+		/// Returns the low-rank update for the current switch status or nullptr if a factorization has to be used
+		LowRankSwitchUpdate* requireLowRankSwitchUpdate();
+		/// Computes the low-rank update of the base factorization for the given switch status
+		Bool createLowRankSwitchUpdate(const std::bitset<SWITCH_NUM>& status, LowRankSwitchUpdate& update);
+		/// Registers a low-rank update and evicts least recently used ones if the cache limits are exceeded
+		LowRankSwitchUpdate* cacheLowRankSwitchUpdate(const std::bitset<SWITCH_NUM>& status, LowRankSwitchUpdate&& update);
+		/// Discards all low-rank updates, required when the base factorization changes
+		void clearLowRankSwitchUpdates();
+		/// Solves the system of the current switch status, either directly or as low-rank update
+		void solveSwitchedSystem();
 
 		// #### Methods for system recomputation over time ####
 		/// Stamps components into the variable system matrix
@@ -124,13 +275,19 @@ namespace DPsim {
 		std::shared_ptr<CPS::Task> createSolveTaskRecomp() override;
 		/// Recomputes systems matrix
 		virtual void recomputeSystemMatrix(Real time);
+		/// Stamps all switches and variable components on top of the base matrix
+		void restampVariableSystemMatrix();
+		/// Records the value array offsets of all switch and variable component stamps
+		void createStampSlots();
+		/// Re-assembles the variable system matrix through the stamp slots, fails if a stamp changed its pattern
+		Bool stampWithSlots();
 
 		// #### Scheduler Task Methods ####
 		/// Create a solve task for this solver implementation
 		std::shared_ptr<CPS::Task> createSolveTask() override;
 		/// Create a solve task for this solver implementation
 		std::shared_ptr<CPS::Task> createLogTask() override;
-		/// Create a solve task for this solver implementation
+		/// Create a solve task for this solver implementation, nullptr if the frequency is solved within another group
 		std::shared_ptr<CPS::Task> createSolveTaskHarm(UInt freqIdx) override;
 		/// Logging of system matrices and source vector
 		void logSystemMatrices() override;
@@ -139,6 +296,9 @@ namespace DPsim {
 		/// Solves system for multiple frequencies
 		void solveWithHarmonics(Real time, Int timeStepCount, Int freqIdx) override;
 
+		/// Solves the system into the preallocated solution vector
+		void solveSystem(DirectLinearSolver& solver, const Matrix& rightSideVector, Matrix& leftSideVector);
+
 		/// Logging of the right-hand-side solution time
 		void logSolveTime();
 		/// Logging of the LU factorization time
@@ -165,9 +325,15 @@ namespace DPsim {
 		/// Sets the linear solver configuration
 		void setDirectLinearSolverConfiguration(DirectLinearSolverConfiguration& configuration);
 
+		/// Shares symbolic analyses of pattern-identical system matrices through the given pool
+		void setSymbolicAnalysisPool(SymbolicAnalysisPool::Ptr pool) override { mSymbolicAnalysisPool = pool; }
+
 		/// log LU decomposition times
 		void logLUTimes() override;
 
+		/// Factorizes the switch states reached by the scheduled switch state changes
+		void prewarmSwitchStates(const std::vector<SwitchStateChange>& changes) override;
+
 		/// ### SynGen Interface ###
 		int mIter = 0;
 
@@ -186,6 +352,11 @@ namespace DPsim {
 					mModifiedAttributes.push_back(node->mVoltage);
 				}
 				mModifiedAttributes.push_back(solver.mLeftSideVector);
+				mModifiedAttributes.push_back(solver.mNumSwitchedMatrixFactorizations);
+				mModifiedAttributes.push_back(solver.mNumCachedSwitchedMatrices);
+				mModifiedAttributes.push_back(solver.mNumSwitchedMatrixEvictions);
+				mModifiedAttributes.push_back(solver.mNumLowRankSolves);
+				mModifiedAttributes.push_back(solver.mNumCachedLowRankUpdates);
 			}
 
 			void execute(Real time, Int timeStepCount) {
@@ -241,6 +412,7 @@ namespace DPsim {
 					mModifiedAttributes.push_back(node->mVoltage);
 				}
 				mModifiedAttributes.push_back(solver.mLeftSideVector);
+				mModifiedAttributes.push_back(solver.mNumStampSlotFallbacks);
 			}
 
 			void execute(Real time, Int timeStepCount) {
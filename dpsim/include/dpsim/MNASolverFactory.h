@@ -52,8 +52,10 @@ class MnaSolverFactory {
 #endif // WITH_CUDA
 			DirectLinearSolverImpl::DenseLU,
 			DirectLinearSolverImpl::SparseLU,
+			DirectLinearSolverImpl::ParallelSparseLU,
 #ifdef WITH_KLU
-			DirectLinearSolverImpl::KLU
+			DirectLinearSolverImpl::KLU,
+			DirectLinearSolverImpl::KLUComplex
 #endif //WITH_KLU
 		};
 		return ret;
@@ -91,6 +93,13 @@ class MnaSolverFactory {
 			denseSolver->setDirectLinearSolverImplementation(DirectLinearSolverImpl::DenseLU);
 			return denseSolver;
 		}
+		case DirectLinearSolverImpl::ParallelSparseLU:
+		{
+			log->info("creating ParallelSparseLUAdapter solver implementation");
+			std::shared_ptr<MnaSolverDirect<VarType>> parallelSparseSolver = std::make_shared<MnaSolverDirect<VarType>>(name, domain, logLevel);
+			parallelSparseSolver->setDirectLinearSolverImplementation(DirectLinearSolverImpl::ParallelSparseLU);
+			return parallelSparseSolver;
+		}
 #ifdef WITH_KLU
 		case DirectLinearSolverImpl::KLU:
 		{
@@ -99,6 +108,13 @@ class MnaSolverFactory {
 			kluSolver->setDirectLinearSolverImplementation(DirectLinearSolverImpl::KLU);
 			return kluSolver;
 		}
+		case DirectLinearSolverImpl::KLUComplex:
+		{
+			log->info("creating KLUComplexAdapter solver implementation");
+			std::shared_ptr<MnaSolverDirect<VarType>> kluComplexSolver = std::make_shared<MnaSolverDirect<VarType>>(name, domain, logLevel);
+			kluComplexSolver->setDirectLinearSolverImplementation(DirectLinearSolverImpl::KLUComplex);
+			return kluComplexSolver;
+		}
 #endif
 #ifdef WITH_CUDA
 		case DirectLinearSolverImpl::CUDADense:
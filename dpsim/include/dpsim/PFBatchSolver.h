@@ -0,0 +1,82 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <functional>
+
+#include <dpsim/PFSolverPowerPolar.h>
+
+namespace DPsim {
+    /// Results of a batch of powerflow snapshots, one column per snapshot
+    struct PFBatchResult {
+        /// Names of the nodes in the order of the voltage rows
+        std::vector<CPS::String> nodeNames;
+        /// Names of the lines and transformers in the order of the branch flow rows
+        std::vector<CPS::String> branchNames;
+        /// Complex node voltages in V
+        CPS::MatrixComp voltages;
+        /// Complex power flowing into each branch at its first terminal in VA
+        CPS::MatrixComp branchPowerFrom;
+        /// Complex power flowing into each branch at its second terminal in VA
+        CPS::MatrixComp branchPowerTo;
+        /// Number of iterations of each snapshot, -1 if it did not converge
+        std::vector<CPS::Int> iterations;
+    };
+
+    /// Solves many independent powerflow snapshots of one topology in parallel.
+    ///
+    /// The admittance matrix, the bus types and the pattern and symbolic analysis of the
+    /// sparse Jacobian are set up once. Each worker thread holds a copy of the solution
+    /// vectors and its own numeric factorization and processes the snapshots assigned to it.
+    class PFBatchSolver : public PFSolverPowerPolar {
+    protected:
+        /// Number of worker threads (0: hardware concurrency)
+        CPS::UInt mNumThreads = 0;
+        /// Flag whether the topology is initialized
+        CPS::Bool mBatchInitialized = false;
+        /// Flat start solution with the voltage set-points of the topology
+        CPS::Vector mFlatStartV;
+        CPS::Vector mFlatStartD;
+        /// Base voltage of each node in the order of the matrix node indices
+        CPS::Vector mBaseVoltages;
+        /// Names of the nodes in the order of the matrix node indices
+        std::vector<CPS::String> mNodeNames;
+        /// Names of the lines followed by the transformers
+        std::vector<CPS::String> mBranchNames;
+        /// Per unit admittance matrix of each branch
+        std::vector<CPS::MatrixComp> mBranchAdmittances;
+        /// Matrix node indices of both terminals of each branch
+        std::vector<std::pair<CPS::UInt, CPS::UInt>> mBranchNodes;
+
+        /// Initializes the topology and the symbolic analysis of the Jacobian
+        void initializeBatch();
+        /// Give a copy of this solver its own linear solver sharing the symbolic analysis of the Jacobian
+        void prepareWorker(PFBatchSolver& worker);
+        /// Number of worker threads used for the given number of tasks
+        CPS::UInt numberOfWorkers(CPS::UInt numTasks) const;
+        /// Runs the work function in the given number of threads, rethrowing the first exception of a worker
+        static void runWorkers(CPS::UInt numWorkers, const std::function<void(CPS::UInt)>& work);
+        /// Per unit complex power flowing into a branch at both terminals for the given node voltages
+        void calculateBranchPower(const CPS::VectorComp& voltages, CPS::UInt branch, CPS::Complex& from, CPS::Complex& to) const;
+
+    public:
+        /// Constructor for a topology whose snapshots are solved by solve()
+        PFBatchSolver(CPS::String name, const CPS::SystemTopology &system, CPS::Logger::Level logLevel = CPS::Logger::Level::off);
+        ///
+        virtual ~PFBatchSolver() { };
+
+        /// Set the number of worker threads (0: hardware concurrency)
+        void setNumberOfThreads(CPS::UInt numThreads) { mNumThreads = numThreads; }
+
+        /// Solves one powerflow per column of the net nodal injections in W and var (generation positive).
+        /// The rows follow the matrix node indices, injections at VD buses and reactive injections
+        /// at PV buses are ignored. Voltage set-points are taken from the topology.
+        PFBatchResult solve(const Matrix& activePower, const Matrix& reactivePower);
+    };
+}
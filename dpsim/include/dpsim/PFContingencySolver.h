@@ -0,0 +1,122 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <dpsim/PFBatchSolver.h>
+
+namespace DPsim {
+    /// Limit violation found in the powerflow after an outage
+    struct PFContingencyViolation {
+        enum class Type { BranchOverload, Undervoltage, Overvoltage };
+
+        Type type;
+        /// Name of the overloaded branch or of the node
+        CPS::String element;
+        /// Loading of the branch in VA or voltage magnitude in per unit
+        CPS::Real value;
+        /// Violated limit in the same unit
+        CPS::Real limit;
+    };
+
+    /// Outcome of a single branch outage
+    struct PFContingencyResult {
+        /// Name of the branch taken out of service
+        CPS::String outage;
+        /// The outage splits the network into islands
+        CPS::Bool islanding = false;
+        /// The outage passed the linear screening and was verified with the AC powerflow.
+        /// Outages ruled out by the screening were only checked for branch overloads, not for voltage violations.
+        CPS::Bool verified = false;
+        /// The AC powerflow after the outage converged
+        CPS::Bool converged = false;
+        /// Number of AC iterations
+        CPS::Int iterations = 0;
+        /// Highest branch loading estimated by the linear screening (1: at the limit)
+        CPS::Real estimatedLoading = 0.;
+        /// Sum of the relative overloads and the per unit voltage deviations beyond the limits,
+        /// infinite for islanding and non-converged outages, zero for outages that were not verified
+        CPS::Real severity = 0.;
+        /// Violations found by the AC verification
+        std::vector<PFContingencyViolation> violations;
+    };
+
+    /// N-1 contingency analysis of all line and transformer outages.
+    ///
+    /// Starting from the converged base case, each outage is first screened with line outage
+    /// distribution factors derived from the factorized DC susceptance matrix. Outages whose estimated
+    /// loading exceeds the screening threshold are verified with the AC powerflow. The screening
+    /// does not estimate voltages, so the voltage limits are only checked for verified outages. The outage only
+    /// changes a small block of the Jacobian, so the verification starts with iterations on the base case
+    /// Jacobian corrected by the Sherman-Morrison-Woodbury formula and only falls back to Newton iterations
+    /// with a numeric refactorization if these do not converge. The admittance matrix of each worker is
+    /// updated in place, so that no topology has to be rebuilt. Outages are distributed over the workers
+    /// of the batch solver.
+    class PFContingencySolver : public PFBatchSolver {
+    protected:
+        /// Apparent power limits of the branches in VA, by name
+        std::map<CPS::String, CPS::Real> mBranchLimits;
+        /// Lower voltage limit in per unit
+        CPS::Real mMinVoltage = 0.9;
+        /// Upper voltage limit in per unit
+        CPS::Real mMaxVoltage = 1.1;
+        /// Estimated loading above which an outage is verified with the AC powerflow
+        CPS::Real mScreeningThreshold = 0.9;
+        /// Maximum number of iterations with the compensated base case Jacobian
+        CPS::UInt mCompensationIterations = 20;
+
+        /// Per unit apparent power limit of each branch (0: unlimited)
+        CPS::Vector mBranchLimitsPerUnit;
+        /// Series susceptance of each branch used by the screening
+        CPS::Vector mBranchSusceptances;
+        /// Per unit flows of the base case at both terminals of each branch
+        CPS::VectorComp mBaseFlowFrom;
+        CPS::VectorComp mBaseFlowTo;
+        /// Voltages of the base case
+        CPS::Vector mBaseV;
+        CPS::Vector mBaseD;
+        /// Jacobian of the base case
+        SparseMatrix mBaseJacobian;
+        /// Susceptance matrix of the PQ and PV buses
+        SparseMatrix mSusceptanceMatrix;
+        /// Factorizations of the base case Jacobian and of the susceptance matrix of this worker
+        std::shared_ptr<DirectLinearSolver> mBaseJacobianSolver;
+        std::shared_ptr<DirectLinearSolver> mSusceptanceSolver;
+
+        /// Solve the base case and set up the screening
+        void solveBaseCase();
+        /// Compose the susceptance matrix of the DC approximation
+        void composeSusceptanceMatrix();
+        /// Factorize the base case Jacobian and the susceptance matrix of a worker
+        void prepareContingencyWorker(PFContingencySolver& worker);
+        /// Estimate the highest loading after the outage of a branch, returns false on islanding
+        CPS::Bool screenOutage(CPS::UInt branch, CPS::Real& estimatedLoading);
+        /// Solve the AC powerflow without the branch and collect the violations
+        void verifyOutage(CPS::UInt branch, PFContingencyResult& result);
+        /// Iterations with the base case Jacobian corrected for the outaged branch
+        CPS::Bool solveCompensated(CPS::UInt branch, CPS::Int& iterations);
+
+    public:
+        /// Constructor for a topology whose outages are analyzed by analyze()
+        PFContingencySolver(CPS::String name, const CPS::SystemTopology &system, CPS::Logger::Level logLevel = CPS::Logger::Level::off);
+        ///
+        virtual ~PFContingencySolver() { };
+
+        /// Set the apparent power limit of a line or transformer in VA
+        void setBranchLimit(const CPS::String& name, CPS::Real apparentPower) { mBranchLimits[name] = apparentPower; }
+        /// Set the voltage limits in per unit
+        void setVoltageLimits(CPS::Real minVoltage, CPS::Real maxVoltage) { mMinVoltage = minVoltage; mMaxVoltage = maxVoltage; }
+        /// Set the estimated loading above which an outage is verified with the AC powerflow.
+        /// Without branch limits, all outages are verified. Outages below the threshold are not checked
+        /// for voltage violations, a threshold of 0 verifies all outages.
+        void setScreeningThreshold(CPS::Real threshold) { mScreeningThreshold = threshold; }
+
+        /// Analyzes the outage of each line and transformer, ranked by decreasing severity
+        std::vector<PFContingencyResult> analyze();
+    };
+}
@@ -13,12 +13,13 @@
 
 #include <dpsim/Solver.h>
 #include <dpsim/Scheduler.h>
+#include <dpsim/MNASolverDirect.h>
 #include "dpsim-models/SystemTopology.h"
 #include "dpsim-models/Components.h"
 
 namespace DPsim {
     /// Solver class using the nonlinear powerflow (PF) formulation.
-    class PFSolver: public Solver {
+    class PFSolver: public Solver, public CPS::AttributeList {
     protected:
         /// Number of PQ nodes
         UInt mNumPQBuses = 0;
@@ -48,10 +49,32 @@ namespace DPsim {
 
         /// Jacobian matrix
         CPS::Matrix mJ;
+        /// Sparse representation of the Jacobian matrix passed to the linear solver
+        SparseMatrix mJSparse;
+        /// Linear solver for the Newton steps
+        std::shared_ptr<DirectLinearSolver> mJacobianSolver;
+        /// Jacobian entries that vary between the iterations (unused by the sparse LU)
+        std::vector<std::pair<UInt, UInt>> mJacobianVariableEntries;
+        /// Assemble the Jacobian directly in sparse form following the pattern of the admittance matrix
+        CPS::Bool mSparseJacobian = false;
+        /// Flag whether the symbolic analysis of the sparse Jacobian is done
+        CPS::Bool mJacobianAnalyzed = false;
+        /// Linear solver implementation for the Newton steps
+        DirectLinearSolverImpl mJacobianSolverImpl = DirectLinearSolverImpl::Undef;
+        /// Configuration of the linear solver for the Newton steps
+        DirectLinearSolverConfiguration mJacobianSolverConfiguration;
+        /// Flag whether the linear solver holds a factorized Jacobian
+        CPS::Bool mJacobianFactorized = false;
+        /// Keep the factorized Jacobian as long as an iteration reduces the largest mismatch by this ratio (0: always refactorize)
+        CPS::Real mJacobianReuseRatio = 0.;
+        /// Start each time step from the solution of the previous one
+        CPS::Bool mWarmStart = false;
+        /// Number of Jacobian factorizations in the current time step
+        CPS::Int mStepFactorizations = 0;
         /// Solution vector
-        CPS::Vector mX;
+        CPS::Matrix mX;
 	    /// Vector of mismatch values
-        CPS::Vector mF;
+        CPS::Matrix mF;
 
         /// System list
         CPS::SystemTopology mSystem;
@@ -119,8 +142,14 @@ namespace DPsim {
         CPS::Real G(int i, int j);
         /// Gets the imaginary part of admittance matrix element
         CPS::Real B(int i, int j);
+        /// Create the linear solver for the Newton steps
+        std::shared_ptr<DirectLinearSolver> createJacobianSolver();
+        /// Factorize the current Jacobian, reusing the symbolic analysis of the sparse Jacobian
+        void factorizeJacobian();
+        /// Discard the symbolic analysis and the factorization of the Jacobian
+        virtual void resetJacobian();
         /// Solves the powerflow problem
-        Bool solvePowerflow();
+        virtual Bool solvePowerflow();
         /// Check whether below tolerance
         CPS::Bool checkConvergence();
         /// Logging for integer vectors
@@ -133,6 +162,11 @@ namespace DPsim {
         CPS::Task::List getTasks();
         // determines power flow bus type for each node according to the components attached to it.
     public:
+        /// Number of iterations of the last time step
+        const CPS::Attribute<CPS::Int>::Ptr mNumIterations;
+        /// Number of Jacobian factorizations in the last time step
+        const CPS::Attribute<CPS::Int>::Ptr mNumFactorizations;
+
         /// Constructor to be used in simulation examples.
 		PFSolver(CPS::String name,
 			CPS::SystemTopology system,
@@ -147,11 +181,27 @@ namespace DPsim {
         void modifyPowerFlowBusComponent(CPS::String name, CPS::PowerflowBusType powerFlowBusType);
         /// set solver and component to initialization or simulation behaviour
 		void setSolverAndComponentBehaviour(Solver::Behaviour behaviour) override;
+        /// Assemble the Jacobian in sparse form and only refactorize it numerically after the first iteration
+        void doSparseJacobian(Bool value) { mSparseJacobian = value; }
+        /// Start each time step from the voltages of the previous one instead of a flat start
+        void doWarmStart(Bool value) { mWarmStart = value; }
+        /// Reuse the factorized Jacobian of earlier iterations and time steps as long as each iteration
+        /// reduces the largest mismatch at least by the given ratio (0: refactorize in every iteration)
+        void setJacobianReuseRatio(Real ratio) { mJacobianReuseRatio = ratio; }
+        /// Set the linear solver for the sparse Jacobian and the fast-decoupled matrices
+        /// (Undef: KLU for the sparse Jacobian if available, otherwise SparseLU). The dense Jacobian is always factorized with SparseLU.
+        void setDirectLinearSolverImplementation(DirectLinearSolverImpl implementation) { mJacobianSolverImpl = implementation; }
+        /// Set the configuration of the linear solver for the sparse Jacobian and the fast-decoupled matrices
+        void setDirectLinearSolverConfiguration(DirectLinearSolverConfiguration& configuration) override {
+            mJacobianSolverConfiguration = configuration;
+        }
 
         class SolveTask : public CPS::Task {
 		public:
 			SolveTask(PFSolver& solver) :
 				Task(solver.mName + ".Solve"), mSolver(solver) {
+				mModifiedAttributes.push_back(solver.mNumIterations);
+				mModifiedAttributes.push_back(solver.mNumFactorizations);
 				mModifiedAttributes.push_back(Scheduler::external);
 			}
 
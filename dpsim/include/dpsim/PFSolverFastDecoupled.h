@@ -0,0 +1,55 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <dpsim/FastDecoupledVariant.h>
+#include <dpsim/PFSolverPowerPolar.h>
+
+namespace DPsim {
+    /// Fast-decoupled powerflow solver in polar coordinates.
+    ///
+    /// The active power mismatches are solved for the voltage angles with the constant matrix B'
+    /// and the reactive power mismatches of the PQ buses for the voltage magnitudes with B''.
+    /// Both matrices are derived from the admittance matrix and factorized once, so that each
+    /// iteration only consists of the mismatch calculations and two forward/backward substitutions.
+    /// Compared to the Newton solver, more but much cheaper iterations are required.
+    class PFSolverFastDecoupled : public PFSolverPowerPolar {
+    protected:
+        /// Approximation used for B' and B''
+        FastDecoupledVariant mVariant = FastDecoupledVariant::XB;
+        /// Matrix relating active power mismatches and voltage angles of PQ and PV buses
+        SparseMatrix mBPrime;
+        /// Matrix relating reactive power mismatches and voltage magnitudes of PQ buses
+        SparseMatrix mBDoublePrime;
+        /// Linear solvers holding the factorizations of B' and B''
+        std::shared_ptr<DirectLinearSolver> mBPrimeSolver;
+        std::shared_ptr<DirectLinearSolver> mBDoublePrimeSolver;
+        /// Scaled mismatches and increments of the half iterations
+        Matrix mDeltaP;
+        Matrix mDeltaQ;
+        Matrix mDeltaD;
+        Matrix mDeltaV;
+
+        /// Compose B' and B'' from the admittance matrix
+        void composeDecoupledMatrices();
+        /// Solves the powerflow problem with alternating P-angle and Q-magnitude half iterations
+        Bool solvePowerflow() override;
+
+    public:
+        /// Constructor to be used in simulation examples.
+        PFSolverFastDecoupled(CPS::String name, const CPS::SystemTopology &system, CPS::Real timeStep, CPS::Logger::Level logLevel);
+        ///
+        virtual ~PFSolverFastDecoupled() { };
+
+        /// Initialization of the solver and factorization of B' and B''
+        void initialize() override;
+        /// Select the approximation used for B' and B''
+        void setVariant(FastDecoupledVariant variant) { mVariant = variant; }
+    };
+}
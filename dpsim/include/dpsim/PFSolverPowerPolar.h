@@ -30,11 +30,33 @@ namespace DPsim {
         CPS::Vector Pesp;
         CPS::Vector Qesp;
 
+        /// Bus voltages of the current solution in rectangular coordinates
+        CPS::VectorComp mVoltageRect;
+        /// Current injections Y*V of the current solution
+        CPS::VectorComp mCurrentInjection;
+        /// Power injections V.*conj(Y*V) of the current solution
+        CPS::VectorComp mPowerInjection;
+
+        /// Position of the voltage angle of each bus in the unknowns (-1 for VD buses),
+        /// the voltage magnitude of a PQ bus follows at the same position after the angles
+        std::vector<CPS::Int> mAngleIndex;
+        /// Offsets into the values of the sparse Jacobian for each nonzero of the admittance matrix
+        /// in the order dP/dD, dP/dV, dQ/dD, dQ/dV (-1 if the entry is not part of the Jacobian)
+        std::vector<CPS::Int> mJacobianOffsets;
+        /// Offsets of the diagonal entries of the four Jacobian blocks for each PQ and PV bus
+        std::vector<CPS::Int> mJacobianDiagonalOffsets;
+
         // Core methods
         /// Generate initial solution for current time step
         void generateInitialSolution(Real time, bool keep_last_solution = false);
-        /// Calculate the Jacobian
+        /// Calculate the Jacobian from the power injections of the last mismatch calculation
         void calculateJacobian();
+        /// Calculate the Jacobian in place in the sparse Jacobian, visiting only the nonzeros of the admittance matrix
+        void calculateJacobianSparse();
+        /// Compose the sparsity pattern of the Jacobian from the admittance matrix
+        void composeJacobianPattern();
+        /// Discard the sparsity pattern together with the symbolic analysis of the Jacobian
+        void resetJacobian() override;
         /// Update solution in each iteration
         void updateSolution();
         /// Set final solution
@@ -53,10 +75,12 @@ namespace DPsim {
         CPS::Real sol_Vi(CPS::UInt k);
         /// Calculate complex voltage from sol_V and sol_D
 		CPS::Complex sol_Vcx(CPS::UInt k);
-        /// Calculate active power at a bus from current solution
-        CPS::Real P(CPS::UInt k);
-        /// Calculate the reactive power at a bus from current solution
-        CPS::Real Q(CPS::UInt k);
+        /// Calculate the power injections of all buses from the current solution in one pass over the admittance matrix
+        void calculatePowerInjection();
+        /// Active power at a bus from the last power injection calculation
+        CPS::Real P(CPS::UInt k) { return mPowerInjection.coeff(k).real(); }
+        /// Reactive power at a bus from the last power injection calculation
+        CPS::Real Q(CPS::UInt k) { return mPowerInjection.coeff(k).imag(); }
         /// Calculate P and Q at slack bus from current solution
         void calculatePAndQAtSlackBus();
         /// Calculate the reactive power at all PV buses from current solution
@@ -0,0 +1,136 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include <dpsim/Config.h>
+#include <dpsim/Definitions.h>
+#include <dpsim/DirectLinearSolver.h>
+
+namespace DPsim
+{
+	/// Sparse LU adapter with multithreaded refactorization and triangular solves.
+	///
+	/// The matrix is ordered with AMD and factored once with threshold partial pivoting
+	/// (left-looking Gilbert-Peierls). Refactorizations keep the pivot sequence, so the
+	/// columns of L and U only depend on the columns listed in the pattern of U. Columns
+	/// without mutual dependencies are grouped into levels that are computed in parallel.
+	/// The forward and backward substitutions are level-scheduled in the same way.
+	/// Parallelization uses OpenMP if available; inside an active parallel region (e.g. the
+	/// OpenMPLevelScheduler) nested parallelism has to be enabled to use more than one thread.
+	class ParallelSparseLUAdapter : public DirectLinearSolver
+	{
+		/// Dimension of the system matrix
+		Int mN = 0;
+		/// Number of nonzeros of the preprocessed matrix
+		Int nnz = 0;
+		/// Number of threads used for the parallel levels
+		Int mNumThreads = 1;
+		/// Minimum dimension for which parallel regions are opened
+		Int mParallelThreshold = 1000;
+		/// Minimum ratio of pivot and largest entry of a column, otherwise a row swap is done
+		Real mPivotTolerance = 0.001;
+		/// Count Pivot faults
+		int mPivotFaults = 0;
+
+		/// Fill-reducing column ordering, original column of the k-th column
+		std::vector<Int> mColPerm;
+		/// Pivot sequence, original row of the k-th pivot and its inverse
+		std::vector<Int> mRowPerm;
+		std::vector<Int> mRowPermInv;
+
+		/// Column-permuted matrix in compressed column format with original row indices,
+		/// values are read from the system matrix through the stored value offsets
+		std::vector<Int> mBColPtr;
+		std::vector<Int> mBRowIdx;
+		std::vector<Int> mBValueOffsets;
+		/// Row indices of the column-permuted matrix in pivot order
+		std::vector<Int> mBPivotRow;
+
+		/// Strictly lower part of L (unit diagonal) in compressed column format, pivot order
+		std::vector<Int> mLColPtr;
+		std::vector<Int> mLRowIdx;
+		std::vector<Real> mLValues;
+		/// Strictly upper part of U in compressed column format with ascending rows, pivot order
+		std::vector<Int> mUColPtr;
+		std::vector<Int> mURowIdx;
+		std::vector<Real> mUValues;
+		/// Diagonal of U
+		std::vector<Real> mUDiag;
+
+		/// Row-oriented copies of L and U used by the substitutions and their source positions
+		std::vector<Int> mLRowPtr;
+		std::vector<Int> mLColIdx;
+		std::vector<Int> mLRowSource;
+		std::vector<Real> mLRowValues;
+		std::vector<Int> mURowPtr;
+		std::vector<Int> mUColIdx;
+		std::vector<Int> mURowSource;
+		std::vector<Real> mURowValues;
+
+		/// Level schedules: levels[i] to levels[i+1] index the items of level i
+		std::vector<Int> mFactorLevels;
+		std::vector<Int> mFactorLevelItems;
+		std::vector<Int> mForwardLevels;
+		std::vector<Int> mForwardLevelItems;
+		std::vector<Int> mBackwardLevels;
+		std::vector<Int> mBackwardLevelItems;
+
+		/// Dense work vector per thread, kept zero between columns
+		std::vector<std::vector<Real>> mWork;
+		/// Permuted right hand side and solution
+		std::vector<Real> mSolveBuffer;
+
+	public:
+		/// Constructor
+		ParallelSparseLUAdapter();
+
+		/// Constructor with logging
+		ParallelSparseLUAdapter(CPS::Logger::Log log);
+
+		/// Destructor
+		~ParallelSparseLUAdapter() override;
+
+		/// preprocessing function computing the fill-reducing ordering
+		void preprocessing(SparseMatrix& systemMatrix, std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries) override;
+
+		/// factorization function with partial pivoting
+		void factorize(SparseMatrix& systemMatrix) override;
+
+		/// parallel refactorization without partial pivoting
+		void refactorize(SparseMatrix& systemMatrix) override;
+
+		/// parallel refactorization without partial pivoting, all entries are recomputed
+		void partialRefactorize(SparseMatrix& systemMatrix, std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries) override;
+
+		/// solution function for a right hand side
+		Matrix solve(Matrix& rightSideVector) override;
+
+		/// solution function for a right hand side writing into a preallocated solution vector
+		void solve(const Matrix& rightSideVector, Matrix& leftSideVector) override;
+
+		/// estimated memory footprint of the current factorization in bytes
+		std::size_t factorizationMemory() const override;
+
+		/// Sets the number of threads (0: OpenMP default)
+		void setNumberOfThreads(Int numThreads);
+
+	private:
+		/// Computes the nonzero pattern of L\B(:,k) in topological order, returns the start in the stack
+		Int reach(Int k, std::vector<Int>& stack, std::vector<char>& marked,
+			const std::vector<Int>& lColPtr, const std::vector<Int>& lRowIdx) const;
+		/// Builds the level schedules and the row-oriented copies of L and U
+		void createSchedules();
+		/// Copies the values of L and U to their row-oriented copies
+		void updateRowValues();
+		/// Checks whether the parallel regions are worth their overhead
+		Bool useParallelLevels() const { return mNumThreads > 1 && mN >= mParallelThreshold; }
+	};
+}
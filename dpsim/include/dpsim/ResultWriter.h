@@ -0,0 +1,33 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <dpsim/Definitions.h>
+
+namespace DPsim {
+	/// Destination of the rows logged by a DataLogger.
+	///
+	/// Each row consists of the simulation time and one value per column.
+	class ResultWriter {
+	public:
+		typedef std::shared_ptr<ResultWriter> Ptr;
+
+		virtual ~ResultWriter() { }
+
+		/// Start the result with the names and units of the columns, called before the first row
+		virtual void open(const std::vector<String>& names, const std::vector<String>& units) = 0;
+		/// Append a row with one value per column
+		virtual void write(Real time, const Real* values) = 0;
+		/// Complete the result
+		virtual void close() = 0;
+	};
+}
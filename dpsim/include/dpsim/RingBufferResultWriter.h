@@ -0,0 +1,62 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <dpsim/ResultWriter.h>
+#include <dpsim-models/Filesystem.h>
+
+namespace DPsim {
+	/// Memory-mapped ring buffer with the latest rows, to be read by other processes while the simulation runs.
+	///
+	/// The file starts with a header whose size is a multiple of 64 bytes: the magic "DPSIMRNG", uint32 version,
+	/// uint32 number of columns, uint32 capacity in rows, uint32 state (1 while running, 2 after closing),
+	/// uint64 header size, uint64 sequence counter and uint64 number of written rows, followed by the name and
+	/// the unit of each column as uint16 length and characters. The rows follow the header, each with the time and
+	/// then the values as float64. Row n is stored in slot n modulo the capacity.
+	///
+	/// Unlike the result files, numbers are stored in host byte order: the counters are updated atomically
+	/// in place and the file is only meant to be read by processes on the same host.
+	///
+	/// The sequence counter is odd while a row is written and twice the number of written rows otherwise.
+	/// Readers copy the rows they need and read the counter before and after. All rows with an index
+	/// above (counter after + 1) / 2 - 1 - capacity are consistent, older rows may have been overwritten.
+	/// The file is kept after closing, so that the last rows remain readable.
+	class RingBufferResultWriter : public ResultWriter {
+	public:
+		static constexpr std::uint32_t VERSION = 1;
+
+		RingBufferResultWriter(const fs::path& filename, UInt capacity = 65536);
+		~RingBufferResultWriter() override;
+
+		void open(const std::vector<String>& names, const std::vector<String>& units) override;
+		void write(Real time, const Real* values) override;
+		void close() override;
+
+	protected:
+		///
+		fs::path mFilename;
+		/// Number of rows in the buffer
+		UInt mCapacity;
+		/// Number of value columns, without the time
+		UInt mNumColumns = 0;
+		/// Mapped file and its size
+		char* mMapped = nullptr;
+		std::size_t mSize = 0;
+		/// Counters in the header of the mapped file
+		std::atomic<std::uint64_t>* mSequence = nullptr;
+		std::atomic<std::uint64_t>* mRowsWritten = nullptr;
+		/// First row of the buffer
+		Real* mRows = nullptr;
+		/// Number of written rows
+		std::uint64_t mRowCount = 0;
+	};
+}
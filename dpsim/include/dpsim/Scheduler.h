@@ -11,6 +11,7 @@
 #include <dpsim-models/Task.h>
 
 #include <dpsim/Definitions.h>
+#include <dpsim/TimingStatistics.h>
 #include <dpsim-models/Logger.h>
 
 #include <atomic>
@@ -65,6 +66,10 @@ namespace DPsim {
 		TaskTime getAveragedMeasurement(CPS::Task::Ptr task) {
 			return getAveragedMeasurement(task.get());
 		}
+		/// Execution time statistics of the given task in seconds
+		const TimingStatistics& getMeasurement(CPS::Task::Ptr task) {
+			return mMeasurements[task.get()];
+		}
 
 		/// Root task that has a dependency on the external attribute
 		/// which means that it should not be removed from the task graph
@@ -104,10 +109,8 @@ namespace DPsim {
 		/// Logger
 		CPS::Logger::Log mSLog;
 	private:
-		// TODO more sophisticated measurement method might be necessary for
-		// longer simulations (risk of high memory requirements and integer
-		// overflow)
-		std::unordered_map<CPS::Task*, std::vector<TaskTime>> mMeasurements;
+		/// Execution time statistics per task with constant memory per task
+		std::unordered_map<CPS::Task*, TimingStatistics> mMeasurements;
 	};
 
 	/// A barrier is used to synchronize threads. Threads running into the barrier
@@ -4,12 +4,15 @@
 
 #include "dpsim/MNASolverFactory.h"
 #include <vector>
+#include <functional>
 
 #include <dpsim/Config.h>
 #include <dpsim/DataLogger.h>
 #include <dpsim/Solver.h>
+#include <dpsim/FastDecoupledVariant.h>
 #include <dpsim/Scheduler.h>
 #include <dpsim/Event.h>
+#include <dpsim/TimingStatistics.h>
 #include <dpsim-models/Definitions.h>
 #include <dpsim-models/Logger.h>
 #include <dpsim-models/SystemTopology.h>
@@ -76,7 +79,9 @@ namespace DPsim {
 		/// Simulation log level
 		CPS::Logger::Level mLogLevel;
 		/// (Real) time needed for the timesteps
-		std::vector<Real> mStepTimes;
+		TimingStatistics mStepTimes;
+		/// Keep the raw trace of all step and solver time measurements
+		Bool mTimingTrace = false;
 
 		// #### Solver Settings ####
 		///
@@ -95,6 +100,30 @@ namespace DPsim {
 		Bool mInitFromNodesAndTerminals = true;
 		/// Enable recomputation of system matrix during simulation
 		Bool mSystemMatrixRecomputation = false;
+		/// Factorize switched system matrices on first use
+		Bool mLazySwitchedMatrices = false;
+		/// Re-assemble the variable system matrix through precomputed stamp slots
+		Bool mStampSlotReassembly = false;
+		/// Apply switch changes as low-rank updates of a base factorization
+		Bool mLowRankSwitchUpdates = false;
+		/// Number of switches that may differ from the base factorization before refactorizing
+		UInt mMaxLowRankSwitchChanges = 4;
+		/// Share the symbolic analysis between subnets with identical sparsity patterns
+		Bool mSharedSymbolicAnalysis = false;
+		/// Symbolic analyses shared by the subnet solvers, if enabled
+		SymbolicAnalysisPool::Ptr mSymbolicAnalysisPool;
+		/// Assemble the powerflow Jacobian in sparse form
+		Bool mSparseJacobian = false;
+		/// Approximation of the fast-decoupled powerflow matrices
+		FastDecoupledVariant mFastDecoupledVariant = FastDecoupledVariant::XB;
+		/// Start each powerflow time step from the previous solution
+		Bool mPowerflowWarmStart = false;
+		/// Mismatch reduction ratio below which the factorized powerflow Jacobian is kept
+		Real mJacobianReuseRatio = 0.;
+		/// Maximum number of cached switched system matrices (0: unlimited)
+		UInt mSwitchedMatrixCacheSize = 0;
+		/// Memory budget in bytes for cached switched system matrices (0: unlimited)
+		std::size_t mSwitchedMatrixCacheMemory = 0;
 
 		/// If tearing components exist, the Diakoptics
 		/// solver is selected automatically.
@@ -105,6 +134,8 @@ namespace DPsim {
 		/// of linear components that do no create cross
 		/// frequency coupling.
 		Bool mFreqParallel = false;
+		/// Solve frequencies with identical system matrices with one factorization
+		Bool mHarmonicSolveGrouping = true;
 		///
 		Bool mInitialized = false;
 
@@ -145,6 +176,8 @@ namespace DPsim {
 		void createMNASolver();
 		/// Prepare schedule for simulation
 		void prepSchedule();
+		/// Pass the scheduled switch events to the solvers
+		void prewarmSwitchStates();
 
 		/// ### SynGen Interface ###
 		int mMaxIterations = 10;
@@ -195,8 +228,49 @@ namespace DPsim {
 		}
 		/// Compute phasors of different frequencies in parallel
 		void doFrequencyParallelization(Bool value) { mFreqParallel = value; }
+		/// Solve frequencies whose system matrices are identical for all switch states as one multi-column system
+		/// (enabled by default). The MNA solver provides the number of solve groups as attribute "harmonic_solve_groups".
+		void doHarmonicSolveGrouping(Bool value) { mHarmonicSolveGrouping = value; }
 		///
 		void doSystemMatrixRecomputation(Bool value) { mSystemMatrixRecomputation = value; }
+		/// Factorize switched system matrices when they are first reached instead of precomputing all combinations.
+		/// The MNA solver provides the attributes "factorizations", "cached_matrices" and "evictions", see getIdObjAttribute
+		/// with the name of the simulation (followed by "_<index>" for split subnets) after initialize().
+		void doLazySwitchedMatrices(Bool value) { mLazySwitchedMatrices = value; }
+		/// Write variable component stamps directly to their value offsets in the system matrix during recomputation.
+		/// Components have to stamp additively and keep their sparsity pattern, otherwise a full restamp is done,
+		/// which the MNA solver counts in its attribute "stamp_slot_fallbacks".
+		void doStampSlotReassembly(Bool value) { mStampSlotReassembly = value; }
+		/// Solve switch changes as Woodbury low-rank updates of the last factorized system matrix.
+		/// A new factorization is only computed once more than maxChanges switches differ from it.
+		/// The cached updates are limited by setSwitchedMatrixCacheLimits like the switched matrices and
+		/// counted in the attributes "low_rank_solves" and "cached_low_rank_updates" of the MNA solver.
+		void doLowRankSwitchUpdates(Bool value, UInt maxChanges = 4) {
+			mLowRankSwitchUpdates = value;
+			mMaxLowRankSwitchChanges = maxChanges;
+		}
+		/// Let subnets with pattern-identical system matrices share one ordering and symbolic analysis
+		void doSharedSymbolicAnalysis(Bool value = true) { mSharedSymbolicAnalysis = value; }
+		/// Symbolic analyses shared between the subnets after initialize(), nullptr if sharing is disabled
+		SymbolicAnalysisPool::Ptr symbolicAnalysisPool() const { return mSymbolicAnalysisPool; }
+		/// Assemble the powerflow Jacobian from the nonzeros of the admittance matrix and only refactorize it numerically.
+		/// The linear solver is chosen by setDirectLinearSolverImplementation (default: KLU if available).
+		void doSparseJacobian(Bool value = true) { mSparseJacobian = value; }
+		/// Select the approximation of B' and B'' used by the FDLF solver type
+		void setFastDecoupledVariant(FastDecoupledVariant variant) { mFastDecoupledVariant = variant; }
+		/// Start each powerflow time step from the voltages of the previous one. The factorized Jacobian is reused
+		/// across iterations and time steps as long as each iteration reduces the largest mismatch at least by
+		/// jacobianReuseRatio (0: refactorize in every iteration). The iterations and factorizations of each step
+		/// are attributes "iterations" and "factorizations" of the solver "<name>_PF", see getIdObjAttribute after initialize().
+		void doPowerflowWarmStart(Bool value = true, Real jacobianReuseRatio = 0.5) {
+			mPowerflowWarmStart = value;
+			mJacobianReuseRatio = value ? jacobianReuseRatio : 0.;
+		}
+		/// Limit the number of cached switched system matrices and their memory footprint in bytes (0: unlimited)
+		void setSwitchedMatrixCacheLimits(UInt maxEntries, std::size_t maxMemory = 0) {
+			mSwitchedMatrixCacheSize = maxEntries;
+			mSwitchedMatrixCacheMemory = maxMemory;
+		}
 
 		// #### Initialization ####
 		/// activate steady state initialization
@@ -232,6 +306,8 @@ namespace DPsim {
 		void addLogger(DataLogger::Ptr logger) {
 			mLoggers.push_back(logger);
 		}
+		/// Keep every step and solver time measurement in addition to the statistics
+		void doTimingTrace(Bool value = true) { mTimingTrace = value; }
 		/// Write step time measurements to log file
 		void logStepTimes(String logName);
 
@@ -257,7 +333,10 @@ namespace DPsim {
 		Real timeStep() const { return **mTimeStep; }
 		DataLogger::List& loggers() { return mLoggers; }
 		std::shared_ptr<Scheduler> scheduler() { return mScheduler; }
-		std::vector<Real>& stepTimes() { return mStepTimes; }
+		const TimingStatistics& stepTimes() const { return mStepTimes; }
+		/// Step time statistics and the statistics of all solvers, keyed by "<solver>.<operation>".
+		/// The entries refer to the statistics kept by the simulation and its solvers.
+		std::map<String, std::reference_wrapper<const TimingStatistics>> timingStatistics() const;
 
 		// #### Set component attributes during simulation ####
 		/// CHECK: Can these be deleted? getIdObjAttribute + "**attr =" should suffice
@@ -11,10 +11,13 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <map>
 
 #include <dpsim/Definitions.h>
 #include <dpsim/Config.h>
 #include <dpsim/DirectLinearSolverConfiguration.h>
+#include <dpsim/SymbolicAnalysisPool.h>
+#include <dpsim/TimingStatistics.h>
 #include <dpsim-models/Logger.h>
 #include <dpsim-models/SystemTopology.h>
 #include <dpsim-models/Task.h>
@@ -26,6 +29,14 @@ namespace DPsim {
 		UInt systemIndex;
 	};
 
+	/// Scheduled change of a switch state, used to factorize the expected
+	/// switched system matrices ahead of time.
+	struct SwitchStateChange {
+		Real time;
+		CPS::AttributeBase::Ptr switchState;
+		Bool closed;
+	};
+
 	/// Base class for more specific solvers such as MNA, ODE or IDA.
 	class Solver {
 	public:
@@ -45,6 +56,8 @@ namespace DPsim {
 		Real mTimeStep;
 		/// Activates parallelized computation of frequencies
 		Bool mFrequencyParallel = false;
+		/// Solves frequencies with identical system matrices together
+		Bool mHarmonicSolveGrouping = true;
 
 		// #### Initialization ####
 		/// steady state initialization time limit
@@ -60,6 +73,22 @@ namespace DPsim {
 		Bool mInitFromNodesAndTerminals = true;
 		/// Enable recomputation of system matrix during simulation
 		Bool mSystemMatrixRecomputation = false;
+		/// Factorize switched system matrices on first use instead of precomputing all combinations
+		Bool mLazySwitchedMatrices = false;
+		/// Maximum number of cached switched system matrices (0: unlimited)
+		UInt mSwitchedMatrixCacheSize = 0;
+		/// Memory budget in bytes for cached switched system matrices (0: unlimited)
+		std::size_t mSwitchedMatrixCacheMemory = 0;
+		/// Keep the raw trace of all timing measurements in addition to the statistics
+		Bool mTimingTrace = false;
+		/// Timing statistics of the solver, keyed by the measured operation
+		std::map<String, TimingStatistics> mTimingStatistics;
+		/// Re-assemble the variable system matrix by writing stamps to precomputed value offsets
+		Bool mStampSlotReassembly = false;
+		/// Apply switch changes as low-rank updates of a base factorization
+		Bool mLowRankSwitchUpdates = false;
+		/// Number of switches that may differ from the base factorization before refactorizing
+		UInt mMaxLowRankSwitchChanges = 4;
 
 		/// Solver behaviour initialization or simulation
         Behaviour mBehaviour = Solver::Behaviour::Simulation;
@@ -74,10 +103,13 @@ namespace DPsim {
 
 		virtual ~Solver() { }
 
+		///
+		String name() const { return mName; }
+
 		// #### Solver settings ####
 		/// Solver types:
-		/// Modified Nodal Analysis, Differential Algebraic, Newton Raphson
-		enum class Type { MNA, DAE, NRP };
+		/// Modified Nodal Analysis, Differential Algebraic, Newton Raphson, Fast-Decoupled Load Flow
+		enum class Type { MNA, DAE, NRP, FDLF };
 		///
 		void setTimeStep(Real timeStep) {
 			mTimeStep = timeStep;
@@ -87,9 +119,27 @@ namespace DPsim {
 			mFrequencyParallel = freqParallel;
 		}
 		///
+		void doHarmonicSolveGrouping(Bool value) { mHarmonicSolveGrouping = value; }
+		///
 		virtual void setSystem(const CPS::SystemTopology &system) {}
 		///
 		void doSystemMatrixRecomputation(Bool value) { mSystemMatrixRecomputation = value; }
+		///
+		void doLazySwitchedMatrices(Bool value) { mLazySwitchedMatrices = value; }
+		/// Limit the number of cached switched system matrices and their memory footprint (0: unlimited)
+		void setSwitchedMatrixCacheLimits(UInt maxEntries, std::size_t maxMemory = 0) {
+			mSwitchedMatrixCacheSize = maxEntries;
+			mSwitchedMatrixCacheMemory = maxMemory;
+		}
+		///
+		void doTimingTrace(Bool value) { mTimingTrace = value; }
+		///
+		void doStampSlotReassembly(Bool value) { mStampSlotReassembly = value; }
+		///
+		void doLowRankSwitchUpdates(Bool value, UInt maxChanges = 4) {
+			mLowRankSwitchUpdates = value;
+			mMaxLowRankSwitchChanges = maxChanges;
+		}
 
 		// #### Initialization ####
 		///
@@ -109,11 +159,24 @@ namespace DPsim {
 		{
 			// not every derived class has a linear solver configuration option
 		}
+		/// share symbolic analyses of pattern-identical system matrices with other solvers (only available in MNA for now)
+		virtual void setSymbolicAnalysisPool(SymbolicAnalysisPool::Ptr)
+		{
+			// solvers without a direct linear solver always run their own analysis
+		}
+		/// factorize the switch configurations reached by the given scheduled switch state changes
+		virtual void prewarmSwitchStates(const std::vector<SwitchStateChange>&)
+		{
+			// only solvers with lazily factorized switched matrices make use of this
+		}
 		/// log LU decomposition times, if applicable
 		virtual void logLUTimes()
 		{
 			// no default implementation for all types of solvers
 		}
+		/// timing statistics of the solver, keyed by the measured operation
+		/// (empty for solvers that do not measure their operations)
+		const std::map<String, TimingStatistics>& timingStatistics() const { return mTimingStatistics; }
 
 		// #### Simulation ####
 		/// Get tasks for scheduler
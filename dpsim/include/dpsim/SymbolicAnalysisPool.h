@@ -0,0 +1,63 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <dpsim/Definitions.h>
+#include <dpsim/DirectLinearSolver.h>
+
+namespace DPsim {
+	/// Registry of symbolic analyses that can be shared between solvers.
+	///
+	/// Subnets created by SystemTopology::multiply or splitSubnets often have
+	/// system matrices with identical sparsity patterns. The first linear solver
+	/// preprocessing such a pattern is registered here and later solvers adopt its
+	/// ordering and symbolic analysis instead of running their own.
+	class SymbolicAnalysisPool {
+	public:
+		typedef std::shared_ptr<SymbolicAnalysisPool> Ptr;
+
+		/// Preprocesses the matrix with the analysis of a registered solver with identical
+		/// pattern and variable entries, returns false if there is none or it cannot be shared
+		Bool preprocessingShared(SparseMatrix& systemMatrix,
+			const std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries, DirectLinearSolver& solver);
+		/// Registers a preprocessed solver as reference for its sparsity pattern
+		void add(const SparseMatrix& systemMatrix,
+			const std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries,
+			const std::shared_ptr<DirectLinearSolver>& solver);
+
+		/// Number of preprocessings that adopted a registered analysis
+		UInt numShared() const { return mNumShared; }
+		/// Number of registered analyses
+		UInt size() const { return static_cast<UInt>(mReferences.size()); }
+
+	private:
+		struct Reference {
+			Eigen::Index rows;
+			std::vector<Int> outer;
+			std::vector<Int> inner;
+			std::vector<std::pair<UInt, UInt>> variableEntries;
+			/// Weak reference, so that evicted solvers are not kept alive by the pool
+			std::weak_ptr<DirectLinearSolver> solver;
+		};
+
+		static std::size_t patternHash(const SparseMatrix& systemMatrix);
+		static Bool matches(const Reference& reference, const SparseMatrix& systemMatrix,
+			const std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries);
+
+		/// References keyed by the hash of their sparsity pattern
+		std::unordered_multimap<std::size_t, Reference> mReferences;
+		UInt mNumShared = 0;
+		std::mutex mMutex;
+	};
+}
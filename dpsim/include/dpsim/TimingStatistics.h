@@ -0,0 +1,85 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <dpsim/Definitions.h>
+#include <dpsim-models/Logger.h>
+
+namespace DPsim {
+	/// Streaming statistics of measured durations in seconds.
+	///
+	/// Count, mean, variance, minimum and maximum are updated incrementally.
+	/// Percentiles are estimated from a log-linear histogram of nanosecond
+	/// values (HDR histogram layout) with a relative error below 1/32 for
+	/// durations up to about 18 minutes. The histogram takes less than 5 KB,
+	/// it is allocated with the first sample and its size is fixed regardless
+	/// of the number of samples, unless the raw trace is enabled explicitly.
+	class TimingStatistics {
+	public:
+		TimingStatistics() = default;
+
+		/// Add a measured duration in seconds
+		void update(Real value);
+		/// Discard all samples, keeps the trace setting
+		void reset();
+		/// Additionally store every sample in a raw trace (unbounded memory)
+		void enableTrace(Bool enable = true);
+
+		// #### Getter ####
+		std::uint64_t count() const { return mCount; }
+		Real sum() const { return mSum; }
+		Real mean() const { return mMean; }
+		Real min() const { return mCount > 0 ? mMin : 0; }
+		Real max() const { return mCount > 0 ? mMax : 0; }
+		/// Sample variance
+		Real variance() const;
+		/// Sample standard deviation
+		Real stddev() const;
+		/// Estimated duration below which the given percentage (0 to 100) of samples lies
+		Real percentile(Real percent) const;
+		///
+		Bool hasTrace() const { return mTrace; }
+		/// Raw samples, only filled if the trace is enabled
+		const std::vector<Real>& trace() const { return mTraceValues; }
+
+		/// Write a summary of the statistics to the logger
+		void log(CPS::Logger::Log log, const String& name) const;
+
+	private:
+		/// Number of significant bits per histogram bucket
+		static constexpr UInt mSubBucketBits = 5;
+		static constexpr std::uint64_t mSubBucketCount = 1ULL << mSubBucketBits;
+		static constexpr std::uint64_t mSubBucketHalfCount = mSubBucketCount / 2;
+		/// Number of bits of the largest nanosecond value with its own bucket,
+		/// longer durations are counted in the last bucket
+		static constexpr UInt mValueBits = 40;
+		static constexpr std::uint64_t mMaxValue = (1ULL << mValueBits) - 1;
+		/// Buckets needed to cover the range of nanosecond values
+		static constexpr std::size_t mNumBuckets = (mValueBits - mSubBucketBits + 2) * mSubBucketHalfCount;
+
+		static std::size_t bucketIndex(std::uint64_t value);
+		static std::uint64_t bucketValue(std::size_t index);
+
+		std::uint64_t mCount = 0;
+		Real mSum = 0;
+		Real mMean = 0;
+		/// Sum of squared differences from the mean (Welford)
+		Real mM2 = 0;
+		Real mMin = 0;
+		Real mMax = 0;
+		/// Histogram of nanosecond values, empty until the first sample
+		std::vector<std::uint64_t> mHistogram;
+
+		Bool mTrace = false;
+		std::vector<Real> mTraceValues;
+	};
+}
@@ -0,0 +1,125 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <dpsim/BinaryResultWriter.h>
+#include <dpsim/ByteOrder.h>
+
+using namespace DPsim;
+
+namespace {
+	template<typename T>
+	void append(std::vector<char>& buffer, T value) {
+		value = littleEndian(value);
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	void appendString(std::vector<char>& buffer, const String& value) {
+		std::uint16_t length = static_cast<std::uint16_t>(std::min<std::size_t>(value.size(), UINT16_MAX));
+		append(buffer, length);
+		buffer.insert(buffer.end(), value.begin(), value.begin() + length);
+	}
+
+	std::size_t alignUp(std::size_t size, std::size_t alignment) {
+		return (size + alignment - 1) / alignment * alignment;
+	}
+}
+
+BinaryResultWriter::BinaryResultWriter(const fs::path& filename, Precision precision, UInt chunkRows) :
+	mFilename(filename),
+	mPrecision(precision),
+	mChunkRows(chunkRows > 0 ? chunkRows : 1) { }
+
+BinaryResultWriter::~BinaryResultWriter() {
+	close();
+}
+
+void BinaryResultWriter::open(const std::vector<String>& names, const std::vector<String>& units) {
+	mFile = std::ofstream(mFilename, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	if (!mFile.is_open())
+		throw CPS::SystemError("Cannot open result file " + mFilename.string());
+
+	mNumColumns = static_cast<UInt>(names.size());
+	std::uint32_t valueSize = (mPrecision == Precision::FLOAT64) ? sizeof(double) : sizeof(float);
+	std::size_t chunkSize = alignUp(sizeof(std::uint64_t) + mChunkRows * (sizeof(double) + mNumColumns * valueSize), 8);
+
+	std::vector<char> columns;
+	for (UInt column = 0; column < mNumColumns; ++column) {
+		appendString(columns, names[column]);
+		appendString(columns, column < units.size() ? units[column] : "");
+	}
+
+	std::vector<char> header;
+	header.insert(header.end(), "DPSIMBIN", "DPSIMBIN" + 8);
+	append<std::uint32_t>(header, VERSION);
+	append<std::uint32_t>(header, valueSize);
+	append<std::uint32_t>(header, mNumColumns);
+	append<std::uint32_t>(header, mChunkRows);
+	std::size_t headerSize = alignUp(header.size() + 2 * sizeof(std::uint64_t) + columns.size(), 64);
+	append<std::uint64_t>(header, headerSize);
+	append<std::uint64_t>(header, chunkSize);
+	header.insert(header.end(), columns.begin(), columns.end());
+	header.resize(headerSize, 0);
+	mFile.write(header.data(), header.size());
+	mFile.flush();
+
+	mChunk.assign(chunkSize, 0);
+	mRows = 0;
+}
+
+void BinaryResultWriter::write(Real time, const Real* values) {
+	if (!mFile.is_open())
+		return;
+
+	char* times = mChunk.data() + sizeof(std::uint64_t);
+	char* data = times + mChunkRows * sizeof(double);
+	time = littleEndian(time);
+	std::memcpy(times + mRows * sizeof(double), &time, sizeof(double));
+	if (mPrecision == Precision::FLOAT64) {
+		for (UInt column = 0; column < mNumColumns; ++column) {
+			Real value = littleEndian(values[column]);
+			std::memcpy(data + (column * mChunkRows + mRows) * sizeof(double), &value, sizeof(double));
+		}
+	}
+	else {
+		for (UInt column = 0; column < mNumColumns; ++column) {
+			float value = littleEndian(static_cast<float>(values[column]));
+			std::memcpy(data + (column * mChunkRows + mRows) * sizeof(float), &value, sizeof(float));
+		}
+	}
+
+	if (++mRows == mChunkRows)
+		writeChunk();
+}
+
+void BinaryResultWriter::writeChunk() {
+	std::uint64_t rows = littleEndian<std::uint64_t>(mRows);
+	std::memcpy(mChunk.data(), &rows, sizeof(rows));
+	mFile.write(mChunk.data(), mChunk.size());
+	mFile.flush();
+	mRows = 0;
+}
+
+void BinaryResultWriter::close() {
+	if (!mFile.is_open())
+		return;
+
+	if (mRows > 0) {
+		// the unused rows of the last chunk are not valid
+		char* times = mChunk.data() + sizeof(std::uint64_t);
+		Real nan = littleEndian(std::numeric_limits<Real>::quiet_NaN());
+		for (UInt row = mRows; row < mChunkRows; ++row)
+			std::memcpy(times + row * sizeof(double), &nan, sizeof(double));
+		writeChunk();
+	}
+	mFile.close();
+}
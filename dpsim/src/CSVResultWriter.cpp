@@ -0,0 +1,44 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <cstdio>
+#include <iomanip>
+
+#include <dpsim/CSVResultWriter.h>
+
+using namespace DPsim;
+
+void CSVResultWriter::open(const std::vector<String>& names, const std::vector<String>& units) {
+	mFile = std::ofstream(mFilename, std::ios_base::out | std::ios_base::trunc);
+	if (!mFile.is_open())
+		throw CPS::SystemError("Cannot open log file " + mFilename.string());
+
+	mNumColumns = static_cast<UInt>(names.size());
+	mFile << std::right << std::setw(14) << "time";
+	for (auto& name : names)
+		mFile << ", " << std::right << std::setw(13) << name;
+	mFile << '\n';
+}
+
+void CSVResultWriter::write(Real time, const Real* values) {
+	if (!mFile.is_open())
+		return;
+
+	// same representation as std::to_string, which is used for real attributes
+	char value[64];
+	mFile << std::scientific << std::right << std::setw(14) << time;
+	for (UInt column = 0; column < mNumColumns; ++column) {
+		std::snprintf(value, sizeof(value), "%f", values[column]);
+		mFile << ", " << std::right << std::setw(13) << value;
+	}
+	mFile << '\n';
+}
+
+void CSVResultWriter::close() {
+	mFile.close();
+}
@@ -0,0 +1,110 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <dpsim/ByteOrder.h>
+#include <dpsim/CompressedResultReader.h>
+#include <dpsim/CompressedResultWriter.h>
+#include <dpsim/FloatCodec.h>
+
+using namespace DPsim;
+
+namespace {
+	template<typename T>
+	T load(const std::vector<std::uint8_t>& data, std::size_t offset) {
+		if (offset + sizeof(T) > data.size())
+			throw CPS::SystemError("Compressed result file is truncated");
+		T value;
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		return littleEndian(value);
+	}
+
+	String loadString(const std::vector<std::uint8_t>& data, std::size_t& offset) {
+		auto length = load<std::uint16_t>(data, offset);
+		offset += sizeof(std::uint16_t);
+		if (offset + length > data.size())
+			throw CPS::SystemError("Compressed result file is truncated");
+		String value(data.begin() + offset, data.begin() + offset + length);
+		offset += length;
+		return value;
+	}
+}
+
+CompressedResultReader::CompressedResultReader(const fs::path& filename) {
+	std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
+	if (!file.is_open())
+		throw CPS::SystemError("Cannot open result file " + filename.string());
+	mData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	if (mData.size() < 32 || std::memcmp(mData.data(), "DPSIMCMP", 8) != 0
+		|| load<std::uint32_t>(mData, 8) != CompressedResultWriter::VERSION)
+		throw CPS::SystemError(filename.string() + " is not a compressed result file of version 1");
+
+	auto numColumns = load<std::uint32_t>(mData, 12);
+	auto headerSize = load<std::uint64_t>(mData, 24);
+	std::size_t offset = 32;
+	for (UInt column = 0; column < numColumns; ++column) {
+		mNames.push_back(loadString(mData, offset));
+		mUnits.push_back(loadString(mData, offset));
+	}
+
+	// a chunk that was not completely written when the simulation was aborted is ignored
+	offset = headerSize;
+	while (offset + 16 <= mData.size()) {
+		auto size = load<std::uint64_t>(mData, offset);
+		std::size_t end = offset + sizeof(std::uint64_t) + size;
+		if (end > mData.size())
+			break;
+
+		Chunk chunk;
+		chunk.rows = load<std::uint32_t>(mData, offset + 8);
+		auto numStreams = load<std::uint32_t>(mData, offset + 12);
+		if (numStreams != numColumns + 1)
+			throw CPS::SystemError("Invalid chunk in compressed result file " + filename.string());
+
+		std::size_t directory = offset + 16;
+		std::size_t position = directory + numStreams * 2 * sizeof(std::uint32_t);
+		for (UInt stream = 0; stream < numStreams; ++stream) {
+			Stream entry;
+			entry.offset = position;
+			entry.size = load<std::uint32_t>(mData, directory + stream * 2 * sizeof(std::uint32_t));
+			entry.predictor = load<std::uint32_t>(mData, directory + (stream * 2 + 1) * sizeof(std::uint32_t));
+			position += entry.size;
+			chunk.streams.push_back(entry);
+		}
+		if (position > end)
+			throw CPS::SystemError("Invalid chunk in compressed result file " + filename.string());
+
+		mRows += chunk.rows;
+		mChunks.push_back(std::move(chunk));
+		offset = end;
+	}
+}
+
+CPS::Vector CompressedResultReader::column(const String& name) const {
+	auto it = std::find(mNames.begin(), mNames.end(), name);
+	if (it == mNames.end())
+		throw CPS::SystemError("Compressed result has no column " + name);
+	return stream(static_cast<UInt>(it - mNames.begin()) + 1);
+}
+
+CPS::Vector CompressedResultReader::stream(UInt index) const {
+	CPS::Vector values(mRows);
+	UInt row = 0;
+	for (auto& chunk : mChunks) {
+		const Stream& stream = chunk.streams[index];
+		FloatCodec::decode(mData.data() + stream.offset, stream.size, chunk.rows,
+			static_cast<FloatCodec::Predictor>(stream.predictor), values.data() + row);
+		row += chunk.rows;
+	}
+	return values;
+}
@@ -0,0 +1,153 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+
+#include <dpsim/ByteOrder.h>
+#include <dpsim/CompressedResultWriter.h>
+#include <dpsim/FloatCodec.h>
+
+using namespace DPsim;
+
+namespace {
+	template<typename T>
+	void append(std::vector<std::uint8_t>& buffer, T value) {
+		value = littleEndian(value);
+		const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<typename T>
+	void store(std::vector<std::uint8_t>& buffer, std::size_t offset, T value) {
+		value = littleEndian(value);
+		std::memcpy(buffer.data() + offset, &value, sizeof(T));
+	}
+
+	void appendString(std::vector<std::uint8_t>& buffer, const String& value) {
+		std::uint16_t length = static_cast<std::uint16_t>(std::min<std::size_t>(value.size(), UINT16_MAX));
+		append(buffer, length);
+		buffer.insert(buffer.end(), value.begin(), value.begin() + length);
+	}
+}
+
+CompressedResultWriter::CompressedResultWriter(const fs::path& filename, UInt chunkRows, UInt numChunks) :
+	mFilename(filename),
+	mChunkRows(chunkRows > 0 ? chunkRows : 1),
+	mNumChunks(numChunks > 0 ? numChunks : 1),
+	mChunk(mNumChunks) { }
+
+CompressedResultWriter::~CompressedResultWriter() {
+	close();
+}
+
+void CompressedResultWriter::open(const std::vector<String>& names, const std::vector<String>& units) {
+	mFile = std::ofstream(mFilename, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	if (!mFile.is_open())
+		throw CPS::SystemError("Cannot open result file " + mFilename.string());
+
+	mNumColumns = static_cast<UInt>(names.size());
+
+	std::vector<std::uint8_t> header;
+	header.insert(header.end(), "DPSIMCMP", "DPSIMCMP" + 8);
+	append<std::uint32_t>(header, VERSION);
+	append<std::uint32_t>(header, mNumColumns);
+	append<std::uint32_t>(header, mChunkRows);
+	append<std::uint32_t>(header, 0);
+	append<std::uint64_t>(header, 0);
+	for (UInt column = 0; column < mNumColumns; ++column) {
+		appendString(header, names[column]);
+		appendString(header, column < units.size() ? units[column] : "");
+	}
+	store<std::uint64_t>(header, 24, header.size());
+	mFile.write(reinterpret_cast<const char*>(header.data()), header.size());
+	mFile.flush();
+
+	mChunks.assign(static_cast<std::size_t>(mNumChunks) * mChunkRows * (mNumColumns + 1), 0);
+	mChunkSizes.assign(mNumChunks, 0);
+	// one more entry for the stop marker
+	mFilledChunks = std::make_unique<moodycamel::BlockingReaderWriterQueue<UInt>>(mNumChunks + 1);
+	mFreeChunks = std::make_unique<moodycamel::BlockingReaderWriterQueue<UInt>>(mNumChunks);
+	for (UInt chunk = 0; chunk < mNumChunks; ++chunk)
+		mFreeChunks->enqueue(chunk);
+	mChunk = mNumChunks;
+
+	mCompressionThread = std::thread([this]() {
+		std::vector<std::uint8_t> buffer;
+		UInt chunk;
+		while (true) {
+			mFilledChunks->wait_dequeue(chunk);
+			if (chunk == mNumChunks)
+				break;
+			writeChunk(chunk, buffer);
+			mFreeChunks->enqueue(chunk);
+		}
+	});
+	mOpen = true;
+}
+
+void CompressedResultWriter::write(Real time, const Real* values) {
+	if (!mOpen)
+		return;
+
+	if (mChunk == mNumChunks) {
+		mFreeChunks->wait_dequeue(mChunk);
+		mChunkSizes[mChunk] = 0;
+	}
+
+	// columns of a chunk are contiguous, so that each is compressed in place
+	UInt row = mChunkSizes[mChunk]++;
+	Real* data = &mChunks[static_cast<std::size_t>(mChunk) * mChunkRows * (mNumColumns + 1)];
+	data[row] = time;
+	for (UInt column = 0; column < mNumColumns; ++column)
+		data[(column + 1) * mChunkRows + row] = values[column];
+
+	if (mChunkSizes[mChunk] == mChunkRows)
+		submitChunk();
+}
+
+void CompressedResultWriter::submitChunk() {
+	mFilledChunks->enqueue(mChunk);
+	mChunk = mNumChunks;
+}
+
+void CompressedResultWriter::writeChunk(UInt chunk, std::vector<std::uint8_t>& buffer) {
+	UInt rows = mChunkSizes[chunk];
+	UInt numStreams = mNumColumns + 1;
+	const Real* data = &mChunks[static_cast<std::size_t>(chunk) * mChunkRows * numStreams];
+
+	buffer.clear();
+	append<std::uint64_t>(buffer, 0);
+	append<std::uint32_t>(buffer, rows);
+	append<std::uint32_t>(buffer, numStreams);
+	std::size_t directory = buffer.size();
+	buffer.resize(directory + numStreams * 2 * sizeof(std::uint32_t));
+
+	for (UInt stream = 0; stream < numStreams; ++stream) {
+		std::size_t start = buffer.size();
+		auto predictor = FloatCodec::encodeBest(data + static_cast<std::size_t>(stream) * mChunkRows, rows, buffer);
+		store<std::uint32_t>(buffer, directory + stream * 2 * sizeof(std::uint32_t), static_cast<std::uint32_t>(buffer.size() - start));
+		store<std::uint32_t>(buffer, directory + (stream * 2 + 1) * sizeof(std::uint32_t), static_cast<std::uint32_t>(predictor));
+	}
+	store<std::uint64_t>(buffer, 0, buffer.size() - sizeof(std::uint64_t));
+
+	mFile.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+	mFile.flush();
+}
+
+void CompressedResultWriter::close() {
+	if (!mOpen)
+		return;
+	mOpen = false;
+
+	if (mChunk != mNumChunks && mChunkSizes[mChunk] > 0)
+		submitChunk();
+	mFilledChunks->enqueue(mNumChunks);
+	mCompressionThread.join();
+	mFile.close();
+}
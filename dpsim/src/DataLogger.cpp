@@ -6,9 +6,18 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  *********************************************************************************/
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
+#include <limits>
 
 #include <dpsim/DataLogger.h>
+#include <dpsim/BinaryResultWriter.h>
+#include <dpsim/CSVResultWriter.h>
+#include <dpsim/CompressedResultWriter.h>
+#include <dpsim/RingBufferResultWriter.h>
 #include <dpsim-models/Logger.h>
 
 using namespace DPsim;
@@ -16,18 +25,34 @@ using namespace DPsim;
 DataLogger::DataLogger(Bool enabled) :
 	mLogFile(),
 	mEnabled(enabled),
-	mDownsampling(1) {
+	mDownsampling(1),
+	mFormat(Format::CSV),
+	mOverflows(0) {
 	mLogFile.setstate(std::ios_base::badbit);
 }
 
-DataLogger::DataLogger(String name, Bool enabled, UInt downsampling) :
+DataLogger::DataLogger(String name, Bool enabled, UInt downsampling, Format format) :
 	mName(name),
 	mEnabled(enabled),
-	mDownsampling(downsampling) {
+	mDownsampling(downsampling),
+	mFormat(format),
+	mOverflows(0) {
 	if (!mEnabled)
 		return;
 
-	mFilename = CPS::Logger::logDir() + "/" + name + ".csv";
+	const char* extension = ".bin";
+	if (mFormat == Format::CSV)
+		extension = ".csv";
+	else if (mFormat == Format::COMPRESSED)
+		extension = ".dpz";
+	else if (mFormat == Format::RING_BUFFER)
+		extension = ".ring";
+
+	// ring buffers are placed in memory if possible
+	if (mFormat == Format::RING_BUFFER && fs::exists("/dev/shm"))
+		mFilename = "/dev/shm/" + name + extension;
+	else
+		mFilename = CPS::Logger::logDir() + "/" + name + extension;
 
 	if (mFilename.has_parent_path() && !fs::exists(mFilename.parent_path()))
 		fs::create_directory(mFilename.parent_path());
@@ -35,7 +60,17 @@ DataLogger::DataLogger(String name, Bool enabled, UInt downsampling) :
 	open();
 }
 
+DataLogger::~DataLogger() {
+	stopWriterThread();
+}
+
 void DataLogger::open() {
+	if (mFormat != Format::CSV || mAsync || mCapture != Capture::ALL) {
+		// the file is created when the columns are known
+		createWriter();
+		return;
+	}
+
 	mLogFile = std::ofstream(mFilename, std::ios_base::out|std::ios_base::trunc);
 	if (!mLogFile.is_open()) {
 		// TODO: replace by exception
@@ -45,10 +80,453 @@ void DataLogger::open() {
 }
 
 void DataLogger::close() {
+	if (mWriter && mWriterOpen)
+		flushCapture();
+	stopWriterThread();
+	if (mWriter && mWriterOpen)
+		mWriter->close();
+	// rows logged after closing are ignored like for a closed CSV file
+	mWriter.reset();
+	mWriterOpen = false;
 	mLogFile.close();
+
+	if (mOverflow == Overflow::COUNT && mOverflows > 0)
+		std::cerr << "Logger " << mName << " discarded " << mOverflows << " rows" << std::endl;
+}
+
+void DataLogger::createWriter() {
+	if (mFormat == Format::CSV) {
+		mWriter = std::make_shared<CSVResultWriter>(mFilename);
+	}
+	else if (mFormat == Format::COMPRESSED) {
+		mWriter = std::make_shared<CompressedResultWriter>(mFilename);
+	}
+	else if (mFormat == Format::RING_BUFFER) {
+		mWriter = std::make_shared<RingBufferResultWriter>(mFilename, mRingBufferRows);
+	}
+	else {
+		auto precision = (mFormat == Format::BINARY_FLOAT64) ?
+			BinaryResultWriter::Precision::FLOAT64 : BinaryResultWriter::Precision::FLOAT32;
+		mWriter = std::make_shared<BinaryResultWriter>(mFilename, precision);
+	}
+	mWriterOpen = false;
+}
+
+void DataLogger::setAsync(Bool async, UInt capacity, Overflow overflow) {
+	stopWriterThread();
+	mAsync = async;
+	mAsyncCapacity = capacity > 0 ? capacity : 1;
+	mOverflow = overflow;
+	if (mEnabled)
+		reopen();
+}
+
+void DataLogger::setRingBufferRows(UInt rows) {
+	mRingBufferRows = rows > 0 ? rows : 1;
+	if (mEnabled && mFormat == Format::RING_BUFFER)
+		reopen();
+}
+
+void DataLogger::startWriterThread() {
+	UInt stride = mWriterColumns + 1;
+	mSlots.assign(static_cast<std::size_t>(mAsyncCapacity) * stride, 0);
+	// one more entry for the stop marker
+	mFilledSlots = std::make_unique<moodycamel::BlockingReaderWriterQueue<UInt>>(mAsyncCapacity + 1);
+	mFreeSlots = std::make_unique<moodycamel::BlockingReaderWriterQueue<UInt>>(mAsyncCapacity);
+	for (UInt slot = 0; slot < mAsyncCapacity; ++slot)
+		mFreeSlots->enqueue(slot);
+	mOverflows = 0;
+
+	mWriterThread = std::thread([this, stride]() {
+		UInt slot;
+		while (true) {
+			mFilledSlots->wait_dequeue(slot);
+			if (slot == mAsyncCapacity)
+				break;
+			const Real* row = &mSlots[static_cast<std::size_t>(slot) * stride];
+			mWriter->write(row[0], row + 1);
+			mFreeSlots->enqueue(slot);
+		}
+	});
+}
+
+void DataLogger::stopWriterThread() {
+	if (!mWriterThread.joinable())
+		return;
+
+	mFilledSlots->enqueue(mAsyncCapacity);
+	mWriterThread.join();
+}
+
+void DataLogger::enqueueRow(Real time, const Real* values) {
+	UInt slot;
+	if (!mFreeSlots->try_dequeue(slot)) {
+		if (mOverflow != Overflow::BLOCK) {
+			++mOverflows;
+			return;
+		}
+		mFreeSlots->wait_dequeue(slot);
+	}
+
+	Real* row = &mSlots[static_cast<std::size_t>(slot) * (mWriterColumns + 1)];
+	row[0] = time;
+	if (values)
+		std::memcpy(row + 1, values, mWriterColumns * sizeof(Real));
+	else
+		gatherRow(row + 1, mWriterColumns);
+	mFilledSlots->enqueue(slot);
+}
+
+void DataLogger::writeRow(Real time, const Real* values) {
+	if (!mAsync) {
+		mWriter->write(time, values);
+		return;
+	}
+	if (!mWriterThread.joinable())
+		startWriterThread();
+	enqueueRow(time, values);
+}
+
+void DataLogger::setCapture(Capture capture) {
+	mCapture = capture;
+	if (mEnabled)
+		reopen();
+}
+
+void DataLogger::setEnvelope(UInt window) {
+	mEnvelopeWindow = window > 0 ? window : 1;
+	setCapture(Capture::ENVELOPE);
+}
+
+void DataLogger::setTrigger(const String& column, Trigger condition, Real threshold, UInt preTrigger, UInt postTrigger) {
+	mTriggerColumn = column;
+	mTrigger = condition;
+	mTriggerThreshold = threshold;
+	mPreTrigger = preTrigger;
+	mPostTrigger = postTrigger;
+	setCapture(Capture::TRIGGER);
+}
+
+void DataLogger::setDeadband(Real tolerance) {
+	mDeadband = tolerance;
+	setCapture(Capture::DEADBAND);
+}
+
+void DataLogger::setDeadband(const String& name, Real tolerance) {
+	mDeadbands[name] = tolerance;
+	setCapture(Capture::DEADBAND);
+}
+
+Bool DataLogger::matchesColumn(const String& prefix, const String& name) {
+	return name == prefix || (name.compare(0, prefix.size(), prefix) == 0 && name.size() > prefix.size()
+		&& (name[prefix.size()] == '_' || name[prefix.size()] == '.'));
+}
+
+std::vector<String> DataLogger::captureNames() const {
+	if (mCapture != Capture::ENVELOPE)
+		return columnNames();
+
+	std::vector<String> names;
+	for (auto& column : mColumns) {
+		names.push_back(column.first + ".min");
+		names.push_back(column.first + ".max");
+		names.push_back(column.first + ".mean");
+	}
+	return names;
+}
+
+void DataLogger::startCapture() {
+	std::size_t numColumns = mPlan.size();
+	mCaptured = 0;
+	mCapturePending = false;
+
+	switch (mCapture) {
+	case Capture::ENVELOPE:
+		mEnvelope.assign(3 * numColumns, 0);
+		mCaptureRow.assign(3 * numColumns, 0);
+		break;
+	case Capture::TRIGGER: {
+		auto column = mColumns.find(mTriggerColumn);
+		if (column == mColumns.end()) {
+			std::cerr << "Trigger column " << mTriggerColumn << " of logger " << mName << " is not logged" << std::endl;
+			mEnabled = false;
+			return;
+		}
+		mTriggerIndex = static_cast<UInt>(std::distance(mColumns.begin(), column));
+		mTriggerLast = std::numeric_limits<Real>::quiet_NaN();
+		mPostRemaining = 0;
+		mHistory.assign(static_cast<std::size_t>(mPreTrigger) * (numColumns + 1), 0);
+		mHistoryStart = 0;
+		mHistorySize = 0;
+		break;
+	}
+	case Capture::DEADBAND:
+		mCaptureRow.assign(numColumns, 0);
+		mTolerances.clear();
+		for (auto& column : mColumns) {
+			// the longest matching name is the most specific one
+			Real tolerance = mDeadband;
+			std::size_t matched = 0;
+			for (auto& entry : mDeadbands) {
+				if (matchesColumn(entry.first, column.first) && entry.first.size() >= matched) {
+					tolerance = entry.second;
+					matched = entry.first.size();
+				}
+			}
+			mTolerances.push_back(tolerance);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void DataLogger::captureRow(Real time) {
+	std::size_t numColumns = mPlan.size();
+
+	switch (mCapture) {
+	case Capture::ENVELOPE:
+		if (mCaptured == 0) {
+			mCaptureTime = time;
+			for (std::size_t i = 0; i < numColumns; ++i) {
+				mEnvelope[3 * i] = mRow[i];
+				mEnvelope[3 * i + 1] = mRow[i];
+				mEnvelope[3 * i + 2] = mRow[i];
+			}
+		} else {
+			for (std::size_t i = 0; i < numColumns; ++i) {
+				if (mRow[i] < mEnvelope[3 * i])
+					mEnvelope[3 * i] = mRow[i];
+				if (mRow[i] > mEnvelope[3 * i + 1])
+					mEnvelope[3 * i + 1] = mRow[i];
+				mEnvelope[3 * i + 2] += mRow[i];
+			}
+		}
+		if (++mCaptured == mEnvelopeWindow)
+			flushCapture();
+		break;
+
+	case Capture::TRIGGER: {
+		Real value = mRow[mTriggerIndex];
+		Bool fired;
+		if (mTrigger == Trigger::ABOVE)
+			fired = value > mTriggerThreshold;
+		else if (mTrigger == Trigger::BELOW)
+			fired = value < mTriggerThreshold;
+		else
+			fired = std::abs(value - mTriggerLast) > mTriggerThreshold;
+		mTriggerLast = value;
+
+		if (fired) {
+			// rows before the trigger, oldest first
+			std::size_t stride = numColumns + 1;
+			for (UInt k = 0; k < mHistorySize; ++k) {
+				const Real* row = &mHistory[((mHistoryStart + k) % mPreTrigger) * stride];
+				writeRow(row[0], row + 1);
+			}
+			mHistorySize = 0;
+			mPostRemaining = mPostTrigger;
+			writeRow(time, mRow.data());
+		} else if (mPostRemaining > 0) {
+			--mPostRemaining;
+			writeRow(time, mRow.data());
+		} else if (mPreTrigger > 0) {
+			std::size_t stride = numColumns + 1;
+			UInt slot = (mHistoryStart + mHistorySize) % mPreTrigger;
+			if (mHistorySize == mPreTrigger)
+				mHistoryStart = (mHistoryStart + 1) % mPreTrigger;
+			else
+				++mHistorySize;
+			Real* row = &mHistory[slot * stride];
+			row[0] = time;
+			std::copy(mRow.begin(), mRow.begin() + numColumns, row + 1);
+		}
+		break;
+	}
+
+	case Capture::DEADBAND: {
+		Bool changed = mCaptured == 0;
+		for (std::size_t i = 0; i < numColumns && !changed; ++i) {
+			changed = std::abs(mRow[i] - mCaptureRow[i]) > mTolerances[i]
+				|| std::isnan(mRow[i]) != std::isnan(mCaptureRow[i]);
+		}
+		if (changed) {
+			std::copy(mRow.begin(), mRow.begin() + numColumns, mCaptureRow.begin());
+			writeRow(time, mCaptureRow.data());
+			mCaptured = 1;
+			mCapturePending = false;
+		} else {
+			// mRow keeps the values of the skipped row until the next one
+			mCaptureTime = time;
+			mCapturePending = true;
+		}
+		break;
+	}
+
+	default:
+		writeRow(time, mRow.data());
+	}
+}
+
+void DataLogger::flushCapture() {
+	if (mCapture == Capture::ENVELOPE && mCaptured > 0) {
+		for (std::size_t i = 0; i < mPlan.size(); ++i) {
+			mCaptureRow[3 * i] = mEnvelope[3 * i];
+			mCaptureRow[3 * i + 1] = mEnvelope[3 * i + 1];
+			mCaptureRow[3 * i + 2] = mEnvelope[3 * i + 2] / mCaptured;
+		}
+		writeRow(mCaptureTime, mCaptureRow.data());
+		mCaptured = 0;
+	}
+	else if (mCapture == Capture::DEADBAND && mCapturePending) {
+		writeRow(mCaptureTime, mRow.data());
+		mCapturePending = false;
+	}
+}
+
+Bool DataLogger::headerPending() {
+	if (mWriter)
+		return !mWriterOpen;
+	return mLogFile.tellp() == std::ofstream::pos_type(0);
+}
+
+void DataLogger::openWriter(const std::vector<String>& names) {
+	// a unit set for an attribute applies to all columns derived from it
+	std::vector<String> units;
+	for (auto& name : names) {
+		String unit;
+		for (auto& entry : mUnits) {
+			if (matchesColumn(entry.first, name))
+				unit = entry.second;
+		}
+		units.push_back(unit);
+	}
+
+	try {
+		mWriter->open(names, units);
+	} catch (const CPS::SystemError& e) {
+		std::cerr << e.descr() << std::endl;
+		mEnabled = false;
+		return;
+	}
+	mRow.resize(std::max(mRow.size(), names.size()));
+	mWriterColumns = static_cast<UInt>(names.size());
+	mWriterOpen = true;
+}
+
+void DataLogger::addColumn(const String& name, CPS::AttributeBase::Ptr attr, UInt row, UInt col, UInt part) {
+	auto index = mAttributeIndex.find(attr.get());
+	if (index == mAttributeIndex.end()) {
+		using Type = LoggedAttribute::Type;
+		Type type = Type::OTHER;
+		if (std::dynamic_pointer_cast<CPS::Attribute<Real>>(attr.getPtr()))
+			type = Type::REAL;
+		else if (std::dynamic_pointer_cast<CPS::Attribute<Complex>>(attr.getPtr()))
+			type = Type::COMPLEX;
+		else if (std::dynamic_pointer_cast<CPS::Attribute<Matrix>>(attr.getPtr()))
+			type = Type::MATRIX;
+		else if (std::dynamic_pointer_cast<CPS::Attribute<MatrixComp>>(attr.getPtr()))
+			type = Type::MATRIX_COMP;
+		else if (std::dynamic_pointer_cast<CPS::Attribute<Int>>(attr.getPtr()))
+			type = Type::INT;
+		else if (std::dynamic_pointer_cast<CPS::Attribute<UInt>>(attr.getPtr()))
+			type = Type::UINT;
+		else if (std::dynamic_pointer_cast<CPS::Attribute<Bool>>(attr.getPtr()))
+			type = Type::BOOL;
+
+		index = mAttributeIndex.emplace(attr.get(), static_cast<UInt>(mLoggedAttributes.size())).first;
+		mLoggedAttributes.push_back({ attr, type });
+	}
+
+	mColumns[name] = { index->second, row, col, part };
+	mPlanValid = false;
+}
+
+void DataLogger::compilePlan() {
+	mPlan.clear();
+	for (auto& column : mColumns)
+		mPlan.push_back(column.second);
+	mViews.assign(mLoggedAttributes.size(), AttributeView());
+	mRow.resize(std::max(mRow.size(), mPlan.size()));
+	mPlanValid = true;
+}
+
+std::vector<String> DataLogger::columnNames() const {
+	std::vector<String> names;
+	for (auto& column : mColumns)
+		names.push_back(column.first);
+	return names;
+}
+
+void DataLogger::gatherRow(Real* row, UInt size) {
+	using Type = LoggedAttribute::Type;
+
+	// resolve each attribute once, this also updates dynamic attributes
+	for (std::size_t i = 0; i < mLoggedAttributes.size(); ++i) {
+		CPS::AttributeBase* attr = mLoggedAttributes[i].attribute.get();
+		AttributeView& view = mViews[i];
+		view.data = &view.converted;
+		view.rows = 1;
+		view.cols = 1;
+		view.width = 1;
+
+		switch (mLoggedAttributes[i].type) {
+		case Type::REAL:
+			view.data = &static_cast<CPS::Attribute<Real>*>(attr)->get();
+			break;
+		case Type::COMPLEX:
+			view.data = reinterpret_cast<const Real*>(&static_cast<CPS::Attribute<Complex>*>(attr)->get());
+			view.width = 2;
+			break;
+		case Type::MATRIX: {
+			const Matrix& matrix = static_cast<CPS::Attribute<Matrix>*>(attr)->get();
+			view.data = matrix.data();
+			view.rows = matrix.rows();
+			view.cols = matrix.cols();
+			break;
+		}
+		case Type::MATRIX_COMP: {
+			const MatrixComp& matrix = static_cast<CPS::Attribute<MatrixComp>*>(attr)->get();
+			view.data = reinterpret_cast<const Real*>(matrix.data());
+			view.rows = matrix.rows();
+			view.cols = matrix.cols();
+			view.width = 2;
+			break;
+		}
+		case Type::INT:
+			view.converted = static_cast<CPS::Attribute<Int>*>(attr)->get();
+			break;
+		case Type::UINT:
+			view.converted = static_cast<CPS::Attribute<UInt>*>(attr)->get();
+			break;
+		case Type::BOOL:
+			view.converted = static_cast<CPS::Attribute<Bool>*>(attr)->get();
+			break;
+		default:
+			view.converted = std::numeric_limits<Real>::quiet_NaN();
+		}
+	}
+
+	// coefficients outside of a resized matrix are logged as NaN
+	std::size_t count = std::min<std::size_t>(size, mPlan.size());
+	for (std::size_t i = 0; i < count; ++i) {
+		const LoggedColumn& column = mPlan[i];
+		const AttributeView& view = mViews[column.attribute];
+		if (!view.data || column.row >= view.rows || column.col >= view.cols) {
+			row[i] = std::numeric_limits<Real>::quiet_NaN();
+			continue;
+		}
+		row[i] = view.data[(column.row + column.col * view.rows) * view.width + column.part];
+	}
 }
 
 void DataLogger::setColumnNames(std::vector<String> names) {
+	if (mWriter) {
+		if (!mWriterOpen)
+			openWriter(names);
+		return;
+	}
+
 	if (mLogFile.tellp() == std::ofstream::pos_type(0)) {
 		mLogFile << std::right << std::setw(14) << "time";
 		for (auto name : names) {
@@ -62,6 +540,12 @@ void DataLogger::logDataLine(Real time, Real data) {
 	if (!mEnabled)
 		return;
 
+	if (mWriter) {
+		if (mWriterOpen)
+			mWriter->write(time, &data);
+		return;
+	}
+
 	mLogFile << std::scientific << std::right << std::setw(14) << time;
 	mLogFile << ", " << std::right << std::setw(13) << data;
 	mLogFile << '\n';
@@ -71,6 +555,12 @@ void DataLogger::logDataLine(Real time, const Matrix& data) {
 	if (!mEnabled)
 		return;
 
+	if (mWriter) {
+		if (mWriterOpen)
+			mWriter->write(time, data.data());
+		return;
+	}
+
 	mLogFile << std::scientific << std::right << std::setw(14) << time;
 	for (Int i = 0; i < data.rows(); ++i) {
 		mLogFile << ", " << std::right << std::setw(13) << data(i, 0);
@@ -81,6 +571,19 @@ void DataLogger::logDataLine(Real time, const Matrix& data) {
 void DataLogger::logDataLine(Real time, const MatrixComp& data) {
 	if (!mEnabled)
 		return;
+
+	// the binary formats store the real and imaginary part of each row as two columns
+	if (mWriter) {
+		if (mWriterOpen) {
+			for (Int i = 0; i < data.rows() && 2 * i + 1 < static_cast<Int>(mRow.size()); ++i) {
+				mRow[2 * i] = data(i, 0).real();
+				mRow[2 * i + 1] = data(i, 0).imag();
+			}
+			mWriter->write(time, mRow.data());
+		}
+		return;
+	}
+
 	mLogFile << std::scientific << std::right << std::setw(14) << time;
 	for (Int i = 0; i < data.rows(); ++i) {
 		mLogFile << ", " << std::right << std::setw(13) << data(i, 0);
@@ -89,7 +592,7 @@ void DataLogger::logDataLine(Real time, const MatrixComp& data) {
 }
 
 void DataLogger::logPhasorNodeValues(Real time, const Matrix& data, Int freqNum) {
-	if (mLogFile.tellp() == std::ofstream::pos_type(0)) {
+	if (headerPending()) {
 		std::vector<String> names;
 
 		Int harmonicOffset = data.rows() / freqNum;
@@ -115,7 +618,7 @@ void DataLogger::logPhasorNodeValues(Real time, const Matrix& data, Int freqNum)
 }
 
 void DataLogger::logEMTNodeValues(Real time, const Matrix& data) {
-	if (mLogFile.tellp() == std::ofstream::pos_type(0)) {
+	if (headerPending()) {
 		std::vector<String> names;
 		for (Int i = 0; i < data.rows(); ++i) {
 			std::stringstream name;
@@ -131,16 +634,60 @@ void DataLogger::log(Real time, Int timeStepCount) {
 	if (!mEnabled || !(timeStepCount % mDownsampling == 0))
 		return;
 
+	if (!mPlanValid)
+		compilePlan();
+
+	if (mWriter) {
+		if (!mWriterOpen) {
+			openWriter(captureNames());
+			if (!mWriterOpen)
+				return;
+			startCapture();
+			if (!mEnabled)
+				return;
+		}
+		if (mCapture == Capture::ALL && mAsync) {
+			if (!mWriterThread.joinable())
+				startWriterThread();
+			enqueueRow(time);
+			return;
+		}
+
+		gatherRow(mRow.data(), static_cast<UInt>(mPlan.size()));
+		if (mCapture == Capture::ALL)
+			mWriter->write(time, mRow.data());
+		else
+			captureRow(time);
+		return;
+	}
+
 	if (mLogFile.tellp() == std::ofstream::pos_type(0)) {
 		mLogFile << std::right << std::setw(14) << "time";
-		for (auto it : mAttributes)
-			mLogFile << ", " << std::right << std::setw(13) << it.first;
+		for (auto& column : mColumns)
+			mLogFile << ", " << std::right << std::setw(13) << column.first;
 		mLogFile << '\n';
 	}
 
+	gatherRow(mRow.data(), static_cast<UInt>(mRow.size()));
+
+	// same formatting as the string conversion of real attributes
+	char value[32];
 	mLogFile << std::scientific << std::right << std::setw(14) << time;
-	for (auto it : mAttributes)
-		mLogFile << ", " << std::right << std::setw(13) << it.second->toString();
+	for (std::size_t i = 0; i < mPlan.size(); ++i) {
+		auto& attr = mLoggedAttributes[mPlan[i].attribute];
+		mLogFile << ", " << std::right << std::setw(13);
+		switch (attr.type) {
+		case LoggedAttribute::Type::INT:
+		case LoggedAttribute::Type::UINT:
+		case LoggedAttribute::Type::BOOL:
+		case LoggedAttribute::Type::OTHER:
+			mLogFile << attr.attribute->toString();
+			break;
+		default:
+			std::snprintf(value, sizeof(value), "%f", mRow[i]);
+			mLogFile << value;
+		}
+	}
 	mLogFile << '\n';
 }
 
@@ -154,90 +701,56 @@ CPS::Task::Ptr DataLogger::getTask() {
 
 void DataLogger::logAttribute(const std::vector<String> &name, CPS::AttributeBase::Ptr attr) {
 	if (auto attrMatrix = std::dynamic_pointer_cast<CPS::Attribute<Matrix>>(attr.getPtr())) {
-		if ((**attrMatrix).rows() == 1 && (**attrMatrix).cols() == 1) {
-			logAttribute(name[0], attrMatrix->deriveCoeff<CPS::Real>(0, 0));
-		}
-		else if ((**attrMatrix).cols() == 1) {
-			for (UInt k = 0; k < (**attrMatrix).rows(); ++k) {
-				logAttribute(name[k],
-					attrMatrix->deriveCoeff<CPS::Real>(k, 0));
-			}
-		}
-		else {
-			for (UInt k = 0; k < (**attrMatrix).rows(); ++k) {
-				for (UInt l = 0; l < (**attrMatrix).cols(); ++l) {
-					logAttribute(name[k*(**attrMatrix).cols()+l],
-						attrMatrix->deriveCoeff<CPS::Real>(k, l));
-				}
-			}
+		UInt rows = static_cast<UInt>((**attrMatrix).rows());
+		UInt cols = static_cast<UInt>((**attrMatrix).cols());
+		for (UInt k = 0; k < rows; ++k) {
+			for (UInt l = 0; l < cols; ++l)
+				addColumn(name[k * cols + l], attr, k, l);
 		}
 	} else if (auto attrMatrix = std::dynamic_pointer_cast<CPS::Attribute<MatrixComp>>(attr.getPtr())) {
-		if ((**attrMatrix).rows() == 1 && (**attrMatrix).cols() == 1) {
-			logAttribute(name[0], attrMatrix->deriveCoeff<CPS::Complex>(0, 0));
-		}
-		else if ((**attrMatrix).cols() == 1) {
-			for (UInt k = 0; k < (**attrMatrix).rows(); ++k) {
-				logAttribute(name[k],
-					attrMatrix->deriveCoeff<CPS::Complex>(k, 0));
-			}
-		}
-		else {
-			for (UInt k = 0; k < (**attrMatrix).rows(); ++k) {
-				for (UInt l = 0; l < (**attrMatrix).cols(); ++l) {
-					logAttribute(name[k*(**attrMatrix).cols()+l],
-						attrMatrix->deriveCoeff<CPS::Complex>(k, l));
-				}
+		UInt rows = static_cast<UInt>((**attrMatrix).rows());
+		UInt cols = static_cast<UInt>((**attrMatrix).cols());
+		for (UInt k = 0; k < rows; ++k) {
+			for (UInt l = 0; l < cols; ++l) {
+				addColumn(name[k * cols + l] + ".re", attr, k, l, 0);
+				addColumn(name[k * cols + l] + ".im", attr, k, l, 1);
 			}
 		}
-	}	
+	}
 }
 
 void DataLogger::logAttribute(const String &name, CPS::AttributeBase::Ptr attr, UInt rowsMax, UInt colsMax) {
-	if (auto attrReal = std::dynamic_pointer_cast<CPS::Attribute<Real>>(attr.getPtr())) {
-		mAttributes[name] = attrReal;
-	} else if (auto attrComp = std::dynamic_pointer_cast<CPS::Attribute<Complex>>(attr.getPtr())) {
-		mAttributes[name + ".re"] = attrComp->deriveReal();
-		mAttributes[name + ".im"] = attrComp->deriveImag();
+	// columns refer to the coefficients of the attribute instead of derived attributes,
+	// so that each row reads every attribute only once
+	Bool isComplex = false;
+	UInt rows = 1, cols = 1;
+	if (std::dynamic_pointer_cast<CPS::Attribute<Complex>>(attr.getPtr())) {
+		isComplex = true;
 	} else if (auto attrMatrix = std::dynamic_pointer_cast<CPS::Attribute<Matrix>>(attr.getPtr())) {
-		UInt rows = static_cast<UInt>((**attrMatrix).rows());
-		UInt cols = static_cast<UInt>((**attrMatrix).cols());
-		if (rowsMax == 0 || rowsMax > rows) rowsMax = rows;
-		if (colsMax == 0 || colsMax > cols) colsMax = cols;
-		if (rows == 1 && cols == 1) {
-			mAttributes[name] = attrMatrix->deriveCoeff<Real>(0,0);
-		} else if (cols == 1) {
-			for (UInt k = 0; k < rowsMax; ++k) {
-				mAttributes[name + "_" + std::to_string(k)] = attrMatrix->deriveCoeff<Real>(k,0);
-			}
-		} else {
-			for (UInt k = 0; k < rowsMax; ++k) {
-				for (UInt l = 0; l < colsMax; ++l) {
-					mAttributes[name + "_" + std::to_string(k) + "_" + std::to_string(l)] = attrMatrix->deriveCoeff<Real>(k,l);
-				}
-			}
-		}
+		rows = static_cast<UInt>((**attrMatrix).rows());
+		cols = static_cast<UInt>((**attrMatrix).cols());
 	} else if (auto attrMatrix = std::dynamic_pointer_cast<CPS::Attribute<MatrixComp>>(attr.getPtr())) {
-		UInt rows = static_cast<UInt>((**attrMatrix).rows());
-		UInt cols = static_cast<UInt>((**attrMatrix).cols());
-		if (rowsMax == 0 || rowsMax > rows) rowsMax = rows;
-		if (colsMax == 0 || colsMax > cols) colsMax = cols;
-		if (rows == 1 && cols == 1) {
-			mAttributes[name + ".re"] = attrMatrix->deriveCoeff<Complex>(0,0)->deriveReal();
-			mAttributes[name + ".im"] = attrMatrix->deriveCoeff<Complex>(0,0)->deriveImag();
-		} else if (cols == 1) {
-			for (UInt k = 0; k < rowsMax; ++k) {
-				mAttributes[name + "_" + std::to_string(k) + ".re"] = attrMatrix->deriveCoeff<Complex>(k,0)->deriveReal();
-				mAttributes[name + "_" + std::to_string(k) + ".im"] = attrMatrix->deriveCoeff<Complex>(k,0)->deriveImag();
-			}
-		} else {
-			for (UInt k = 0; k < rowsMax; ++k) {
-				for (UInt l = 0; l < colsMax; ++l) {
-					mAttributes[name + "_" + std::to_string(k) + "_" + std::to_string(l) + ".re"] = attrMatrix->deriveCoeff<Complex>(k,l)->deriveReal();
-					mAttributes[name + "_" + std::to_string(k) + "_" + std::to_string(l) + ".im"] = attrMatrix->deriveCoeff<Complex>(k,l)->deriveImag();
-				}
+		rows = static_cast<UInt>((**attrMatrix).rows());
+		cols = static_cast<UInt>((**attrMatrix).cols());
+		isComplex = true;
+	}
+	if (rowsMax == 0 || rowsMax > rows) rowsMax = rows;
+	if (colsMax == 0 || colsMax > cols) colsMax = cols;
+
+	for (UInt k = 0; k < rowsMax; ++k) {
+		for (UInt l = 0; l < colsMax; ++l) {
+			String columnName = name;
+			if (cols > 1)
+				columnName += "_" + std::to_string(k) + "_" + std::to_string(l);
+			else if (rows > 1)
+				columnName += "_" + std::to_string(k);
+
+			if (isComplex) {
+				addColumn(columnName + ".re", attr, k, l, 0);
+				addColumn(columnName + ".im", attr, k, l, 1);
+			} else {
+				addColumn(columnName, attr, k, l);
 			}
 		}
-	} else {
-		mAttributes[name] = attr;
 	}
 }
@@ -41,4 +41,18 @@ namespace DPsim
     {
         return LUFactorized.solve(mRightHandSideVector);
     }
+
+    void DenseLUAdapter::solve(const Matrix& rightSideVector, Matrix& leftSideVector)
+    {
+        /* the solution is evaluated column by column directly into the preallocated vector,
+         * the triangular solves for a whole matrix would allocate blocking buffers on the heap */
+        leftSideVector.resize(rightSideVector.rows(), rightSideVector.cols());
+        for (Eigen::Index col = 0; col < rightSideVector.cols(); ++col)
+            leftSideVector.col(col) = LUFactorized.solve(rightSideVector.col(col));
+    }
+
+    std::size_t DenseLUAdapter::factorizationMemory() const
+    {
+        return static_cast<std::size_t>(LUFactorized.matrixLU().size()) * sizeof(Real);
+    }
 }
@@ -221,6 +221,7 @@ void DiakopticsSolver<VarType>::createMatrices() {
 		// copy the solution there
 		net.leftVector = AttributeStatic<Matrix>::make();
 		net.leftVector->set(Matrix::Zero(net.sysSize, 1));
+		net.tearSolution = Matrix::Zero(net.sysSize, 1);
 	}
 
 	createTearMatrices(totalSize);
@@ -386,11 +387,12 @@ void DiakopticsSolver<VarType>::PreSolveTask::execute(Real time, Int timeStepCou
 		tComp->mnaTearApplyVoltageStamp(mSolver.mTearVoltages);
 	}
 	// -C^T * v'
-	mSolver.mTearVoltages -= mSolver.mTearTopology.transpose() * **mSolver.mOrigLeftSideVector;
+	mSolver.mTearVoltages.noalias() -= mSolver.mTearTopology.transpose() * **mSolver.mOrigLeftSideVector;
 	// Solve Z' * i = E - C^T * v'
+	// The solution is evaluated directly into the preallocated vector
 	mSolver.mTearCurrents = mSolver.mTotalTearImpedance.solve(mSolver.mTearVoltages);
 	// C * i
-	**mSolver.mMappedTearCurrents = mSolver.mTearTopology * mSolver.mTearCurrents;
+	(**mSolver.mMappedTearCurrents).noalias() = mSolver.mTearTopology * mSolver.mTearCurrents;
 	mSolver.mLeftSideVector = **mSolver.mOrigLeftSideVector;
 }
 
@@ -400,14 +402,15 @@ void DiakopticsSolver<VarType>::SolveTask::execute(Real time, Int timeStepCount)
 	auto rBlock = (**mSolver.mMappedTearCurrents).block(mSubnet.sysOff, 0, mSubnet.sysSize, 1);
 	// Solve Y' * x = C * i
 	// v = v' + x
-	lBlock += mSubnet.luFactorization.solve(rBlock);
+	mSubnet.tearSolution = mSubnet.luFactorization.solve(rBlock);
+	lBlock += mSubnet.tearSolution;
 	**mSubnet.leftVector = lBlock;
 }
 
 template <typename VarType>
 void DiakopticsSolver<VarType>::PostSolveTask::execute(Real time, Int timeStepCount) {
 	// pass the voltages and current of the solution to the torn components
-	mSolver.mTearVoltages = -mSolver.mTearTopology.transpose() * mSolver.mLeftSideVector;
+	mSolver.mTearVoltages.noalias() = -mSolver.mTearTopology.transpose() * mSolver.mLeftSideVector;
 	for (UInt compIdx = 0; compIdx < mSolver.mTearComponents.size(); ++compIdx) {
 		auto comp = mSolver.mTearComponents[compIdx];
 		auto tComp = std::dynamic_pointer_cast<MNATearInterface>(comp);
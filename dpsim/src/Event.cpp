@@ -15,6 +15,17 @@ void EventQueue::addEvent(Event::Ptr e) {
 	mEvents.push(e);
 }
 
+std::vector<Event::Ptr> EventQueue::pendingEvents() const {
+	std::vector<Event::Ptr> events;
+	auto queue = mEvents;
+
+	while (!queue.empty()) {
+		events.push_back(queue.top());
+		queue.pop();
+	}
+	return events;
+}
+
 void EventQueue::handleEvents(Real currentTime) {
 	Event::Ptr e;
 
@@ -0,0 +1,190 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <dpsim/FloatCodec.h>
+
+using namespace DPsim;
+
+namespace {
+	std::uint64_t toBits(Real value) {
+		std::uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	Real fromBits(std::uint64_t bits) {
+		Real value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	UInt leadingZeros(std::uint64_t value) {
+#if defined(__GNUC__)
+		return static_cast<UInt>(__builtin_clzll(value));
+#else
+		UInt count = 0;
+		for (std::uint64_t mask = 1ull << 63; !(value & mask); mask >>= 1)
+			++count;
+		return count;
+#endif
+	}
+
+	UInt trailingZeros(std::uint64_t value) {
+#if defined(__GNUC__)
+		return static_cast<UInt>(__builtin_ctzll(value));
+#else
+		UInt count = 0;
+		for (; !(value & 1); value >>= 1)
+			++count;
+		return count;
+#endif
+	}
+
+	/// Prediction of values[index] from the previous values, identical for encoding and decoding
+	std::uint64_t predict(const Real* values, UInt index, FloatCodec::Predictor predictor) {
+		if (index == 0)
+			return 0;
+		if (predictor == FloatCodec::Predictor::LINEAR && index >= 2) {
+			// no multiplication, so that the result does not depend on the contraction to fused multiply-add
+			Real prediction = (values[index - 1] + values[index - 1]) - values[index - 2];
+			if (!std::isnan(prediction))
+				return toBits(prediction);
+		}
+		return toBits(values[index - 1]);
+	}
+
+	class BitWriter {
+	public:
+		BitWriter(std::vector<std::uint8_t>& stream) : mStream(stream) { }
+
+		void write(std::uint64_t value, UInt bits) {
+			if (bits > 32) {
+				write(value >> 32, bits - 32);
+				value &= 0xffffffffull;
+				bits = 32;
+			}
+			mPending = (mPending << bits) | (value & ((1ull << bits) - 1));
+			mBits += bits;
+			while (mBits >= 8) {
+				mBits -= 8;
+				mStream.push_back(static_cast<std::uint8_t>(mPending >> mBits));
+			}
+			mPending &= (1ull << mBits) - 1;
+		}
+
+		void finish() {
+			if (mBits > 0)
+				mStream.push_back(static_cast<std::uint8_t>(mPending << (8 - mBits)));
+			mBits = 0;
+			mPending = 0;
+		}
+
+	private:
+		std::vector<std::uint8_t>& mStream;
+		/// Bits not yet appended to the stream, less than 8 between calls
+		std::uint64_t mPending = 0;
+		UInt mBits = 0;
+	};
+
+	class BitReader {
+	public:
+		BitReader(const std::uint8_t* stream, std::size_t size) : mStream(stream), mSize(size) { }
+
+		std::uint64_t read(UInt bits) {
+			std::uint64_t value = 0;
+			while (bits > 0) {
+				// reading past the end of the stream gives zeros
+				std::size_t byte = mPosition >> 3;
+				UInt current = byte < mSize ? mStream[byte] : 0;
+				UInt available = 8 - static_cast<UInt>(mPosition & 7);
+				UInt taken = available < bits ? available : bits;
+				value = (value << taken) | ((current >> (available - taken)) & ((1u << taken) - 1));
+				mPosition += taken;
+				bits -= taken;
+			}
+			return value;
+		}
+
+	private:
+		const std::uint8_t* mStream;
+		std::size_t mSize;
+		std::size_t mPosition = 0;
+	};
+}
+
+void FloatCodec::encode(const Real* values, UInt count, Predictor predictor, std::vector<std::uint8_t>& stream) {
+	BitWriter writer(stream);
+	UInt windowLeading = 0, windowTrailing = 0;
+	Bool hasWindow = false;
+
+	for (UInt i = 0; i < count; ++i) {
+		std::uint64_t delta = toBits(values[i]) ^ predict(values, i, predictor);
+		if (delta == 0) {
+			writer.write(0, 1);
+			continue;
+		}
+
+		UInt leading = std::min<UInt>(leadingZeros(delta), 31);
+		UInt trailing = trailingZeros(delta);
+		if (hasWindow && leading >= windowLeading && trailing >= windowTrailing) {
+			writer.write(2, 2);
+			writer.write(delta >> windowTrailing, 64 - windowLeading - windowTrailing);
+		} else {
+			UInt length = 64 - leading - trailing;
+			writer.write(3, 2);
+			writer.write(leading, 5);
+			writer.write(length & 63, 6);
+			writer.write(delta >> trailing, length);
+			windowLeading = leading;
+			windowTrailing = trailing;
+			hasWindow = true;
+		}
+	}
+	writer.finish();
+}
+
+FloatCodec::Predictor FloatCodec::encodeBest(const Real* values, UInt count, std::vector<std::uint8_t>& stream) {
+	std::vector<std::uint8_t> previous, linear;
+	encode(values, count, Predictor::PREVIOUS, previous);
+	encode(values, count, Predictor::LINEAR, linear);
+
+	if (linear.size() < previous.size()) {
+		stream.insert(stream.end(), linear.begin(), linear.end());
+		return Predictor::LINEAR;
+	}
+	stream.insert(stream.end(), previous.begin(), previous.end());
+	return Predictor::PREVIOUS;
+}
+
+void FloatCodec::decode(const std::uint8_t* stream, std::size_t size, UInt count, Predictor predictor, Real* values) {
+	BitReader reader(stream, size);
+	UInt windowLeading = 0, windowTrailing = 0;
+
+	for (UInt i = 0; i < count; ++i) {
+		std::uint64_t delta = 0;
+		if (reader.read(1) == 1) {
+			if (reader.read(1) == 0) {
+				delta = reader.read(64 - windowLeading - windowTrailing) << windowTrailing;
+			} else {
+				windowLeading = static_cast<UInt>(reader.read(5));
+				UInt length = static_cast<UInt>(reader.read(6));
+				if (length == 0)
+					length = 64;
+				if (windowLeading + length > 64)
+					throw CPS::SystemError("Invalid window in compressed value stream");
+				windowTrailing = 64 - windowLeading - length;
+				delta = reader.read(length) << windowTrailing;
+			}
+		}
+		values[i] = fromBits(delta ^ predict(values, i, predictor));
+	}
+}
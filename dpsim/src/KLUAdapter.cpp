@@ -10,12 +10,22 @@
 
 using namespace DPsim;
 
+namespace
+{
+/* the symbolic analysis can be shared between adapters, so it is
+ * freed independently of the klu_common of a particular adapter */
+void freeSymbolic(klu_symbolic *symbolic)
+{
+    klu_common common;
+    klu_defaults(&common);
+    klu_free_symbolic(&symbolic, &common);
+}
+}
+
 namespace DPsim
 {
 KLUAdapter::~KLUAdapter()
 {
-    if (mSymbolic)
-        klu_free_symbolic(&mSymbolic, &mCommon);
     if (mNumeric)
         klu_free_numeric(&mNumeric, &mCommon);
     SPDLOG_LOGGER_INFO(mSLog,"Number of Pivot Faults: {}", mPivotFaults);
@@ -44,10 +54,8 @@ KLUAdapter::KLUAdapter(CPS::Logger::Log log) : KLUAdapter()
 void KLUAdapter::preprocessing(SparseMatrix &systemMatrix,
                                std::vector<std::pair<UInt, UInt>> &listVariableSystemMatrixEntries)
 {
-    if (mSymbolic)
-    {
-        klu_free_symbolic(&mSymbolic, &mCommon);
-    }
+    mSharedSymbolic.reset();
+    mSymbolic = nullptr;
 
     const Int n = Eigen::internal::convert_index<Int>(systemMatrix.rows());
 
@@ -68,12 +76,31 @@ void KLUAdapter::preprocessing(SparseMatrix &systemMatrix,
 
     // this call also works if mVaryingColumns, mVaryingRows are empty
     mSymbolic = klu_analyze_partial(n, Ap, Ai, &mVaryingColumns[0], &mVaryingRows[0], varying_entries, mPreordering, &mCommon);
+    mSharedSymbolic = std::shared_ptr<klu_symbolic>(mSymbolic, freeSymbolic);
 
     /* store non-zero value of current preprocessed matrix. only used until
      * to-do in refactorize-function is resolved. Can be removed then. */
     nnz = Eigen::internal::convert_index<Int>(systemMatrix.nonZeros());
 }
 
+Bool KLUAdapter::preprocessingShared(SparseMatrix &systemMatrix, const DirectLinearSolver &reference)
+{
+    auto kluReference = dynamic_cast<const KLUAdapter *>(&reference);
+    if (!kluReference || !kluReference->mSharedSymbolic
+        || kluReference->mPreordering != mPreordering || kluReference->mCommon.btf != mCommon.btf)
+        return false;
+
+    /* the caller guarantees an identical sparsity pattern, so only the
+     * symbolic analysis and the varying entries of the reference are adopted */
+    mSharedSymbolic = kluReference->mSharedSymbolic;
+    mSymbolic = mSharedSymbolic.get();
+    mChangedEntries = kluReference->mChangedEntries;
+    mVaryingRows = kluReference->mVaryingRows;
+    mVaryingColumns = kluReference->mVaryingColumns;
+    nnz = Eigen::internal::convert_index<Int>(systemMatrix.nonZeros());
+    return true;
+}
+
 void KLUAdapter::factorize(SparseMatrix &systemMatrix)
 {
     if (mNumeric)
@@ -159,7 +186,16 @@ void KLUAdapter::partialRefactorize(SparseMatrix &systemMatrix,
 
 Matrix KLUAdapter::solve(Matrix &rightSideVector)
 {
-    Matrix x = rightSideVector;
+    Matrix x;
+    solve(rightSideVector, x);
+    return x;
+}
+
+void KLUAdapter::solve(const Matrix &rightSideVector, Matrix &leftSideVector)
+{
+    /* KLU solves in place, so the right hand side is copied into the solution vector.
+     * This does not allocate if the solution vector already has the correct size. */
+    leftSideVector = rightSideVector;
 
     /* number of right hands sides
      * usually one, KLU can handle multiple right hand sides */
@@ -171,9 +207,17 @@ Matrix KLUAdapter::solve(Matrix &rightSideVector)
 	/* tsolve refers to transpose solve. Input matrix is stored in compressed row format,
 	 * KLU operates on compressed column format. This way, the transpose of the matrix is factored.
 	 * This has to be taken into account only here during right-hand solving. */
-    klu_tsolve(mSymbolic, mNumeric, rhsRows, rhsCols, x.const_cast_derived().data(), &mCommon);
+    klu_tsolve(mSymbolic, mNumeric, rhsRows, rhsCols, leftSideVector.data(), &mCommon);
+}
 
-    return x;
+std::size_t KLUAdapter::factorizationMemory() const
+{
+    if (mNumeric == nullptr)
+        return 0;
+
+    /* L, U and the off-diagonal blocks each store a value and a row index per entry */
+    std::size_t entries = static_cast<std::size_t>(mNumeric->lnz) + mNumeric->unz + mNumeric->nzoff;
+    return entries * (sizeof(Real) + sizeof(Int));
 }
 
 void KLUAdapter::printMatrixMarket(SparseMatrix &matrix, int counter) const
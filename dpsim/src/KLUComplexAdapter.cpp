@@ -0,0 +1,381 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include <dpsim/KLUComplexAdapter.h>
+
+using namespace DPsim;
+
+namespace
+{
+/* the symbolic analysis can be shared between adapters, so it is
+ * freed independently of the klu_common of a particular adapter */
+void freeSymbolic(klu_symbolic *symbolic)
+{
+	klu_common common;
+	klu_defaults(&common);
+	klu_free_symbolic(&symbolic, &common);
+}
+
+Bool isClose(Real value, Real reference)
+{
+	return std::abs(value - reference) <= DOUBLE_EPSILON * std::max(1., std::abs(reference));
+}
+}
+
+namespace DPsim
+{
+KLUComplexAdapter::~KLUComplexAdapter()
+{
+	if (mNumeric)
+		klu_z_free_numeric(&mNumeric, &mCommon);
+	SPDLOG_LOGGER_INFO(mSLog, "Number of Pivot Faults: {}", mPivotFaults);
+}
+
+KLUComplexAdapter::KLUComplexAdapter(UInt numFreqBlocks) :
+	mNumFreqBlocks(numFreqBlocks)
+{
+	klu_defaults(&mCommon);
+	mCommon.scale = 2;
+	mCommon.btf = 1;
+}
+
+KLUComplexAdapter::KLUComplexAdapter(CPS::Logger::Log log, UInt numFreqBlocks) :
+	KLUComplexAdapter(numFreqBlocks)
+{
+	this->mSLog = log;
+}
+
+void KLUComplexAdapter::preprocessing(SparseMatrix &systemMatrix,
+	std::vector<std::pair<UInt, UInt>> &listVariableSystemMatrixEntries)
+{
+	mChangedEntries = listVariableSystemMatrixEntries;
+	mSharedSymbolic.reset();
+	mSymbolic = nullptr;
+	if (mNumeric)
+		klu_z_free_numeric(&mNumeric, &mCommon);
+
+	mComplexMode = createComplexPattern(systemMatrix);
+	if (!mComplexMode)
+	{
+		SPDLOG_LOGGER_WARN(mSLog, "System matrix has no complex block structure, factoring the real-expanded matrix");
+		useRealAdapter(systemMatrix);
+		return;
+	}
+	mRealAdapter.reset();
+
+	/* the compressed rows of the complex matrix are passed as compressed columns,
+	 * so the transpose is analysed and factored, like in the real-valued adapter */
+	mSymbolic = klu_analyze(mComplexSize, mComplexOuter.data(), mComplexInner.data(), &mCommon);
+	mSharedSymbolic = std::shared_ptr<klu_symbolic>(mSymbolic, freeSymbolic);
+	nnz = Eigen::internal::convert_index<Int>(systemMatrix.nonZeros());
+
+	SPDLOG_LOGGER_INFO(mSLog, "Complex system matrix: {} x {} with {} nonzeros (real-expanded: {})",
+		mComplexSize, mComplexSize, mComplexInner.size(), nnz);
+}
+
+Bool KLUComplexAdapter::preprocessingShared(SparseMatrix &systemMatrix, const DirectLinearSolver &reference)
+{
+	auto kluReference = dynamic_cast<const KLUComplexAdapter *>(&reference);
+	if (!kluReference || !kluReference->mComplexMode || !kluReference->mSharedSymbolic
+		|| kluReference->mNumFreqBlocks != mNumFreqBlocks || kluReference->mCommon.btf != mCommon.btf)
+		return false;
+
+	/* the caller guarantees an identical sparsity pattern, so the complex pattern
+	 * and its value offsets are identical as well */
+	if (mNumeric)
+		klu_z_free_numeric(&mNumeric, &mCommon);
+	mRealAdapter.reset();
+	mComplexMode = true;
+	mBlockSize = kluReference->mBlockSize;
+	mComplexSize = kluReference->mComplexSize;
+	mComplexOuter = kluReference->mComplexOuter;
+	mComplexInner = kluReference->mComplexInner;
+	mComplexValues.resize(kluReference->mComplexValues.size());
+	mRealPartOffsets = kluReference->mRealPartOffsets;
+	mImagPartOffsets = kluReference->mImagPartOffsets;
+	mRealMirrorOffsets = kluReference->mRealMirrorOffsets;
+	mImagMirrorOffsets = kluReference->mImagMirrorOffsets;
+	mRealRows = kluReference->mRealRows;
+	mChangedEntries = kluReference->mChangedEntries;
+	mSharedSymbolic = kluReference->mSharedSymbolic;
+	mSymbolic = mSharedSymbolic.get();
+	nnz = Eigen::internal::convert_index<Int>(systemMatrix.nonZeros());
+	return true;
+}
+
+void KLUComplexAdapter::factorize(SparseMatrix &systemMatrix)
+{
+	if (!mComplexMode)
+	{
+		mRealAdapter->factorize(systemMatrix);
+		return;
+	}
+
+	if (!gatherComplexValues(systemMatrix))
+	{
+		SPDLOG_LOGGER_WARN(mSLog, "System matrix values are not complex-consistent, factoring the real-expanded matrix");
+		useRealAdapter(systemMatrix);
+		mRealAdapter->factorize(systemMatrix);
+		return;
+	}
+
+	if (mNumeric)
+		klu_z_free_numeric(&mNumeric, &mCommon);
+	mNumeric = klu_z_factor(mComplexOuter.data(), mComplexInner.data(), mComplexValues.data(), mSymbolic, &mCommon);
+}
+
+void KLUComplexAdapter::refactorize(SparseMatrix &systemMatrix)
+{
+	if (!mComplexMode)
+	{
+		mRealAdapter->refactorize(systemMatrix);
+		return;
+	}
+
+	if (systemMatrix.nonZeros() != nnz)
+	{
+		preprocessing(systemMatrix, mChangedEntries);
+		factorize(systemMatrix);
+		return;
+	}
+
+	if (!gatherComplexValues(systemMatrix))
+	{
+		factorize(systemMatrix);
+		return;
+	}
+
+	klu_z_refactor(mComplexOuter.data(), mComplexInner.data(), mComplexValues.data(), mSymbolic, mNumeric, &mCommon);
+	if (mCommon.status == KLU_PIVOT_FAULT)
+	{
+		/* pivot became too small => fully factorize again */
+		mPivotFaults++;
+		factorize(systemMatrix);
+	}
+}
+
+void KLUComplexAdapter::partialRefactorize(SparseMatrix &systemMatrix,
+	std::vector<std::pair<UInt, UInt>> &listVariableSystemMatrixEntries)
+{
+	if (!mComplexMode)
+	{
+		mRealAdapter->partialRefactorize(systemMatrix, listVariableSystemMatrixEntries);
+		return;
+	}
+
+	mChangedEntries = listVariableSystemMatrixEntries;
+	refactorize(systemMatrix);
+}
+
+Matrix KLUComplexAdapter::solve(Matrix &rightSideVector)
+{
+	Matrix x;
+	solve(rightSideVector, x);
+	return x;
+}
+
+void KLUComplexAdapter::solve(const Matrix &rightSideVector, Matrix &leftSideVector)
+{
+	if (!mComplexMode)
+	{
+		mRealAdapter->solve(rightSideVector, leftSideVector);
+		return;
+	}
+
+	const Eigen::Index halfBlock = mBlockSize / 2;
+	const Eigen::Index rhsCols = rightSideVector.cols();
+	const std::size_t columnSize = 2 * static_cast<std::size_t>(mComplexSize);
+
+	/* does not allocate if the sizes did not change since the last solve */
+	leftSideVector.resize(rightSideVector.rows(), rhsCols);
+	mComplexVector.resize(columnSize * rhsCols);
+
+	for (Eigen::Index col = 0; col < rhsCols; ++col)
+	{
+		Real *column = mComplexVector.data() + col * columnSize;
+		for (Int k = 0; k < mComplexSize; ++k)
+		{
+			column[2 * k] = rightSideVector(mRealRows[k], col);
+			column[2 * k + 1] = rightSideVector(mRealRows[k] + halfBlock, col);
+		}
+	}
+
+	/* the transpose of the matrix is factored, see preprocessing */
+	klu_z_tsolve(mSymbolic, mNumeric, mComplexSize, Eigen::internal::convert_index<Int>(rhsCols),
+		mComplexVector.data(), 0, &mCommon);
+
+	for (Eigen::Index col = 0; col < rhsCols; ++col)
+	{
+		const Real *column = mComplexVector.data() + col * columnSize;
+		for (Int k = 0; k < mComplexSize; ++k)
+		{
+			leftSideVector(mRealRows[k], col) = column[2 * k];
+			leftSideVector(mRealRows[k] + halfBlock, col) = column[2 * k + 1];
+		}
+	}
+}
+
+std::size_t KLUComplexAdapter::factorizationMemory() const
+{
+	if (!mComplexMode)
+		return mRealAdapter ? mRealAdapter->factorizationMemory() : 0;
+	if (mNumeric == nullptr)
+		return 0;
+
+	/* L, U and the off-diagonal blocks each store a complex value and a row index per entry */
+	std::size_t entries = static_cast<std::size_t>(mNumeric->lnz) + mNumeric->unz + mNumeric->nzoff;
+	return entries * (2 * sizeof(Real) + sizeof(Int));
+}
+
+Bool KLUComplexAdapter::createComplexPattern(SparseMatrix &systemMatrix)
+{
+	systemMatrix.makeCompressed();
+
+	const Eigen::Index rows = systemMatrix.rows();
+	if (mNumFreqBlocks == 0 || rows == 0 || rows != systemMatrix.cols() || rows % (2 * mNumFreqBlocks) != 0)
+		return false;
+
+	mBlockSize = Eigen::internal::convert_index<Int>(rows / mNumFreqBlocks);
+	mComplexSize = Eigen::internal::convert_index<Int>(rows / 2);
+	const Eigen::Index halfBlock = mBlockSize / 2;
+
+	const auto outer = systemMatrix.outerIndexPtr();
+	const auto inner = systemMatrix.innerIndexPtr();
+
+	/* position of a real-expanded entry in the value array, -1 for structural zeros */
+	auto offset = [outer, inner](Eigen::Index row, Eigen::Index col) -> Eigen::Index {
+		auto begin = inner + outer[row];
+		auto end = inner + outer[row + 1];
+		auto pos = std::lower_bound(begin, end, col);
+		return (pos != end && *pos == col) ? pos - inner : -1;
+	};
+
+	mRealRows.resize(mComplexSize);
+	for (Int k = 0; k < mComplexSize; ++k)
+		mRealRows[k] = (k / halfBlock) * mBlockSize + k % halfBlock;
+
+	mComplexOuter.assign(1, 0);
+	mComplexInner.clear();
+	mRealPartOffsets.clear();
+	mImagPartOffsets.clear();
+	mRealMirrorOffsets.clear();
+	mImagMirrorOffsets.clear();
+
+	std::vector<Int> columns;
+	for (Int k = 0; k < mComplexSize; ++k)
+	{
+		const Eigen::Index realRow = mRealRows[k];
+		const Eigen::Index imagRow = realRow + halfBlock;
+
+		/* a complex entry exists if any of its four real-expanded entries exists */
+		columns.clear();
+		for (Eigen::Index row : {realRow, imagRow})
+		{
+			for (auto p = outer[row]; p < outer[row + 1]; ++p)
+			{
+				Eigen::Index local = inner[p] % mBlockSize;
+				if (local >= halfBlock)
+					local -= halfBlock;
+				columns.push_back(Eigen::internal::convert_index<Int>((inner[p] / mBlockSize) * halfBlock + local));
+			}
+		}
+		std::sort(columns.begin(), columns.end());
+		columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+		for (Int j : columns)
+		{
+			const Eigen::Index realCol = mRealRows[j];
+			const Eigen::Index imagCol = realCol + halfBlock;
+			mRealPartOffsets.push_back(offset(realRow, realCol));
+			mImagPartOffsets.push_back(offset(imagRow, realCol));
+			mRealMirrorOffsets.push_back(offset(imagRow, imagCol));
+			mImagMirrorOffsets.push_back(offset(realRow, imagCol));
+			mComplexInner.push_back(j);
+		}
+		mComplexOuter.push_back(Eigen::internal::convert_index<Int>(mComplexInner.size()));
+	}
+
+	mComplexValues.resize(2 * mComplexInner.size());
+	return gatherComplexValues(systemMatrix);
+}
+
+Bool KLUComplexAdapter::gatherComplexValues(const SparseMatrix &systemMatrix)
+{
+	const Real *values = systemMatrix.valuePtr();
+	auto value = [values](Eigen::Index offset) {
+		return offset < 0 ? 0. : values[offset];
+	};
+
+	/* each complex value a + jb is stamped as [a -b; b a] */
+	for (std::size_t k = 0; k < mComplexInner.size(); ++k)
+	{
+		const Real real = value(mRealPartOffsets[k]);
+		const Real imag = value(mImagPartOffsets[k]);
+		if (!isClose(value(mRealMirrorOffsets[k]), real) || !isClose(-value(mImagMirrorOffsets[k]), imag))
+			return false;
+		mComplexValues[2 * k] = real;
+		mComplexValues[2 * k + 1] = imag;
+	}
+	return true;
+}
+
+void KLUComplexAdapter::useRealAdapter(SparseMatrix &systemMatrix)
+{
+	mComplexMode = false;
+	mSharedSymbolic.reset();
+	mSymbolic = nullptr;
+	if (mNumeric)
+		klu_z_free_numeric(&mNumeric, &mCommon);
+
+	mRealAdapter = std::make_shared<KLUAdapter>(mSLog);
+	mRealAdapter->setConfiguration(mConfiguration);
+	mRealAdapter->preprocessing(systemMatrix, mChangedEntries);
+}
+
+void KLUComplexAdapter::applyConfiguration()
+{
+	switch(mConfiguration.getScalingMethod())
+	{
+		case SCALING_METHOD::NO_SCALING:
+			mCommon.scale = 0;
+			break;
+		case SCALING_METHOD::SUM_SCALING:
+			mCommon.scale = 1;
+			break;
+		case SCALING_METHOD::MAX_SCALING:
+			mCommon.scale = 2;
+			break;
+		default:
+			mCommon.scale = 1;
+	}
+
+	SPDLOG_LOGGER_INFO(mSLog, "Matrix is scaled using " + mConfiguration.getScalingMethodString());
+
+	switch(mConfiguration.getBTF())
+	{
+		case USE_BTF::DO_BTF:
+			mCommon.btf = 1;
+			break;
+		case USE_BTF::NO_BTF:
+			mCommon.btf = 0;
+			break;
+		default:
+			mCommon.btf = 1;
+	}
+
+	SPDLOG_LOGGER_INFO(mSLog, "Matrix is permuted " + mConfiguration.getBTFString());
+
+	/* the complex path always uses the default AMD ordering and full refactorization,
+	 * the other options are passed on in case the real-expanded matrix is factored */
+	if (mRealAdapter)
+		mRealAdapter->setConfiguration(mConfiguration);
+}
+} // namespace DPsim
@@ -10,6 +10,7 @@
 #include <dpsim/MNASolver.h>
 #include <dpsim/SequentialScheduler.h>
 #include <memory>
+#include <algorithm>
 
 using namespace DPsim;
 using namespace CPS;
@@ -57,6 +58,10 @@ void MnaSolver<VarType>::initialize() {
 	if (mSystem.mComponents.size() == 0)
 		throw SolverException();
 
+	mFactorizeTimes.enableTrace(mTimingTrace);
+	mSolveTimes.enableTrace(mTimingTrace);
+	mRecomputationTimes.enableTrace(mTimingTrace);
+
 	// We need to differentiate between power and signal components and
 	// ground nodes should be ignored.
 	identifyTopologyObjects();
@@ -122,7 +127,7 @@ void MnaSolver<Real>::initializeComponents() {
 		comp->mnaInitialize(mSystem.mSystemOmega, mTimeStep, mLeftSideVector);
 		const Matrix& stamp = comp->getRightVector()->get();
 		if (stamp.size() != 0) {
-			mRightVectorStamps.push_back(&stamp);
+			addRightVectorStamp(comp, stamp);
 		}
 	}
 
@@ -175,7 +180,7 @@ void MnaSolver<Complex>::initializeComponents() {
 			comp->mnaInitialize(mSystem.mSystemOmega, mTimeStep, mLeftSideVector);
 			const Matrix& stamp = comp->getRightVector()->get();
 			if (stamp.size() != 0) {
-				mRightVectorStamps.push_back(&stamp);
+				addRightVectorStamp(comp, stamp);
 			}
 		}
 
@@ -188,6 +193,51 @@ void MnaSolver<Complex>::initializeComponents() {
 	}
 }
 
+template <typename VarType>
+void MnaSolver<VarType>::addRightVectorStamp(const CPS::MNAInterface::Ptr& comp, const Matrix& stamp) {
+	mRightVectorStamps.push_back(&stamp);
+
+	std::vector<UInt> matrixNodeIndices;
+	std::vector<UInt> rows;
+	Bool knownRows = stamp.cols() == 1 && comp->mnaRightVectorStampNodes(matrixNodeIndices);
+	if (knownRows)
+		rightVectorRows(matrixNodeIndices, stamp.rows(), rows);
+
+	// Fall back to adding the complete vector if the rows are unknown or invalid
+	if (!knownRows || (!rows.empty() && rows.back() >= stamp.rows())) {
+		mDenseRightVectorStamps.push_back(&stamp);
+		return;
+	}
+	if (!rows.empty())
+		mSparseRightVectorStamps.push_back(std::make_pair(&stamp, rows));
+}
+
+template <>
+void MnaSolver<Real>::rightVectorRows(const std::vector<UInt>& matrixNodeIndices, Matrix::Index numRows, std::vector<UInt>& rows) const {
+	rows = Math::vectorElementRows(matrixNodeIndices);
+}
+
+template <>
+void MnaSolver<Complex>::rightVectorRows(const std::vector<UInt>& matrixNodeIndices, Matrix::Index numRows, std::vector<UInt>& rows) const {
+	// Real and imaginary parts of all frequencies, see Math::setVectorElement
+	rows = Math::complexVectorElementRows(matrixNodeIndices, numRows, static_cast<Int>(mSystem.mFrequencies.size()));
+}
+
+template <typename VarType>
+void MnaSolver<VarType>::assembleRightSideVector() {
+	mRightSideVector.setZero();
+
+	for (auto stamp : mDenseRightVectorStamps)
+		mRightSideVector += *stamp;
+
+	// Only gather the rows a component is stamping into
+	for (auto& stamp : mSparseRightVectorStamps) {
+		const Matrix& vector = *stamp.first;
+		for (auto row : stamp.second)
+			mRightSideVector(row, 0) += vector(row, 0);
+	}
+}
+
 template <typename VarType>
 void MnaSolver<VarType>::initializeSystem() {
 	SPDLOG_LOGGER_INFO(mSLog, "-- Initialize MNA system matrices and source vector");
@@ -229,15 +279,22 @@ void MnaSolver<VarType>::initializeSystemWithParallelFrequencies() {
 
 template <typename VarType>
 void MnaSolver<VarType>::initializeSystemWithPrecomputedMatrices() {
-	// iterate over all possible switch state combinations
-	for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++) {
-		switchedMatrixEmpty(i);
-	}
-
 	if (mSwitches.size() < 1) {
+		switchedMatrixEmpty(0);
 		switchedMatrixStamp(0, mMNAComponents);
 	}
+	else if (mLazySwitchedMatrices || mLowRankSwitchUpdates) {
+		// Only the initial switch state is factorized here, all other
+		// combinations are factorized by the solver once they are reached
+		updateSwitchStatus();
+		switchedMatrixEmpty(mCurrentSwitchStatus.to_ullong());
+		switchedMatrixStamp(mCurrentSwitchStatus.to_ullong(), mMNAComponents);
+	}
 	else {
+		// iterate over all possible switch state combinations
+		for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++) {
+			switchedMatrixEmpty(i);
+		}
 		// Generate switching state dependent system matrices
 		for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++) {
 			switchedMatrixStamp(i, mMNAComponents);
@@ -571,8 +628,10 @@ Task::List MnaSolver<VarType>::getTasks() {
 		}
 	}
 	if (mFrequencyParallel) {
-		for (UInt i = 0; i < mSystem.mFrequencies.size(); ++i)
-			l.push_back(createSolveTaskHarm(i));
+		for (UInt i = 0; i < mSystem.mFrequencies.size(); ++i) {
+			if (auto task = createSolveTaskHarm(i))
+				l.push_back(task);
+		}
 	} else if (mSystemMatrixRecomputation) {
 		for (auto comp : this->mMNAIntfVariableComps) {
 			for (auto task : comp->mnaTasks())
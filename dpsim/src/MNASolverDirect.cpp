@@ -9,20 +9,63 @@
 #include <dpsim/MNASolverDirect.h>
 #include <dpsim/SequentialScheduler.h>
 
+#include <algorithm>
+#include <cassert>
+
 using namespace DPsim;
 using namespace CPS;
 
 namespace DPsim {
 
 template <typename VarType>
-MnaSolverDirect<VarType>::MnaSolverDirect(String name, CPS::Domain domain, CPS::Logger::Level logLevel) :	MnaSolver<VarType>(name, domain, logLevel) {
+MnaSolverDirect<VarType>::MnaSolverDirect(String name, CPS::Domain domain, CPS::Logger::Level logLevel) :
+	MnaSolver<VarType>(name, domain, logLevel),
+	mNumHarmonicSolveGroups(create<Int>("harmonic_solve_groups", 0)),
+	mNumSwitchedMatrixFactorizations(create<Int>("factorizations", 0)),
+	mNumCachedSwitchedMatrices(create<Int>("cached_matrices", 0)),
+	mNumSwitchedMatrixEvictions(create<Int>("evictions", 0)),
+	mNumLowRankSolves(create<Int>("low_rank_solves", 0)),
+	mNumCachedLowRankUpdates(create<Int>("cached_low_rank_updates", 0)),
+	mNumStampSlotFallbacks(create<Int>("stamp_slot_fallbacks", 0)) {
 	mImplementationInUse = DirectLinearSolverImpl::KLU;
 }
 
 
+template <typename VarType>
+void MnaSolverDirect<VarType>::initializeSystem() {
+	// Matrices cached during a previous initialization might have been
+	// stamped with a different component behaviour
+	if (hasLazySwitchedMatrices()) {
+		mSwitchedMatrices.clear();
+		mDirectLinearSolvers.clear();
+		mSwitchedMatrixCache.clear();
+		mSwitchedMatrixUsage.clear();
+		mSwitchedMatrixMemory = 0;
+	}
+	**mNumSwitchedMatrixFactorizations = 0;
+	**mNumCachedSwitchedMatrices = 0;
+	**mNumSwitchedMatrixEvictions = 0;
+	**mNumStampSlotFallbacks = 0;
+	**mNumLowRankSolves = 0;
+	clearLowRankSwitchUpdates();
+	mSymbolicReferences.clear();
+	MnaSolver<VarType>::initializeSystem();
+	mLowRankBaseStatus = mCurrentSwitchStatus;
+
+	mHarmonicSolveGroups.clear();
+	**mNumHarmonicSolveGroups = mFrequencyParallel ? static_cast<Int>(this->mSystem.mFrequencies.size()) : 0;
+	if (mFrequencyParallel && mHarmonicSolveGrouping)
+		createHarmonicSolveGroups();
+	else if (mSymbolicAnalysisPool)
+		SPDLOG_LOGGER_INFO(mSLog, "Number of factorizations with shared symbolic analysis: {:d}", mNumSharedSymbolic);
+}
+
 template <typename VarType>
 void MnaSolverDirect<VarType>::switchedMatrixEmpty(std::size_t index) {
-	mSwitchedMatrices[std::bitset<SWITCH_NUM>(index)][0].setZero();
+	auto bit = std::bitset<SWITCH_NUM>(index);
+	if (hasLazySwitchedMatrices() && mSwitchedMatrices.find(bit) == mSwitchedMatrices.end())
+		createSwitchedMatrix(bit);
+	mSwitchedMatrices[bit][0].setZero();
 }
 
 template <typename VarType>
@@ -42,12 +85,389 @@ void MnaSolverDirect<VarType>::switchedMatrixStamp(std::size_t index, std::vecto
 		mSwitches[i]->mnaApplySwitchSystemMatrixStamp(bit[i], sys, 0);
 
 	// Compute LU-factorization for system matrix
-	mDirectLinearSolvers[bit][0]->preprocessing(sys, mListVariableSystemMatrixEntries);
+	preprocessSystemMatrix(sys, mDirectLinearSolvers[bit][0]);
 	auto start = std::chrono::steady_clock::now();
 	mDirectLinearSolvers[bit][0]->factorize(sys);
 	auto end = std::chrono::steady_clock::now();
 	std::chrono::duration<Real> diff = end-start;
-	mFactorizeTimes.push_back(diff.count());
+	mFactorizeTimes.update(diff.count());
+	++**mNumSwitchedMatrixFactorizations;
+
+	if (hasLazySwitchedMatrices())
+		cacheSwitchedMatrix(bit);
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::switchedMatrixStamp(std::size_t swIdx, Int freqIdx, CPS::MNAInterface::List& components, CPS::MNASwitchInterface::List& switches)
+{
+	auto bit = std::bitset<SWITCH_NUM>(swIdx);
+	auto& sys = mSwitchedMatrices[bit][freqIdx];
+	for (auto component : components)
+		component->mnaApplySystemMatrixStampHarm(sys, freqIdx);
+	for (UInt i = 0; i < switches.size(); ++i)
+		switches[i]->mnaApplySwitchSystemMatrixStamp(bit[i], sys, freqIdx);
+	sys.makeCompressed();
+
+	// Compute LU-factorization for system matrix
+	preprocessSwitchedMatrix(bit, freqIdx);
+	auto start = std::chrono::steady_clock::now();
+	mDirectLinearSolvers[bit][freqIdx]->factorize(sys);
+	auto end = std::chrono::steady_clock::now();
+	std::chrono::duration<Real> diff = end-start;
+	mFactorizeTimes.update(diff.count());
+	++**mNumSwitchedMatrixFactorizations;
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::preprocessSwitchedMatrix(const std::bitset<SWITCH_NUM>& status, Int freqIdx) {
+	auto& sys = mSwitchedMatrices[status][freqIdx];
+	auto& solver = *mDirectLinearSolvers[status][freqIdx];
+
+	for (auto& reference : mSymbolicReferences) {
+		auto& referenceSys = mSwitchedMatrices[reference.first][reference.second];
+		if (hasSamePattern(referenceSys, sys)
+			&& solver.preprocessingShared(sys, *mDirectLinearSolvers[reference.first][reference.second])) {
+			++mNumSharedSymbolic;
+			return;
+		}
+	}
+
+	preprocessSystemMatrix(sys, mDirectLinearSolvers[status][freqIdx]);
+	mSymbolicReferences.emplace_back(status, freqIdx);
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::preprocessSystemMatrix(SparseMatrix& systemMatrix, const std::shared_ptr<DirectLinearSolver>& solver) {
+	if (!mSymbolicAnalysisPool) {
+		solver->preprocessing(systemMatrix, mListVariableSystemMatrixEntries);
+		return;
+	}
+
+	if (mSymbolicAnalysisPool->preprocessingShared(systemMatrix, mListVariableSystemMatrixEntries, *solver)) {
+		++mNumSharedSymbolic;
+		return;
+	}
+	solver->preprocessing(systemMatrix, mListVariableSystemMatrixEntries);
+	mSymbolicAnalysisPool->add(systemMatrix, mListVariableSystemMatrixEntries, solver);
+}
+
+template <typename VarType>
+Bool MnaSolverDirect<VarType>::hasSamePattern(const SparseMatrix& first, const SparseMatrix& second) {
+	if (!first.isCompressed() || !second.isCompressed()
+		|| first.rows() != second.rows() || first.cols() != second.cols()
+		|| first.nonZeros() != second.nonZeros())
+		return false;
+
+	return std::equal(first.outerIndexPtr(), first.outerIndexPtr() + first.outerSize() + 1, second.outerIndexPtr())
+		&& std::equal(first.innerIndexPtr(), first.innerIndexPtr() + first.nonZeros(), second.innerIndexPtr());
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::createHarmonicSolveGroups() {
+	UInt numFreqs = static_cast<UInt>(this->mSystem.mFrequencies.size());
+	mHarmonicSolveGroups.assign(numFreqs, {});
+	mHarmonicGroupRightSide.assign(numFreqs, Matrix());
+	mHarmonicGroupLeftSide.assign(numFreqs, Matrix());
+
+	auto isIdentical = [this](UInt first, UInt second) {
+		for (auto& entry : mSwitchedMatrices) {
+			auto& firstSys = entry.second[first];
+			auto& secondSys = entry.second[second];
+			if (!hasSamePattern(firstSys, secondSys)
+				|| !std::equal(firstSys.valuePtr(), firstSys.valuePtr() + firstSys.nonZeros(), secondSys.valuePtr()))
+				return false;
+		}
+		return true;
+	};
+
+	for (UInt freq = 0; freq < numFreqs; ++freq) {
+		UInt leader = freq;
+		for (UInt prev = 0; prev < freq; ++prev) {
+			if (!mHarmonicSolveGroups[prev].empty() && isIdentical(prev, freq)) {
+				leader = prev;
+				break;
+			}
+		}
+		mHarmonicSolveGroups[leader].push_back(freq);
+
+		// Group members use the factorization of the first frequency
+		if (leader != freq) {
+			for (auto& entry : mDirectLinearSolvers)
+				entry.second[freq] = entry.second[leader];
+		}
+	}
+
+	**mNumHarmonicSolveGroups = 0;
+	for (UInt freq = 0; freq < numFreqs; ++freq) {
+		auto& group = mHarmonicSolveGroups[freq];
+		if (!group.empty())
+			++**mNumHarmonicSolveGroups;
+		if (group.size() < 2)
+			continue;
+		SPDLOG_LOGGER_INFO(mSLog, "Frequency {:d} is solved together with {:d} other frequencies", freq, group.size() - 1);
+		mHarmonicGroupRightSide[freq] = Matrix::Zero(mRightSideVectorHarm[freq].rows(), group.size());
+		mHarmonicGroupLeftSide[freq] = Matrix::Zero(mRightSideVectorHarm[freq].rows(), group.size());
+	}
+	SPDLOG_LOGGER_INFO(mSLog, "Number of factorizations with shared symbolic analysis: {:d}", mNumSharedSymbolic);
+}
+
+template <typename VarType>
+Bool MnaSolverDirect<VarType>::isSwitchedMatrixCacheFull() const {
+	return (mSwitchedMatrixCacheSize > 0 && mSwitchedMatrixUsage.size() >= mSwitchedMatrixCacheSize)
+		|| (mSwitchedMatrixCacheMemory > 0 && mSwitchedMatrixMemory >= mSwitchedMatrixCacheMemory);
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::requireSwitchedMatrix(const std::bitset<SWITCH_NUM>& status) {
+	auto entry = mSwitchedMatrixCache.find(status);
+	if (entry != mSwitchedMatrixCache.end()) {
+		mSwitchedMatrixUsage.splice(mSwitchedMatrixUsage.begin(), mSwitchedMatrixUsage, entry->second.usage);
+		return;
+	}
+
+	SPDLOG_LOGGER_DEBUG(mSLog, "Factorize system matrix for switch status {:s}", status.to_string());
+	switchedMatrixEmpty(status.to_ullong());
+	switchedMatrixStamp(status.to_ullong(), mMNAComponents);
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::cacheSwitchedMatrix(const std::bitset<SWITCH_NUM>& status) {
+	const auto& sys = mSwitchedMatrices[status][0];
+	std::size_t memory = static_cast<std::size_t>(sys.nonZeros()) * (sizeof(Real) + sizeof(SparseMatrix::StorageIndex))
+		+ static_cast<std::size_t>(sys.outerSize() + 1) * sizeof(SparseMatrix::StorageIndex)
+		+ mDirectLinearSolvers[status][0]->factorizationMemory();
+
+	auto entry = mSwitchedMatrixCache.find(status);
+	if (entry != mSwitchedMatrixCache.end()) {
+		mSwitchedMatrixMemory -= entry->second.memory;
+		entry->second.memory = memory;
+		mSwitchedMatrixUsage.splice(mSwitchedMatrixUsage.begin(), mSwitchedMatrixUsage, entry->second.usage);
+	} else {
+		mSwitchedMatrixUsage.push_front(status);
+		mSwitchedMatrixCache[status] = { mSwitchedMatrixUsage.begin(), memory };
+	}
+	mSwitchedMatrixMemory += memory;
+
+	// Evict least recently used matrices but always keep the one just factorized
+	while (mSwitchedMatrixUsage.size() > 1 &&
+		((mSwitchedMatrixCacheSize > 0 && mSwitchedMatrixUsage.size() > mSwitchedMatrixCacheSize) ||
+		(mSwitchedMatrixCacheMemory > 0 && mSwitchedMatrixMemory > mSwitchedMatrixCacheMemory))) {
+		auto evicted = mSwitchedMatrixUsage.back();
+		SPDLOG_LOGGER_DEBUG(mSLog, "Evict system matrix for switch status {:s}", evicted.to_string());
+		mSwitchedMatrixMemory -= mSwitchedMatrixCache[evicted].memory;
+		mSwitchedMatrixCache.erase(evicted);
+		mSwitchedMatrices.erase(evicted);
+		mDirectLinearSolvers.erase(evicted);
+		mSwitchedMatrixUsage.pop_back();
+		++**mNumSwitchedMatrixEvictions;
+	}
+	**mNumCachedSwitchedMatrices = static_cast<Int>(mSwitchedMatrixUsage.size());
+}
+
+template <typename VarType>
+typename MnaSolverDirect<VarType>::LowRankSwitchUpdate* MnaSolverDirect<VarType>::requireLowRankSwitchUpdate() {
+	// Use existing factorizations directly, updates are only computed relative to a factorized base
+	if (mCurrentSwitchStatus == mLowRankBaseStatus
+		|| mSwitchedMatrixCache.find(mCurrentSwitchStatus) != mSwitchedMatrixCache.end()
+		|| mSwitchedMatrixCache.find(mLowRankBaseStatus) == mSwitchedMatrixCache.end())
+		return nullptr;
+
+	// Refactorize once too many switches differ from the base
+	if ((mCurrentSwitchStatus ^ mLowRankBaseStatus).count() > mMaxLowRankSwitchChanges)
+		return nullptr;
+
+	auto entry = mLowRankUpdateCache.find(mCurrentSwitchStatus);
+	if (entry == mLowRankUpdateCache.end()) {
+		LowRankSwitchUpdate update;
+		if (!createLowRankSwitchUpdate(mCurrentSwitchStatus, update))
+			return nullptr;
+		// Keep the base factorization from being evicted
+		requireSwitchedMatrix(mLowRankBaseStatus);
+		return cacheLowRankSwitchUpdate(mCurrentSwitchStatus, std::move(update));
+	}
+
+	requireSwitchedMatrix(mLowRankBaseStatus);
+	mLowRankUpdateUsage.splice(mLowRankUpdateUsage.begin(), mLowRankUpdateUsage, entry->second.usage);
+	return &entry->second;
+}
+
+template <typename VarType>
+typename MnaSolverDirect<VarType>::LowRankSwitchUpdate* MnaSolverDirect<VarType>::cacheLowRankSwitchUpdate(
+	const std::bitset<SWITCH_NUM>& status, LowRankSwitchUpdate&& update) {
+	update.memory = static_cast<std::size_t>(update.correction.size() + update.coupling.size()
+		+ update.capacitance.matrixLU().size() + update.reduced.size() + update.coupled.size()) * sizeof(Real)
+		+ update.indices.size() * sizeof(Eigen::Index);
+	mLowRankUpdateMemory += update.memory;
+	mLowRankUpdateUsage.push_front(status);
+	update.usage = mLowRankUpdateUsage.begin();
+	auto entry = mLowRankUpdateCache.emplace(status, std::move(update)).first;
+
+	// The updates share the limits of the switched matrix cache, the one just computed is always kept
+	while (mLowRankUpdateUsage.size() > 1 &&
+		((mSwitchedMatrixCacheSize > 0 && mLowRankUpdateUsage.size() > mSwitchedMatrixCacheSize) ||
+		(mSwitchedMatrixCacheMemory > 0 && mLowRankUpdateMemory > mSwitchedMatrixCacheMemory))) {
+		auto evicted = mLowRankUpdateUsage.back();
+		SPDLOG_LOGGER_DEBUG(mSLog, "Evict low-rank update for switch status {:s}", evicted.to_string());
+		mLowRankUpdateMemory -= mLowRankUpdateCache[evicted].memory;
+		mLowRankUpdateCache.erase(evicted);
+		mLowRankUpdateUsage.pop_back();
+	}
+	**mNumCachedLowRankUpdates = static_cast<Int>(mLowRankUpdateUsage.size());
+	return &entry->second;
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::clearLowRankSwitchUpdates() {
+	mLowRankUpdateCache.clear();
+	mLowRankUpdateUsage.clear();
+	mLowRankUpdateMemory = 0;
+	**mNumCachedLowRankUpdates = 0;
+}
+
+template <typename VarType>
+Bool MnaSolverDirect<VarType>::createLowRankSwitchUpdate(const std::bitset<SWITCH_NUM>& status, LowRankSwitchUpdate& update) {
+	const auto& baseMatrix = mSwitchedMatrices[mLowRankBaseStatus][0];
+	auto& baseSolver = *mDirectLinearSolvers[mLowRankBaseStatus][0];
+
+	// Difference of the stamps of all switches that changed their state
+	SparseMatrix added(baseMatrix.rows(), baseMatrix.cols());
+	SparseMatrix removed(baseMatrix.rows(), baseMatrix.cols());
+	for (UInt i = 0; i < mSwitches.size(); ++i) {
+		if (status[i] == mLowRankBaseStatus[i])
+			continue;
+		mSwitches[i]->mnaApplySwitchSystemMatrixStamp(status[i], added, 0);
+		mSwitches[i]->mnaApplySwitchSystemMatrixStamp(mLowRankBaseStatus[i], removed, 0);
+	}
+	SparseMatrix delta = added - removed;
+
+	update.indices.clear();
+	for (Eigen::Index row = 0; row < delta.outerSize(); ++row) {
+		for (SparseMatrix::InnerIterator it(delta, row); it; ++it) {
+			update.indices.push_back(it.row());
+			update.indices.push_back(it.col());
+		}
+	}
+	std::sort(update.indices.begin(), update.indices.end());
+	update.indices.erase(std::unique(update.indices.begin(), update.indices.end()), update.indices.end());
+
+	auto rank = static_cast<Eigen::Index>(update.indices.size());
+	auto position = [&update](Eigen::Index index) {
+		return std::lower_bound(update.indices.begin(), update.indices.end(), index) - update.indices.begin();
+	};
+
+	update.coupling = Matrix::Zero(rank, rank);
+	for (Eigen::Index row = 0; row < delta.outerSize(); ++row) {
+		for (SparseMatrix::InnerIterator it(delta, row); it; ++it)
+			update.coupling(position(it.row()), position(it.col())) += it.value();
+	}
+
+	// Solve the base system for the unit vectors of all touched rows
+	update.correction = Matrix::Zero(baseMatrix.rows(), rank);
+	Matrix unit = Matrix::Zero(baseMatrix.rows(), 1);
+	Matrix column = Matrix::Zero(baseMatrix.rows(), 1);
+	for (Eigen::Index j = 0; j < rank; ++j) {
+		unit(update.indices[j], 0) = 1;
+		baseSolver.solve(unit, column);
+		update.correction.col(j) = column;
+		unit(update.indices[j], 0) = 0;
+	}
+
+	// Capacitance matrix I + C U^T Z
+	Matrix touched(rank, rank);
+	for (Eigen::Index i = 0; i < rank; ++i)
+		touched.row(i) = update.correction.row(update.indices[i]);
+	Matrix capacitance = Matrix::Identity(rank, rank) + update.coupling * touched;
+	update.capacitance.compute(capacitance);
+
+	// A singular capacitance matrix means the switched system is singular or badly conditioned
+	if (rank > 0 && update.capacitance.rcond() < DOUBLE_EPSILON) {
+		SPDLOG_LOGGER_DEBUG(mSLog, "Low-rank update for switch status {:s} is ill-conditioned", status.to_string());
+		return false;
+	}
+
+	update.reduced = Matrix::Zero(rank, 1);
+	update.coupled = Matrix::Zero(rank, 1);
+	SPDLOG_LOGGER_DEBUG(mSLog, "Created rank {:d} update for switch status {:s}", rank, status.to_string());
+	return true;
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::solveSwitchedSystem() {
+	LowRankSwitchUpdate* update = nullptr;
+	if (hasLowRankSwitchUpdates())
+		update = requireLowRankSwitchUpdate();
+
+	if (!update && hasLazySwitchedMatrices()) {
+		requireSwitchedMatrix(mCurrentSwitchStatus);
+		// Further switch changes are applied as updates of this factorization
+		if (hasLowRankSwitchUpdates() && mCurrentSwitchStatus != mLowRankBaseStatus) {
+			mLowRankBaseStatus = mCurrentSwitchStatus;
+			clearLowRankSwitchUpdates();
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	if (update) {
+		auto& leftSideVector = **mLeftSideVector;
+		solveSystem(*mDirectLinearSolvers[mLowRankBaseStatus][0], mRightSideVector, leftSideVector);
+
+		// x = x0 - Z (I + C U^T Z)^-1 C U^T x0
+		for (std::size_t i = 0; i < update->indices.size(); ++i)
+			update->reduced(i, 0) = leftSideVector(update->indices[i], 0);
+		update->coupled.noalias() = update->coupling * update->reduced;
+		update->reduced = update->capacitance.solve(update->coupled);
+		leftSideVector.noalias() -= update->correction * update->reduced;
+		++**mNumLowRankSolves;
+	} else {
+		solveSystem(*mDirectLinearSolvers[mCurrentSwitchStatus][0], mRightSideVector, **mLeftSideVector);
+	}
+	auto end = std::chrono::steady_clock::now();
+	std::chrono::duration<Real> diff = end-start;
+	mSolveTimes.update(diff.count());
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::prewarmSwitchStates(const std::vector<SwitchStateChange>& changes) {
+	if (!hasLazySwitchedMatrices() || mSwitches.size() < 1)
+		return;
+
+	// Map the switch state attributes to the switch indices of this solver
+	std::unordered_map<const AttributeBase*, UInt> switchIndices;
+	for (UInt i = 0; i < mSwitches.size(); ++i) {
+		auto idObj = std::dynamic_pointer_cast<IdentifiedObject>(mSwitches[i]);
+		if (!idObj)
+			continue;
+		try {
+			switchIndices[idObj->attribute("is_closed").getPtr().get()] = i;
+		} catch (InvalidAttributeException &e) {
+			continue;
+		}
+	}
+
+	// Follow the scheduled changes and factorize each new switch state
+	// until the cache limits are reached
+	auto status = mCurrentSwitchStatus;
+	UInt numPrewarmed = 0;
+	for (std::size_t i = 0; i < changes.size(); ++i) {
+		auto index = switchIndices.find(changes[i].switchState.getPtr().get());
+		if (index != switchIndices.end())
+			status.set(index->second, changes[i].closed);
+
+		// Changes at the same time are applied together
+		if (i + 1 < changes.size() && changes[i + 1].time == changes[i].time)
+			continue;
+		if (mSwitchedMatrixCache.find(status) != mSwitchedMatrixCache.end())
+			continue;
+		if (isSwitchedMatrixCacheFull())
+			break;
+
+		requireSwitchedMatrix(status);
+		++numPrewarmed;
+	}
+
+	// The initial switch state is used first
+	requireSwitchedMatrix(mCurrentSwitchStatus);
+	SPDLOG_LOGGER_INFO(mSLog, "Prewarmed {:d} switched system matrices", numPrewarmed);
 }
 
 template <typename VarType>
@@ -69,42 +489,32 @@ void MnaSolverDirect<VarType>::stampVariableSystemMatrix() {
 	SPDLOG_LOGGER_INFO(mSLog, "Base matrix with only static elements: {}", Logger::matrixToString(mBaseSystemMatrix));
 	mSLog->flush();
 
-	// Continue from base matrix
-	mVariableSystemMatrix = mBaseSystemMatrix;
-
-	// Now stamp switches into matrix
-	SPDLOG_LOGGER_INFO(mSLog, "Stamping switches");
-	for (auto sw : mMNAIntfSwitches)
-		sw->mnaApplySystemMatrixStamp(mVariableSystemMatrix);
-
-	// Now stamp initial state of variable elements into matrix
-	SPDLOG_LOGGER_INFO(mSLog, "Stamping variable elements");
-	for (auto varElem : mMNAIntfVariableComps)
-		varElem->mnaApplySystemMatrixStamp(mVariableSystemMatrix);
+	// Continue from base matrix and stamp switches and initial state of variable elements
+	SPDLOG_LOGGER_INFO(mSLog, "Stamping switches and variable elements");
+	restampVariableSystemMatrix();
 
 	SPDLOG_LOGGER_INFO(mSLog, "Initial system matrix with variable elements {}", Logger::matrixToString(mVariableSystemMatrix));
 	/* TODO: find replacement for flush() */
 	mSLog->flush();
 
+	if (mStampSlotReassembly)
+		createStampSlots();
+
 	// Calculate factorization of current matrix
-	mDirectLinearSolverVariableSystemMatrix->preprocessing(mVariableSystemMatrix, mListVariableSystemMatrixEntries);
+	preprocessSystemMatrix(mVariableSystemMatrix, mDirectLinearSolverVariableSystemMatrix);
 
 	auto start = std::chrono::steady_clock::now();
 	mDirectLinearSolverVariableSystemMatrix->factorize(mVariableSystemMatrix);
 	auto end = std::chrono::steady_clock::now();
 	std::chrono::duration<Real> diff = end-start;
-	mFactorizeTimes.push_back(diff.count());
+	mFactorizeTimes.update(diff.count());
 }
 
 template <typename VarType>
 void MnaSolverDirect<VarType>::solveWithSystemMatrixRecomputation(Real time, Int timeStepCount) {
-	// Reset source vector
-	mRightSideVector.setZero();
-
 	// Add together the right side vector (computed by the components'
 	// pre-step tasks)
-	for (auto stamp : mRightVectorStamps)
-		mRightSideVector += *stamp;
+	MnaSolver<VarType>::assembleRightSideVector();
 
 	// Get switch and variable comp status and update system matrix and lu factorization accordingly
 	if (hasVariableComponentChanged())
@@ -112,10 +522,10 @@ void MnaSolverDirect<VarType>::solveWithSystemMatrixRecomputation(Real time, Int
 
 	// Calculate new solution vector
 	auto start = std::chrono::steady_clock::now();
-	**mLeftSideVector = mDirectLinearSolverVariableSystemMatrix->solve(mRightSideVector);
+	solveSystem(*mDirectLinearSolverVariableSystemMatrix, mRightSideVector, **mLeftSideVector);
 	auto end = std::chrono::steady_clock::now();
 	std::chrono::duration<Real> diff = end-start;
-	mSolveTimes.push_back(diff.count());
+	mSolveTimes.update(diff.count());
 
 	// TODO split into separate task? (dependent on x, updating all v attributes)
 	for (UInt nodeIdx = 0; nodeIdx < mNumNetNodes; ++nodeIdx)
@@ -125,7 +535,7 @@ void MnaSolverDirect<VarType>::solveWithSystemMatrixRecomputation(Real time, Int
 }
 
 template <typename VarType>
-void MnaSolverDirect<VarType>::recomputeSystemMatrix(Real time) {
+void MnaSolverDirect<VarType>::restampVariableSystemMatrix() {
 	// Start from base matrix
 	mVariableSystemMatrix = mBaseSystemMatrix;
 
@@ -136,6 +546,107 @@ void MnaSolverDirect<VarType>::recomputeSystemMatrix(Real time) {
 	// Now stamp variable elements into matrix
 	for (auto comp : mMNAIntfVariableComps)
 		comp->mnaApplySystemMatrixStamp(mVariableSystemMatrix);
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::createStampSlots() {
+	mStampSlots.clear();
+	mBaseSystemMatrixValues.clear();
+	mVariableSystemMatrix.makeCompressed();
+
+	// Position of an entry in the value array of the compressed, row major variable system matrix
+	auto valueOffset = [this](Eigen::Index row, Eigen::Index col) -> Eigen::Index {
+		auto inner = mVariableSystemMatrix.innerIndexPtr();
+		auto begin = inner + mVariableSystemMatrix.outerIndexPtr()[row];
+		auto end = inner + mVariableSystemMatrix.outerIndexPtr()[row + 1];
+		auto it = std::lower_bound(begin, end, static_cast<SparseMatrix::StorageIndex>(col));
+		if (it == end || *it != col)
+			return -1;
+		return it - inner;
+	};
+
+	mBaseSystemMatrixValues.assign(mVariableSystemMatrix.nonZeros(), 0);
+	for (Eigen::Index row = 0; row < mBaseSystemMatrix.outerSize(); ++row) {
+		for (SparseMatrix::InnerIterator it(mBaseSystemMatrix, row); it; ++it)
+			mBaseSystemMatrixValues[valueOffset(it.row(), it.col())] = it.value();
+	}
+
+	auto addStampSlots = [&](const CPS::MNAInterface::Ptr& comp) -> Bool {
+		StampSlots slots;
+		slots.stamp = SparseMatrix(mVariableSystemMatrix.rows(), mVariableSystemMatrix.cols());
+		comp->mnaApplySystemMatrixStamp(slots.stamp);
+		slots.stamp.makeCompressed();
+
+		for (Eigen::Index row = 0; row < slots.stamp.outerSize(); ++row) {
+			for (SparseMatrix::InnerIterator it(slots.stamp, row); it; ++it) {
+				Eigen::Index offset = valueOffset(it.row(), it.col());
+				if (offset < 0)
+					return false;
+				slots.offsets.push_back(offset);
+			}
+		}
+		mStampSlots.push_back(std::move(slots));
+		return true;
+	};
+
+	Bool valid = true;
+	for (auto sw : mMNAIntfSwitches)
+		valid = valid && addStampSlots(sw);
+	for (auto comp : mMNAIntfVariableComps)
+		valid = valid && addStampSlots(comp);
+
+	if (!valid) {
+		SPDLOG_LOGGER_WARN(mSLog, "Component stamp is not part of the system matrix pattern, disabling stamp slot re-assembly");
+		mStampSlots.clear();
+		mBaseSystemMatrixValues.clear();
+		mStampSlotReassembly = false;
+		return;
+	}
+	SPDLOG_LOGGER_INFO(mSLog, "Created stamp slots for {:d} switches and variable elements", mStampSlots.size());
+}
+
+template <typename VarType>
+Bool MnaSolverDirect<VarType>::stampWithSlots() {
+	Real* values = mVariableSystemMatrix.valuePtr();
+	std::copy(mBaseSystemMatrixValues.begin(), mBaseSystemMatrixValues.end(), values);
+
+	auto stampSlots = [values](const CPS::MNAInterface::Ptr& comp, StampSlots& slots) -> Bool {
+		Eigen::Index nnz = slots.stamp.nonZeros();
+		Real* stampValues = slots.stamp.valuePtr();
+		std::fill(stampValues, stampValues + nnz, 0.);
+
+		// Existing entries are overwritten in place, new entries decompress the matrix
+		comp->mnaApplySystemMatrixStamp(slots.stamp);
+		if (!slots.stamp.isCompressed() || slots.stamp.nonZeros() != nnz)
+			return false;
+
+		for (Eigen::Index k = 0; k < nnz; ++k)
+			values[slots.offsets[k]] += stampValues[k];
+		return true;
+	};
+
+	std::size_t slot = 0;
+	for (auto sw : mMNAIntfSwitches) {
+		if (!stampSlots(sw, mStampSlots[slot++]))
+			return false;
+	}
+	for (auto comp : mMNAIntfVariableComps) {
+		if (!stampSlots(comp, mStampSlots[slot++]))
+			return false;
+	}
+	return true;
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::recomputeSystemMatrix(Real time) {
+	if (!mStampSlotReassembly) {
+		restampVariableSystemMatrix();
+	} else if (!stampWithSlots()) {
+		// A stamp changed its sparsity pattern, assemble from scratch and record the new slots
+		++**mNumStampSlotFallbacks;
+		restampVariableSystemMatrix();
+		createStampSlots();
+	}
 
 	// Refactorization of matrix assuming that structure remained
 	// constant by omitting analyzePattern
@@ -143,10 +654,22 @@ void MnaSolverDirect<VarType>::recomputeSystemMatrix(Real time) {
 	mDirectLinearSolverVariableSystemMatrix->partialRefactorize(mVariableSystemMatrix, mListVariableSystemMatrixEntries);
 	auto end = std::chrono::steady_clock::now();
 	std::chrono::duration<Real> diff = end-start;
-	mRecomputationTimes.push_back(diff.count());
+	mRecomputationTimes.update(diff.count());
 	++mNumRecomputations;
 }
 
+template<>
+void MnaSolverDirect<Real>::createSwitchedMatrix(const std::bitset<SWITCH_NUM>& status) {
+	mSwitchedMatrices[status].push_back(SparseMatrix(mNumMatrixNodeIndices, mNumMatrixNodeIndices));
+	mDirectLinearSolvers[status].push_back(createDirectSolverImplementation(mSLog));
+}
+
+template<>
+void MnaSolverDirect<Complex>::createSwitchedMatrix(const std::bitset<SWITCH_NUM>& status) {
+	mSwitchedMatrices[status].push_back(SparseMatrix(2*(mNumTotalMatrixNodeIndices), 2*(mNumTotalMatrixNodeIndices)));
+	mDirectLinearSolvers[status].push_back(createDirectSolverImplementation(mSLog));
+}
+
 template<>
 void MnaSolverDirect<Real>::createEmptySystemMatrix() {
 	if (mSwitches.size() > SWITCH_NUM)
@@ -155,12 +678,9 @@ void MnaSolverDirect<Real>::createEmptySystemMatrix() {
 	if (mSystemMatrixRecomputation) {
 		mBaseSystemMatrix = SparseMatrix(mNumMatrixNodeIndices, mNumMatrixNodeIndices);
 		mVariableSystemMatrix = SparseMatrix(mNumMatrixNodeIndices, mNumMatrixNodeIndices);
-	} else {
-		for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++){
-			auto bit = std::bitset<SWITCH_NUM>(i);
-			mSwitchedMatrices[bit].push_back(SparseMatrix(mNumMatrixNodeIndices, mNumMatrixNodeIndices));
-			mDirectLinearSolvers[bit].push_back(createDirectSolverImplementation(mSLog));
-		}
+	} else if (!hasLazySwitchedMatrices()) {
+		for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++)
+			createSwitchedMatrix(std::bitset<SWITCH_NUM>(i));
 	}
 }
 
@@ -180,12 +700,9 @@ void MnaSolverDirect<Complex>::createEmptySystemMatrix() {
 	} else if (mSystemMatrixRecomputation) {
 		mBaseSystemMatrix = SparseMatrix(2*(mNumMatrixNodeIndices), 2*(mNumMatrixNodeIndices));
 		mVariableSystemMatrix = SparseMatrix(2*(mNumMatrixNodeIndices), 2*(mNumMatrixNodeIndices));
-	} else {
-		for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++) {
-			auto bit = std::bitset<SWITCH_NUM>(i);
-			mSwitchedMatrices[bit].push_back(SparseMatrix(2*(mNumTotalMatrixNodeIndices), 2*(mNumTotalMatrixNodeIndices)));
-			mDirectLinearSolvers[bit].push_back(createDirectSolverImplementation(mSLog));
-		}
+	} else if (!hasLazySwitchedMatrices()) {
+		for (std::size_t i = 0; i < (1ULL << mSwitches.size()); i++)
+			createSwitchedMatrix(std::bitset<SWITCH_NUM>(i));
 	}
 }
 
@@ -204,6 +721,9 @@ std::shared_ptr<CPS::Task> MnaSolverDirect<VarType>::createSolveTaskRecomp()
 template <typename VarType>
 std::shared_ptr<CPS::Task> MnaSolverDirect<VarType>::createSolveTaskHarm(UInt freqIdx)
 {
+	// Frequencies grouped with a lower frequency are solved by the task of that frequency
+	if (freqIdx < mHarmonicSolveGroups.size() && mHarmonicSolveGroups[freqIdx].empty())
+		return nullptr;
 	return std::make_shared<MnaSolverDirect<VarType>::SolveTaskHarm>(*this, freqIdx);
 }
 
@@ -215,23 +735,14 @@ std::shared_ptr<CPS::Task> MnaSolverDirect<VarType>::createLogTask()
 
 template <typename VarType>
 void MnaSolverDirect<VarType>::solve(Real time, Int timeStepCount) {
-	// Reset source vector
-	mRightSideVector.setZero();
-
 	// Add together the right side vector (computed by the components' pre-step tasks)
-	for (auto stamp : mRightVectorStamps)
-		mRightSideVector += *stamp;
+	MnaSolver<VarType>::assembleRightSideVector();
 
 	if (!mIsInInitialization)
 		MnaSolver<VarType>::updateSwitchStatus();
 
-	if (mSwitchedMatrices.size() > 0){
-		auto start = std::chrono::steady_clock::now();
-		**mLeftSideVector = mDirectLinearSolvers[mCurrentSwitchStatus][0]->solve(mRightSideVector);
-		auto end = std::chrono::steady_clock::now();
-		std::chrono::duration<Real> diff = end-start;
-		mSolveTimes.push_back(diff.count());
-	}
+	if (mSwitchedMatrices.size() > 0)
+		solveSwitchedSystem();
 
 	// CHECK: Is this really required? Or can operations actually become part of
 	// correctorStep and mnaPostStep?
@@ -255,9 +766,6 @@ void MnaSolverDirect<VarType>::solve(Real time, Int timeStepCount) {
 			if (numCompsRequireIter > 0){
 				mIter++;
 
-				// Reset source vector
-				mRightSideVector.setZero();
-
 				if (!mIsInInitialization)
 					MnaSolver<VarType>::updateSwitchStatus();
 
@@ -265,16 +773,10 @@ void MnaSolverDirect<VarType>::solve(Real time, Int timeStepCount) {
 					syncGen->correctorStep();
 
 				// Add together the right side vector (computed by the components' pre-step tasks)
-				for (auto stamp : mRightVectorStamps)
-					mRightSideVector += *stamp;
+				MnaSolver<VarType>::assembleRightSideVector();
 
-				if (mSwitchedMatrices.size() > 0) {
-					auto start = std::chrono::steady_clock::now();
-					**mLeftSideVector = mDirectLinearSolvers[mCurrentSwitchStatus][0]->solve(mRightSideVector);
-					auto end = std::chrono::steady_clock::now();
-					std::chrono::duration<Real> diff = end-start;
-					mSolveTimes.push_back(diff.count());
-				}
+				if (mSwitchedMatrices.size() > 0)
+					solveSwitchedSystem();
 
 				// CHECK: Is this really required? Or can operations actually become part of
 				// correctorStep and mnaPostStep?
@@ -294,13 +796,47 @@ void MnaSolverDirect<VarType>::solve(Real time, Int timeStepCount) {
 
 template <typename VarType>
 void MnaSolverDirect<VarType>::solveWithHarmonics(Real time, Int timeStepCount, Int freqIdx) {
-	mRightSideVectorHarm[freqIdx].setZero();
+	const std::vector<UInt> single = { static_cast<UInt>(freqIdx) };
+	const auto& group = mHarmonicSolveGroups.empty() ? single : mHarmonicSolveGroups[freqIdx];
 
 	// Sum of right side vectors (computed by the components' pre-step tasks)
-	for (auto stamp : mRightVectorStamps)
-		mRightSideVectorHarm[freqIdx] += stamp->col(freqIdx);
+	for (auto freq : group) {
+		mRightSideVectorHarm[freq].setZero();
+		for (auto stamp : mRightVectorStamps)
+			mRightSideVectorHarm[freq] += stamp->col(freq);
+	}
 
-	**mLeftSideVectorHarm[freqIdx] = mDirectLinearSolvers[mCurrentSwitchStatus][freqIdx]->solve(mRightSideVectorHarm[freqIdx]);
+	// Frequencies are solved in parallel, so the allocation check is not applied here
+	auto& solver = *mDirectLinearSolvers[mCurrentSwitchStatus][freqIdx];
+	if (group.size() == 1) {
+		solver.solve(mRightSideVectorHarm[freqIdx], **mLeftSideVectorHarm[freqIdx]);
+		return;
+	}
+
+	// Frequencies with identical system matrices are solved as one multi-column system
+	auto& rightSide = mHarmonicGroupRightSide[freqIdx];
+	auto& leftSide = mHarmonicGroupLeftSide[freqIdx];
+	for (std::size_t col = 0; col < group.size(); ++col)
+		rightSide.col(col) = mRightSideVectorHarm[group[col]];
+	solver.solve(rightSide, leftSide);
+	for (std::size_t col = 0; col < group.size(); ++col)
+		**mLeftSideVectorHarm[group[col]] = leftSide.col(col);
+}
+
+template <typename VarType>
+void MnaSolverDirect<VarType>::solveSystem(DirectLinearSolver& solver, const Matrix& rightSideVector, Matrix& leftSideVector) {
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+	// The solution vector must not be reallocated. Eigen's malloc check is not enabled
+	// here, as it is a process-wide flag and solvers run concurrently in parallel schedulers.
+	const Real* solutionData = leftSideVector.data();
+	solver.solve(rightSideVector, leftSideVector);
+
+	if (leftSideVector.data() != solutionData)
+		++mNumSolveAllocations;
+	assert(mNumSolveAllocations == 0);
+#else
+	solver.solve(rightSideVector, leftSideVector);
+#endif
 }
 
 template <typename VarType>
@@ -341,49 +877,42 @@ void MnaSolverDirect<VarType>::logLUTimes() {
 	logFactorizationTime();
 	logRecomputationTime();
 	logSolveTime();
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+	SPDLOG_LOGGER_INFO(mSLog, "Number of solves with allocations: {:d}", mNumSolveAllocations);
+#endif
 }
 
 template<typename VarType>
 void MnaSolverDirect<VarType>::logSolveTime(){
-	Real solveSum = 0.0;
-	Real solveMax = 0.0;
-	for(auto meas : mSolveTimes)
-	{
-		solveSum += meas;
-		if(meas > solveMax)
-			solveMax = meas;
-	}
-  	SPDLOG_LOGGER_INFO(mSLog, "Cumulative solve times: {:.12f}", solveSum);
-	SPDLOG_LOGGER_INFO(mSLog, "Average solve time: {:.12f}", solveSum/static_cast<double>(mSolveTimes.size()));
-	SPDLOG_LOGGER_INFO(mSLog, "Maximum solve time: {:.12f}", solveMax);
-	SPDLOG_LOGGER_INFO(mSLog, "Number of solves: {:d}", mSolveTimes.size());
+	mSolveTimes.log(mSLog, "solve");
 }
 
-
 template <typename VarType>
 void MnaSolverDirect<VarType>::logFactorizationTime()
 {
-	for (auto meas : mFactorizeTimes) {
+	for (auto meas : mFactorizeTimes.trace()) {
 		SPDLOG_LOGGER_INFO(mSLog, "LU factorization time: {:.12f}", meas);
 	}
+	mFactorizeTimes.log(mSLog, "LU factorization");
+	if (hasLazySwitchedMatrices()) {
+		SPDLOG_LOGGER_INFO(mSLog, "Number of cached switched system matrices: {:d}", mSwitchedMatrixUsage.size());
+		SPDLOG_LOGGER_INFO(mSLog, "Memory of cached switched system matrices: {:d} bytes", mSwitchedMatrixMemory);
+		SPDLOG_LOGGER_INFO(mSLog, "Number of evicted switched system matrices: {:d}", **mNumSwitchedMatrixEvictions);
+	}
+	if (hasLowRankSwitchUpdates()) {
+		SPDLOG_LOGGER_INFO(mSLog, "Number of cached low-rank switch updates: {:d}", mLowRankUpdateCache.size());
+		SPDLOG_LOGGER_INFO(mSLog, "Memory of cached low-rank switch updates: {:d} bytes", mLowRankUpdateMemory);
+		SPDLOG_LOGGER_INFO(mSLog, "Number of solves with low-rank switch updates: {:d}", **mNumLowRankSolves);
+	}
 }
 
 template <typename VarType>
 void MnaSolverDirect<VarType>::logRecomputationTime(){
-       Real recompSum = 0.0;
-	   Real recompMax = 0.0;
-       for (auto meas : mRecomputationTimes){
-               recompSum += meas;
-			   if(meas > recompMax)
-					recompMax = meas;
-       }
-	   // Sometimes, refactorization is not used
-	   if(mRecomputationTimes.size() != 0){
-		    SPDLOG_LOGGER_INFO(mSLog, "Cumulative refactorization times: {:.12f}",recompSum);
-       		SPDLOG_LOGGER_INFO(mSLog, "Average refactorization time: {:.12f}", recompSum/((double)mRecomputationTimes.size()));
-			SPDLOG_LOGGER_INFO(mSLog, "Maximum refactorization time: {:.12f}", recompMax);
-       		SPDLOG_LOGGER_INFO(mSLog, "Number of refactorizations: {:d}", mRecomputationTimes.size());
-	   }
+	// Sometimes, refactorization is not used
+	if (mRecomputationTimes.count() != 0)
+		mRecomputationTimes.log(mSLog, "refactorization");
+	if (mStampSlotReassembly)
+		SPDLOG_LOGGER_INFO(mSLog, "Number of stamp slot re-assembly fallbacks: {:d}", **mNumStampSlotFallbacks);
 }
 
 template<typename VarType>
@@ -394,9 +923,19 @@ std::shared_ptr<DirectLinearSolver> MnaSolverDirect<VarType>::createDirectSolver
 			return std::make_shared<DenseLUAdapter>(mSLog);
 		case DirectLinearSolverImpl::SparseLU:
 			return std::make_shared<SparseLUAdapter>(mSLog);
+		case DirectLinearSolverImpl::ParallelSparseLU:
+			return std::make_shared<ParallelSparseLUAdapter>(mSLog);
 		#ifdef WITH_KLU
 		case DirectLinearSolverImpl::KLU:
 			return std::make_shared<KLUAdapter>(mSLog);
+		case DirectLinearSolverImpl::KLUComplex:
+			if (std::is_same<VarType, Complex>::value) {
+				// Matrices of the frequency parallel solver contain a single frequency
+				UInt numFreqBlocks = mFrequencyParallel ? 1 : static_cast<UInt>(this->mSystem.mFrequencies.size());
+				return std::make_shared<KLUComplexAdapter>(mSLog, numFreqBlocks);
+			}
+			SPDLOG_LOGGER_WARN(mSLog, "KLUComplex requires a complex-valued system, using KLU instead.");
+			return std::make_shared<KLUAdapter>(mSLog);
 		#endif
 		#ifdef WITH_CUDA
 		case DirectLinearSolverImpl::CUDADense:
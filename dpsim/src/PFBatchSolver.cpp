@@ -0,0 +1,155 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#include <dpsim/PFBatchSolver.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+PFBatchSolver::PFBatchSolver(CPS::String name, const CPS::SystemTopology &system, CPS::Logger::Level logLevel)
+    : PFSolverPowerPolar(name, system, 0., logLevel) {
+    mSparseJacobian = true;
+}
+
+void PFBatchSolver::initializeBatch() {
+    setSolverAndComponentBehaviour(Solver::Behaviour::Simulation);
+    initialize();
+
+    // set-points of PV and VD buses and the flat start of the PQ buses
+    generateInitialSolution(0.);
+    mFlatStartV = sol_V;
+    mFlatStartD = sol_D;
+
+    // the symbolic analysis is done once and adopted by the workers
+    composeJacobianPattern();
+    mJacobianSolver->preprocessing(mJSparse, mJacobianVariableEntries);
+    mJacobianAnalyzed = true;
+
+    // per unit bases and branch data are collected once, so that the workers do not access components
+    mBaseVoltages.resize(mSystem.mNodes.size());
+    mNodeNames.resize(mSystem.mNodes.size());
+    for (auto node : mSystem.mNodes) {
+        mBaseVoltages(node->matrixNodeIndex()) = mBaseVoltageAtNode[node];
+        mNodeNames[node->matrixNodeIndex()] = node->name();
+    }
+    auto addBranch = [this](const String& name, MatrixComp admittance, UInt node0, UInt node1) {
+        mBranchNames.push_back(name);
+        mBranchAdmittances.push_back(admittance.rows() == 2 && admittance.cols() == 2 ? admittance : MatrixComp::Zero(2, 2));
+        mBranchNodes.emplace_back(node0, node1);
+    };
+    for (auto line : mLines)
+        addBranch(line->name(), line->Y_element(), line->node(0)->matrixNodeIndex(), line->node(1)->matrixNodeIndex());
+    for (auto trafo : mTransformers)
+        addBranch(trafo->name(), trafo->Y_element(), trafo->node(0)->matrixNodeIndex(), trafo->node(1)->matrixNodeIndex());
+
+    mBatchInitialized = true;
+}
+
+void PFBatchSolver::prepareWorker(PFBatchSolver& worker) {
+    worker.mJacobianSolver = createJacobianSolver();
+    worker.mJacobianAnalyzed = worker.mJacobianSolver->preprocessingShared(worker.mJSparse, *mJacobianSolver);
+    worker.mJacobianFactorized = false;
+}
+
+UInt PFBatchSolver::numberOfWorkers(UInt numTasks) const {
+    UInt numWorkers = mNumThreads > 0 ? mNumThreads : std::max(1u, std::thread::hardware_concurrency());
+    return std::max(1u, std::min(numWorkers, numTasks));
+}
+
+void PFBatchSolver::runWorkers(UInt numWorkers, const std::function<void(UInt)>& work) {
+    std::vector<std::exception_ptr> errors(numWorkers);
+    auto run = [&](UInt worker) {
+        try {
+            work(worker);
+        } catch (...) {
+            errors[worker] = std::current_exception();
+        }
+    };
+
+    // the calling thread is the first worker
+    std::vector<std::thread> threads;
+    for (UInt worker = 1; worker < numWorkers; ++worker)
+        threads.emplace_back(run, worker);
+    run(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+void PFBatchSolver::calculateBranchPower(const VectorComp& voltages, UInt branch, Complex& from, Complex& to) const {
+    Complex v0 = voltages.coeff(mBranchNodes[branch].first);
+    Complex v1 = voltages.coeff(mBranchNodes[branch].second);
+    const MatrixComp& Y = mBranchAdmittances[branch];
+    from = v0 * std::conj(Y(0, 0) * v0 + Y(0, 1) * v1);
+    to = v1 * std::conj(Y(1, 0) * v0 + Y(1, 1) * v1);
+}
+
+PFBatchResult PFBatchSolver::solve(const Matrix& activePower, const Matrix& reactivePower) {
+    if (!mBatchInitialized)
+        initializeBatch();
+
+    UInt numNodes = static_cast<UInt>(mSystem.mNodes.size());
+    if (static_cast<UInt>(activePower.rows()) != numNodes || static_cast<UInt>(reactivePower.rows()) != numNodes
+        || activePower.cols() != reactivePower.cols())
+        throw SystemError("Power set-points of the powerflow batch require one row per node and equal numbers of columns.");
+
+    UInt numSnapshots = static_cast<UInt>(activePower.cols());
+    UInt numBranches = static_cast<UInt>(mBranchNames.size());
+
+    PFBatchResult result;
+    result.nodeNames = mNodeNames;
+    result.branchNames = mBranchNames;
+    result.voltages.resize(numNodes, numSnapshots);
+    result.branchPowerFrom.resize(numBranches, numSnapshots);
+    result.branchPowerTo.resize(numBranches, numSnapshots);
+    result.iterations.assign(numSnapshots, -1);
+
+    UInt numWorkers = numberOfWorkers(numSnapshots);
+    std::atomic<UInt> nextSnapshot(0);
+
+    runWorkers(numWorkers, [&](UInt) {
+        PFBatchSolver worker(*this);
+        prepareWorker(worker);
+
+        Bool converged = false;
+        VectorComp voltages(numNodes);
+        for (UInt snapshot = nextSnapshot++; snapshot < numSnapshots; snapshot = nextSnapshot++) {
+            // a warm start continues from the last snapshot of this worker if that one converged
+            if (!mWarmStart || !converged) {
+                worker.sol_V = mFlatStartV;
+                worker.sol_D = mFlatStartD;
+                worker.mJacobianFactorized = false;
+            }
+            worker.Pesp = activePower.col(snapshot) / mBaseApparentPower;
+            worker.Qesp = reactivePower.col(snapshot) / mBaseApparentPower;
+
+            converged = worker.solvePowerflow();
+            if (converged)
+                result.iterations[snapshot] = static_cast<Int>(worker.mIterations);
+
+            voltages = worker.sol_V.binaryExpr(worker.sol_D, [](Real v, Real d) { return std::polar(v, d); });
+            for (UInt branch = 0; branch < numBranches; ++branch) {
+                Complex from, to;
+                calculateBranchPower(voltages, branch, from, to);
+                result.branchPowerFrom(branch, snapshot) = from * mBaseApparentPower;
+                result.branchPowerTo(branch, snapshot) = to * mBaseApparentPower;
+            }
+            result.voltages.col(snapshot) = voltages.cwiseProduct(mBaseVoltages.cast<Complex>());
+        }
+    });
+
+    SPDLOG_LOGGER_INFO(mSLog, "Solved {} powerflow snapshots with {} threads", numSnapshots, numWorkers);
+    return result;
+}
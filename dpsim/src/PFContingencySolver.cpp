@@ -0,0 +1,329 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include <dpsim/PFContingencySolver.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+PFContingencySolver::PFContingencySolver(CPS::String name, const CPS::SystemTopology &system, CPS::Logger::Level logLevel)
+    : PFBatchSolver(name, system, logLevel) { }
+
+void PFContingencySolver::solveBaseCase() {
+    if (!mBatchInitialized)
+        initializeBatch();
+
+    generateInitialSolution(0.);
+    if (!solvePowerflow())
+        throw SystemError("Base case of the contingency analysis did not converge.");
+
+    // the last mismatch calculation left the injections of the base case
+    calculateJacobianSparse();
+    mBaseJacobian = mJSparse;
+    mBaseV = sol_V;
+    mBaseD = sol_D;
+
+    UInt numBranches = static_cast<UInt>(mBranchNames.size());
+    VectorComp voltages = sol_V.binaryExpr(sol_D, [](Real v, Real d) { return std::polar(v, d); });
+    mBaseFlowFrom.resize(numBranches);
+    mBaseFlowTo.resize(numBranches);
+    mBranchLimitsPerUnit.setZero(numBranches);
+    mBranchSusceptances.setZero(numBranches);
+    for (UInt branch = 0; branch < numBranches; ++branch) {
+        calculateBranchPower(voltages, branch, mBaseFlowFrom(branch), mBaseFlowTo(branch));
+
+        auto limit = mBranchLimits.find(mBranchNames[branch]);
+        if (limit != mBranchLimits.end())
+            mBranchLimitsPerUnit(branch) = limit->second / mBaseApparentPower;
+
+        // series reactance, the impedance magnitude for purely resistive branches
+        Complex seriesAdmittance = -mBranchAdmittances[branch](0, 1);
+        if (std::abs(seriesAdmittance) > DOUBLE_EPSILON) {
+            Complex impedance = 1. / seriesAdmittance;
+            Real reactance = std::abs(impedance.imag()) > DOUBLE_EPSILON ? impedance.imag() : std::abs(impedance);
+            mBranchSusceptances(branch) = 1. / reactance;
+        }
+    }
+    for (auto& limit : mBranchLimits)
+        if (std::find(mBranchNames.begin(), mBranchNames.end(), limit.first) == mBranchNames.end())
+            SPDLOG_LOGGER_WARN(mSLog, "Limit for unknown branch {} is ignored", limit.first);
+
+    composeSusceptanceMatrix();
+}
+
+void PFContingencySolver::composeSusceptanceMatrix() {
+    Int npqpv = mNumPQBuses + mNumPVBuses;
+
+    std::vector<Eigen::Triplet<Real>> triplets;
+    triplets.reserve(npqpv + 4 * mBranchNames.size());
+    for (Int a = 0; a < npqpv; ++a)
+        triplets.emplace_back(a, a, 0.);
+    for (UInt branch = 0; branch < mBranchNames.size(); ++branch) {
+        Int a = mAngleIndex[mBranchNodes[branch].first];
+        Int b = mAngleIndex[mBranchNodes[branch].second];
+        Real susceptance = mBranchSusceptances(branch);
+        if (a >= 0)
+            triplets.emplace_back(a, a, susceptance);
+        if (b >= 0)
+            triplets.emplace_back(b, b, susceptance);
+        if (a >= 0 && b >= 0) {
+            triplets.emplace_back(a, b, -susceptance);
+            triplets.emplace_back(b, a, -susceptance);
+        }
+    }
+    mSusceptanceMatrix = SparseMatrix(npqpv, npqpv);
+    mSusceptanceMatrix.setFromTriplets(triplets.begin(), triplets.end());
+    mSusceptanceMatrix.makeCompressed();
+}
+
+void PFContingencySolver::prepareContingencyWorker(PFContingencySolver& worker) {
+    prepareWorker(worker);
+    // the Newton fallback starts far from the base case, so the Jacobian is refactorized in each iteration
+    worker.mJacobianReuseRatio = 0.;
+
+    worker.mBaseJacobianSolver = createJacobianSolver();
+    if (!worker.mBaseJacobianSolver->preprocessingShared(worker.mBaseJacobian, *mJacobianSolver))
+        worker.mBaseJacobianSolver->preprocessing(worker.mBaseJacobian, worker.mJacobianVariableEntries);
+    worker.mBaseJacobianSolver->factorize(worker.mBaseJacobian);
+
+    std::vector<std::pair<UInt, UInt>> noVariableEntries;
+    worker.mSusceptanceSolver = createJacobianSolver();
+    worker.mSusceptanceSolver->preprocessing(worker.mSusceptanceMatrix, noVariableEntries);
+    worker.mSusceptanceSolver->factorize(worker.mSusceptanceMatrix);
+}
+
+Bool PFContingencySolver::screenOutage(UInt branch, Real& estimatedLoading) {
+    estimatedLoading = 0.;
+    if (mBranchSusceptances(branch) == 0.)
+        return true;
+
+    // angles caused by a unit transfer across the outaged branch
+    UInt npqpv = mNumPQBuses + mNumPVBuses;
+    Matrix transfer = Matrix::Zero(npqpv, 1);
+    Matrix angles(npqpv, 1);
+    Int a = mAngleIndex[mBranchNodes[branch].first];
+    Int b = mAngleIndex[mBranchNodes[branch].second];
+    if (a >= 0)
+        transfer(a) = 1.;
+    if (b >= 0)
+        transfer(b) = -1.;
+    mSusceptanceSolver->solve(transfer, angles);
+
+    auto angle = [&](UInt node) { return mAngleIndex[node] < 0 ? 0. : angles(mAngleIndex[node]); };
+    auto distribution = [&](UInt other) {
+        return mBranchSusceptances(other) * (angle(mBranchNodes[other].first) - angle(mBranchNodes[other].second));
+    };
+
+    // the whole transfer flows across a branch connecting two islands
+    Real remaining = 1. - distribution(branch);
+    if (std::abs(remaining) < 1e-6)
+        return false;
+
+    Real outageFlow = mBaseFlowFrom(branch).real();
+    for (UInt other = 0; other < mBranchNames.size(); ++other) {
+        if (other == branch || mBranchLimitsPerUnit(other) <= 0.)
+            continue;
+        // line outage distribution factor applied to the active flow, the reactive flow is kept
+        Real deltaP = distribution(other) / remaining * outageFlow;
+        Real loading = std::max(std::abs(mBaseFlowFrom(other) + deltaP), std::abs(mBaseFlowTo(other) - deltaP));
+        estimatedLoading = std::max(estimatedLoading, loading / mBranchLimitsPerUnit(other));
+    }
+    return true;
+}
+
+Bool PFContingencySolver::solveCompensated(UInt branch, Int& iterations) {
+    UInt npqpv = mNumPQBuses + mNumPVBuses;
+
+    // only the Jacobian rows and columns of the terminal buses differ from the base case
+    std::vector<Int> changed;
+    for (UInt node : { mBranchNodes[branch].first, mBranchNodes[branch].second }) {
+        Int a = mAngleIndex[node];
+        if (a < 0 || std::find(changed.begin(), changed.end(), a) != changed.end())
+            continue;
+        changed.push_back(a);
+        if (a < static_cast<Int>(mNumPQBuses))
+            changed.push_back(a + npqpv);
+    }
+    Int rank = static_cast<Int>(changed.size());
+
+    calculateMismatch();
+    if (checkConvergence())
+        return true;
+
+    // Woodbury update (J0 + E D E^T)^-1 = J0^-1 - Z (I + D E^T Z)^-1 D E^T J0^-1 with Z = J0^-1 E
+    calculateJacobianSparse();
+    Matrix D(rank, rank);
+    for (Int p = 0; p < rank; ++p)
+        for (Int q = 0; q < rank; ++q)
+            D(p, q) = mJSparse.coeff(changed[p], changed[q]) - mBaseJacobian.coeff(changed[p], changed[q]);
+
+    Matrix Z(mNumUnknowns, rank);
+    Matrix unit = Matrix::Zero(mNumUnknowns, 1);
+    Matrix column(mNumUnknowns, 1);
+    for (Int p = 0; p < rank; ++p) {
+        unit(changed[p]) = 1.;
+        mBaseJacobianSolver->solve(unit, column);
+        Z.col(p) = column;
+        unit(changed[p]) = 0.;
+    }
+    Matrix capacitance = Matrix::Identity(rank, rank);
+    for (Int q = 0; q < rank; ++q)
+        for (Int p = 0; p < rank; ++p)
+            capacitance.col(q) += D.col(p) * Z(changed[p], q);
+    Eigen::FullPivLU<Matrix> capacitanceLU(capacitance);
+    if (rank > 0 && !capacitanceLU.isInvertible())
+        return false;
+
+    Real initialMismatch = mF.lpNorm<Eigen::Infinity>();
+    Matrix changedIncrement(rank, 1);
+    for (UInt i = 1; i <= mCompensationIterations; ++i) {
+        mBaseJacobianSolver->solve(mF, mX);
+        if (rank > 0) {
+            for (Int p = 0; p < rank; ++p)
+                changedIncrement(p) = mX(changed[p]);
+            mX.noalias() -= Z * capacitanceLU.solve(D * changedIncrement);
+        }
+        updateSolution();
+        calculateMismatch();
+        iterations = static_cast<Int>(i);
+
+        if (checkConvergence())
+            return true;
+        Real mismatch = mF.lpNorm<Eigen::Infinity>();
+        if (!std::isfinite(mismatch) || mismatch > 10. * initialMismatch)
+            return false;
+    }
+    return false;
+}
+
+void PFContingencySolver::verifyOutage(UInt branch, PFContingencyResult& result) {
+    UInt nodes[2] = { mBranchNodes[branch].first, mBranchNodes[branch].second };
+    const MatrixComp& admittance = mBranchAdmittances[branch];
+
+    // remove the branch from the admittance matrix in place, its pattern and thus the Jacobian pattern are kept
+    auto offset = [this](Int row, Int col) {
+        const Int* begin = mY.innerIndexPtr() + mY.outerIndexPtr()[row];
+        const Int* end = mY.innerIndexPtr() + mY.outerIndexPtr()[row + 1];
+        return std::lower_bound(begin, end, col) - mY.innerIndexPtr();
+    };
+    for (Int r = 0; r < 2; ++r)
+        for (Int c = 0; c < 2; ++c)
+            mY.valuePtr()[offset(nodes[r], nodes[c])] -= admittance(r, c);
+
+    sol_V = mBaseV;
+    sol_D = mBaseD;
+    Int iterations = 0;
+    try {
+        result.converged = solveCompensated(branch, iterations);
+        if (!result.converged) {
+            SPDLOG_LOGGER_DEBUG(mSLog, "Compensated iterations for outage of {} did not converge", mBranchNames[branch]);
+            sol_V = mBaseV;
+            sol_D = mBaseD;
+            result.converged = PFSolver::solvePowerflow();
+            iterations += static_cast<Int>(mIterations);
+        }
+    } catch (const std::exception& e) {
+        SPDLOG_LOGGER_DEBUG(mSLog, "Powerflow for outage of {} failed: {}", mBranchNames[branch], e.what());
+        result.converged = false;
+    }
+
+    for (Int r = 0; r < 2; ++r)
+        for (Int c = 0; c < 2; ++c)
+            mY.valuePtr()[offset(nodes[r], nodes[c])] += admittance(r, c);
+
+    result.iterations = iterations;
+    if (!result.converged) {
+        result.severity = std::numeric_limits<Real>::infinity();
+        return;
+    }
+
+    for (UInt node = 0; node < mNodeNames.size(); ++node) {
+        Real voltage = sol_V.coeff(node);
+        if (voltage < mMinVoltage) {
+            result.violations.push_back({ PFContingencyViolation::Type::Undervoltage, mNodeNames[node], voltage, mMinVoltage });
+            result.severity += mMinVoltage - voltage;
+        }
+        else if (voltage > mMaxVoltage) {
+            result.violations.push_back({ PFContingencyViolation::Type::Overvoltage, mNodeNames[node], voltage, mMaxVoltage });
+            result.severity += voltage - mMaxVoltage;
+        }
+    }
+
+    VectorComp voltages = sol_V.binaryExpr(sol_D, [](Real v, Real d) { return std::polar(v, d); });
+    for (UInt other = 0; other < mBranchNames.size(); ++other) {
+        Real limit = mBranchLimitsPerUnit(other);
+        if (other == branch || limit <= 0.)
+            continue;
+        Complex from, to;
+        calculateBranchPower(voltages, other, from, to);
+        Real loading = std::max(std::abs(from), std::abs(to));
+        if (loading > limit) {
+            result.violations.push_back({ PFContingencyViolation::Type::BranchOverload, mBranchNames[other],
+                loading * mBaseApparentPower, limit * mBaseApparentPower });
+            result.severity += loading / limit - 1.;
+        }
+    }
+}
+
+std::vector<PFContingencyResult> PFContingencySolver::analyze() {
+    solveBaseCase();
+
+    UInt numBranches = static_cast<UInt>(mBranchNames.size());
+    std::vector<PFContingencyResult> results(numBranches);
+    // without limits the screening cannot rule out any outage
+    Bool screening = (mBranchLimitsPerUnit.array() > 0.).any();
+
+    UInt numWorkers = numberOfWorkers(numBranches);
+    std::atomic<UInt> nextOutage(0);
+
+    runWorkers(numWorkers, [&](UInt) {
+        PFContingencySolver worker(*this);
+        prepareContingencyWorker(worker);
+
+        for (UInt branch = nextOutage++; branch < numBranches; branch = nextOutage++) {
+            PFContingencyResult& result = results[branch];
+            result.outage = mBranchNames[branch];
+            if (!worker.screenOutage(branch, result.estimatedLoading)) {
+                result.islanding = true;
+                result.severity = std::numeric_limits<Real>::infinity();
+                continue;
+            }
+            // the screening only estimates branch loadings, the voltages of these outages remain unchecked
+            if (screening && result.estimatedLoading < mScreeningThreshold)
+                continue;
+            result.verified = true;
+            worker.verifyOutage(branch, result);
+        }
+    });
+
+    std::stable_sort(results.begin(), results.end(), [](const PFContingencyResult& a, const PFContingencyResult& b) {
+        if (a.severity != b.severity)
+            return a.severity > b.severity;
+        return a.estimatedLoading > b.estimatedLoading;
+    });
+
+    UInt numVerified = static_cast<UInt>(std::count_if(results.begin(), results.end(),
+        [](const PFContingencyResult& result) { return result.verified; }));
+    UInt numScreenedOut = static_cast<UInt>(std::count_if(results.begin(), results.end(),
+        [](const PFContingencyResult& result) { return !result.verified && !result.islanding; }));
+    SPDLOG_LOGGER_INFO(mSLog, "Analyzed {} outages with {} threads, {} verified with the AC powerflow, "
+        "{} only screened for branch overloads", numBranches, numWorkers, numVerified, numScreenedOut);
+    SPDLOG_LOGGER_INFO(mSLog, "Rank\tOutage\tSeverity\tEstimated loading\tViolations");
+    for (UInt rank = 0; rank < results.size(); ++rank) {
+        const PFContingencyResult& result = results[rank];
+        if (result.severity <= 0.)
+            break;
+        String status = result.islanding ? "islanding" : (!result.converged ? "not converged" : std::to_string(result.violations.size()));
+        SPDLOG_LOGGER_INFO(mSLog, "{}\t{}\t{}\t{}\t{}", rank + 1, result.outage, result.severity, result.estimatedLoading, status);
+    }
+    return results;
+}
@@ -8,13 +8,21 @@
 
 #include <dpsim/PFSolver.h>
 #include <dpsim/SequentialScheduler.h>
+#include <dpsim/DenseLUAdapter.h>
+#include <dpsim/SparseLUAdapter.h>
+#include <dpsim/ParallelSparseLUAdapter.h>
+#ifdef WITH_KLU
+#include <dpsim/KLUAdapter.h>
+#endif
 #include <iostream>
 
 using namespace DPsim;
 using namespace CPS;
 
 PFSolver::PFSolver(CPS::String name, CPS::SystemTopology system, CPS::Real timeStep, CPS::Logger::Level logLevel) :
-	Solver(name + "_PF", logLevel) {
+	Solver(name + "_PF", logLevel),
+	mNumIterations(create<Int>("iterations", 0)),
+	mNumFactorizations(create<Int>("factorizations", 0)) {
 	mSystem = system;
 	mTimeStep = timeStep;
 }
@@ -48,9 +56,51 @@ void PFSolver::initialize(){
 	determineNodeBaseVoltages();
     composeAdmittanceMatrix();
 
-	mJ.setZero(mNumUnknowns,mNumUnknowns);
-	mX.setZero(mNumUnknowns);
-	mF.setZero(mNumUnknowns);
+	mX.setZero(mNumUnknowns, 1);
+	mF.setZero(mNumUnknowns, 1);
+	// the dense Jacobian keeps the SparseLU solver it was always factorized with
+	mJacobianSolver = mSparseJacobian ? createJacobianSolver() : std::make_shared<SparseLUAdapter>(mSLog);
+	resetJacobian();
+}
+
+void PFSolver::resetJacobian() {
+	mJacobianAnalyzed = false;
+	mJacobianFactorized = false;
+}
+
+std::shared_ptr<DirectLinearSolver> PFSolver::createJacobianSolver() {
+	DirectLinearSolverImpl implementation = mJacobianSolverImpl;
+	if (implementation == DirectLinearSolverImpl::Undef) {
+#ifdef WITH_KLU
+		implementation = mSparseJacobian ? DirectLinearSolverImpl::KLU : DirectLinearSolverImpl::SparseLU;
+#else
+		implementation = DirectLinearSolverImpl::SparseLU;
+#endif
+	}
+
+	std::shared_ptr<DirectLinearSolver> solver;
+	switch (implementation) {
+		case DirectLinearSolverImpl::DenseLU:
+			solver = std::make_shared<DenseLUAdapter>(mSLog);
+			break;
+		case DirectLinearSolverImpl::SparseLU:
+			solver = std::make_shared<SparseLUAdapter>(mSLog);
+			break;
+		case DirectLinearSolverImpl::ParallelSparseLU:
+			solver = std::make_shared<ParallelSparseLUAdapter>(mSLog);
+			break;
+#ifdef WITH_KLU
+		case DirectLinearSolverImpl::KLU:
+			solver = std::make_shared<KLUAdapter>(mSLog);
+			break;
+#endif
+		default:
+			SPDLOG_LOGGER_WARN(mSLog, "Linear solver implementation is not supported by the powerflow solver, using SparseLU instead.");
+			solver = std::make_shared<SparseLUAdapter>(mSLog);
+	}
+
+	solver->setConfiguration(mJacobianSolverConfiguration);
+	return solver;
 }
 
 void PFSolver::assignMatrixNodeIndices() {
@@ -339,6 +389,7 @@ void PFSolver::composeAdmittanceMatrix() {
 		for(auto shunt : mShunts) {
 			shunt->pfApplyAdmittanceMatrixStamp(mY);
 		}
+		mY.makeCompressed();
 	}
 	if(mLines.empty() && mTransformers.empty()) {
 		throw std::invalid_argument("There are no bus");
@@ -354,14 +405,37 @@ CPS::Real PFSolver::B(int i, int j) {
 }
 
 CPS::Bool PFSolver::checkConvergence() {
-	// Converged if all mismatches are below the tolerance
+	// Converged if all mismatches are below the tolerance, NaN mismatches of a diverged solution are not
     for (CPS::UInt i = 0; i < mNumUnknowns; i++) {
-        if (abs(mF(i)) > mTolerance)
+        if (!(abs(mF(i)) <= mTolerance))
             return false;
 	}
     return true;
 }
 
+void PFSolver::factorizeJacobian() {
+	if (mSparseJacobian) {
+		// The pattern of the Jacobian only depends on the topology,
+		// so the symbolic analysis is reused by all later iterations
+		if (!mJacobianAnalyzed) {
+			mJacobianSolver->preprocessing(mJSparse, mJacobianVariableEntries);
+			mJacobianAnalyzed = true;
+			mJacobianFactorized = false;
+		}
+		if (mJacobianFactorized)
+			mJacobianSolver->refactorize(mJSparse);
+		else
+			mJacobianSolver->factorize(mJSparse);
+	}
+	else {
+		mJSparse = mJ.sparseView();
+		mJacobianSolver->preprocessing(mJSparse, mJacobianVariableEntries);
+		mJacobianSolver->factorize(mJSparse);
+	}
+	mJacobianFactorized = true;
+	++mStepFactorizations;
+}
+
 Bool PFSolver::solvePowerflow() {
 	// Calculate the mismatch according to the initial solution
     calculateMismatch();
@@ -370,15 +444,20 @@ Bool PFSolver::solvePowerflow() {
     isConverged = checkConvergence();
 
     mIterations = 0;
+    mStepFactorizations = 0;
+    // A Jacobian factorized in an earlier iteration or time step is kept
+    // as long as the mismatch decreases fast enough
+    Bool updateJacobian = mJacobianReuseRatio <= 0 || !mJacobianFactorized;
+    Real mismatchNorm = isConverged ? 0. : mF.lpNorm<Eigen::Infinity>();
     for (unsigned i = 1; i < mMaxIterations && !isConverged; ++i) {
 
-        calculateJacobian();
-		auto sparseJ = mJ.sparseView();
-
-		// Solve system mJ*mX = mF
-        Eigen::SparseLU<SparseMatrix>lu(sparseJ);
+        if (updateJacobian) {
+            calculateJacobian();
+            factorizeJacobian();
+        }
 
-		mX = lu.solve(mF);	/* code */
+		// Solve system mJ*mX = mF into the preallocated solution vector
+		mJacobianSolver->solve(mF, mX);
 
 		// Calculate new solution based on mX increments obtained from equation system
 		updateSolution();
@@ -389,6 +468,10 @@ Bool PFSolver::solvePowerflow() {
 		SPDLOG_LOGGER_DEBUG(mSLog, "Mismatch vector at iteration {}: \n {}", i, mF);
 		mSLog->flush();
 
+        Real previousMismatchNorm = mismatchNorm;
+        mismatchNorm = mF.lpNorm<Eigen::Infinity>();
+        updateJacobian = mismatchNorm > mJacobianReuseRatio * previousMismatchNorm;
+
 		// Check convergence
         isConverged = checkConvergence();
         mIterations = i;
@@ -397,10 +480,15 @@ Bool PFSolver::solvePowerflow() {
 }
 
 void PFSolver::SolveTask::execute(Real time, Int timeStepCount) {
-	// apply keepLastSolution to save computation time
-    mSolver.generateInitialSolution(time);
+	// warm start keeps the voltages of the last time step as initial solution
+    mSolver.generateInitialSolution(time, mSolver.mWarmStart);
 	mSolver.solvePowerflow();
 	mSolver.setSolution();
+
+	**mSolver.mNumIterations = static_cast<Int>(mSolver.mIterations);
+	**mSolver.mNumFactorizations = mSolver.mStepFactorizations;
+	SPDLOG_LOGGER_DEBUG(mSolver.mSLog, "Time {}: {} iterations, {} Jacobian factorizations",
+		time, mSolver.mIterations, mSolver.mStepFactorizations);
 }
 
 Task::List PFSolver::getTasks() {
@@ -0,0 +1,135 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <dpsim/PFSolverFastDecoupled.h>
+
+using namespace DPsim;
+using namespace CPS;
+
+PFSolverFastDecoupled::PFSolverFastDecoupled(CPS::String name, const CPS::SystemTopology &system, CPS::Real timeStep, CPS::Logger::Level logLevel)
+    : PFSolverPowerPolar(name, system, timeStep, logLevel) {
+    // the iterations converge linearly
+    mMaxIterations = 50;
+}
+
+void PFSolverFastDecoupled::initialize() {
+    PFSolver::initialize();
+    composeDecoupledMatrices();
+
+    std::vector<std::pair<UInt, UInt>> noVariableEntries;
+    mBPrimeSolver = createJacobianSolver();
+    mBPrimeSolver->preprocessing(mBPrime, noVariableEntries);
+    mBPrimeSolver->factorize(mBPrime);
+    if (mNumPQBuses > 0) {
+        mBDoublePrimeSolver = createJacobianSolver();
+        mBDoublePrimeSolver->preprocessing(mBDoublePrime, noVariableEntries);
+        mBDoublePrimeSolver->factorize(mBDoublePrime);
+    }
+
+    mDeltaP.setZero(mNumPQBuses + mNumPVBuses, 1);
+    mDeltaD.setZero(mNumPQBuses + mNumPVBuses, 1);
+    mDeltaQ.setZero(mNumPQBuses, 1);
+    mDeltaV.setZero(mNumPQBuses, 1);
+}
+
+void PFSolverFastDecoupled::composeDecoupledMatrices() {
+    Int npqpv = mNumPQBuses + mNumPVBuses;
+    Int npq = mNumPQBuses;
+
+    mAngleIndex.assign(mY.rows(), -1);
+    for (Int a = 0; a < npqpv; ++a)
+        mAngleIndex[mPQPVBusIndices[a]] = a;
+
+    std::vector<Eigen::Triplet<Real>> bPrime;
+    std::vector<Eigen::Triplet<Real>> bDoublePrime;
+    bPrime.reserve(mY.nonZeros());
+    bDoublePrime.reserve(mY.nonZeros());
+
+    for (Int k = 0; k < mY.outerSize(); ++k) {
+        Int a = mAngleIndex[k];
+        if (a < 0)
+            continue;
+
+        Real diagPrime = 0., diagDoublePrime = 0.;
+        // susceptance of the shunts at the bus (row sum of the admittance matrix)
+        Real shunt = 0.;
+        for (Int p = mY.outerIndexPtr()[k]; p < mY.outerIndexPtr()[k + 1]; ++p) {
+            Int j = mY.innerIndexPtr()[p];
+            Complex y = mY.valuePtr()[p];
+            shunt += y.imag();
+            if (j == k || y == Complex(0., 0.))
+                continue;
+
+            // series susceptance of the branches with and without resistance
+            Real susceptance = y.imag();
+            Real reactance = (Complex(-1., 0.) / y).imag();
+            Real susceptanceNoResistance = std::abs(reactance) > DOUBLE_EPSILON ? 1. / reactance : susceptance;
+
+            Real sPrime = mVariant == FastDecoupledVariant::XB ? susceptanceNoResistance : susceptance;
+            Real sDoublePrime = mVariant == FastDecoupledVariant::XB ? susceptance : susceptanceNoResistance;
+            diagPrime += sPrime;
+            diagDoublePrime += sDoublePrime;
+
+            Int b = mAngleIndex[j];
+            if (b < 0)
+                continue;
+            bPrime.emplace_back(a, b, -sPrime);
+            if (a < npq && b < npq)
+                bDoublePrime.emplace_back(a, b, -sDoublePrime);
+        }
+
+        // shunts and transformer ratios are only considered in B''
+        bPrime.emplace_back(a, a, diagPrime);
+        if (a < npq)
+            bDoublePrime.emplace_back(a, a, diagDoublePrime - shunt);
+    }
+
+    mBPrime = SparseMatrix(npqpv, npqpv);
+    mBPrime.setFromTriplets(bPrime.begin(), bPrime.end());
+    mBPrime.makeCompressed();
+    mBDoublePrime = SparseMatrix(npq, npq);
+    mBDoublePrime.setFromTriplets(bDoublePrime.begin(), bDoublePrime.end());
+    mBDoublePrime.makeCompressed();
+
+    SPDLOG_LOGGER_INFO(mSLog, "Fast-decoupled matrices ({}): B' with {} nonzeros, B'' with {} nonzeros",
+        mVariant == FastDecoupledVariant::XB ? "XB" : "BX", mBPrime.nonZeros(), mBDoublePrime.nonZeros());
+}
+
+Bool PFSolverFastDecoupled::solvePowerflow() {
+    UInt npqpv = mNumPQBuses + mNumPVBuses;
+
+    calculateMismatch();
+    isConverged = checkConvergence();
+
+    mIterations = 0;
+    for (UInt i = 1; i < mMaxIterations && !isConverged; ++i) {
+        // P-angle half iteration
+        for (UInt a = 0; a < npqpv; ++a)
+            mDeltaP(a) = mF(a) / sol_V.coeff(mPQPVBusIndices[a]);
+        mBPrimeSolver->solve(mDeltaP, mDeltaD);
+        for (UInt a = 0; a < npqpv; ++a)
+            sol_D(mPQPVBusIndices[a]) += mDeltaD(a);
+        calculateMismatch();
+
+        // Q-magnitude half iteration
+        if (mNumPQBuses > 0) {
+            for (UInt a = 0; a < mNumPQBuses; ++a)
+                mDeltaQ(a) = mF(a + npqpv) / sol_V.coeff(mPQPVBusIndices[a]);
+            mBDoublePrimeSolver->solve(mDeltaQ, mDeltaV);
+            for (UInt a = 0; a < mNumPQBuses; ++a)
+                sol_V(mPQPVBusIndices[a]) += mDeltaV(a);
+            calculateMismatch();
+        }
+
+        SPDLOG_LOGGER_DEBUG(mSLog, "Mismatch vector at iteration {}: \n {}", i, mF);
+
+        isConverged = checkConvergence();
+        mIterations = i;
+    }
+    return isConverged;
+}
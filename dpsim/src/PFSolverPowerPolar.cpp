@@ -6,6 +6,8 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  *********************************************************************************/
 
+#include <algorithm>
+
 #include <dpsim/PFSolverPowerPolar.h>
 
 using namespace DPsim;
@@ -15,8 +17,19 @@ PFSolverPowerPolar::PFSolverPowerPolar(CPS::String name, const CPS::SystemTopolo
     : PFSolver(name, system, timeStep, logLevel){ }
 
 void PFSolverPowerPolar::generateInitialSolution(Real time, bool keep_last_solution) {
-	resize_sol(mSystem.mNodes.size());
-	resize_complex_sol(mSystem.mNodes.size());
+	// voltages of the last solution are only kept if it converged to finite values, otherwise a flat start
+	// is used, the power set-points are always rebuilt
+	if (!keep_last_solution || !solutionInitialized || sol_V.size() != static_cast<Int>(mSystem.mNodes.size())
+		|| !isConverged || !sol_V.allFinite() || !sol_D.allFinite()) {
+		keep_last_solution = false;
+		resize_sol(mSystem.mNodes.size());
+		resize_complex_sol(mSystem.mNodes.size());
+	}
+	else {
+		sol_P.setZero();
+		sol_Q.setZero();
+		sol_S_complex.setZero();
+	}
 
     // update all components for the new time
     for (auto comp : mSystem.mComponents) {
@@ -141,6 +154,8 @@ void PFSolverPowerPolar::calculateMismatch() {
     UInt k;
     mF.setZero();
 
+    calculatePowerInjection();
+
     for (UInt a = 0; a < npqpv; ++a) {
         // For PQ and PV buses calculate active power mismatch
         k = mPQPVBusIndices[a];
@@ -153,12 +168,17 @@ void PFSolverPowerPolar::calculateMismatch() {
 }
 
 void PFSolverPowerPolar::calculateJacobian() {
+    if (mSparseJacobian) {
+        calculateJacobianSparse();
+        return;
+    }
+
     UInt npqpv = mNumPQBuses + mNumPVBuses;
     double val;
     UInt k, j;
     UInt da, db;
 
-    mJ.setZero();
+    mJ.setZero(mNumUnknowns, mNumUnknowns);
 
     //J1
     for (UInt a = 0; a < npqpv; ++a) { //rows
@@ -252,6 +272,134 @@ void PFSolverPowerPolar::calculateJacobian() {
     }
 }
 
+void PFSolverPowerPolar::resetJacobian() {
+    PFSolver::resetJacobian();
+    mJacobianOffsets.clear();
+    mJacobianDiagonalOffsets.clear();
+}
+
+void PFSolverPowerPolar::composeJacobianPattern() {
+    Int npqpv = mNumPQBuses + mNumPVBuses;
+    Int npq = mNumPQBuses;
+
+    mAngleIndex.assign(mY.rows(), -1);
+    for (Int a = 0; a < npqpv; ++a)
+        mAngleIndex[mPQPVBusIndices[a]] = a;
+
+    // Each branch couples the angles and the PQ magnitudes of its buses in all four blocks
+    std::vector<Eigen::Triplet<Real>> triplets;
+    triplets.reserve(4 * mY.nonZeros() + 4 * npqpv);
+    for (Int a = 0; a < npqpv; ++a) {
+        triplets.emplace_back(a, a, 0.);
+        if (a < npq) {
+            triplets.emplace_back(a, a + npqpv, 0.);
+            triplets.emplace_back(a + npqpv, a, 0.);
+            triplets.emplace_back(a + npqpv, a + npqpv, 0.);
+        }
+    }
+    for (Int k = 0; k < mY.outerSize(); ++k) {
+        Int a = mAngleIndex[k];
+        if (a < 0)
+            continue;
+        for (Int p = mY.outerIndexPtr()[k]; p < mY.outerIndexPtr()[k + 1]; ++p) {
+            Int b = mAngleIndex[mY.innerIndexPtr()[p]];
+            if (b < 0 || b == a)
+                continue;
+            triplets.emplace_back(a, b, 0.);
+            if (b < npq)
+                triplets.emplace_back(a, b + npqpv, 0.);
+            if (a < npq)
+                triplets.emplace_back(a + npqpv, b, 0.);
+            if (a < npq && b < npq)
+                triplets.emplace_back(a + npqpv, b + npqpv, 0.);
+        }
+    }
+    mJSparse = SparseMatrix(mNumUnknowns, mNumUnknowns);
+    mJSparse.setFromTriplets(triplets.begin(), triplets.end());
+    mJSparse.makeCompressed();
+
+    auto offset = [this](Int row, Int col) {
+        const Int* begin = mJSparse.innerIndexPtr() + mJSparse.outerIndexPtr()[row];
+        const Int* end = mJSparse.innerIndexPtr() + mJSparse.outerIndexPtr()[row + 1];
+        return static_cast<Int>(std::lower_bound(begin, end, col) - mJSparse.innerIndexPtr());
+    };
+
+    mJacobianOffsets.assign(4 * mY.nonZeros(), -1);
+    for (Int k = 0; k < mY.outerSize(); ++k) {
+        Int a = mAngleIndex[k];
+        if (a < 0)
+            continue;
+        for (Int p = mY.outerIndexPtr()[k]; p < mY.outerIndexPtr()[k + 1]; ++p) {
+            Int b = mAngleIndex[mY.innerIndexPtr()[p]];
+            if (b < 0 || b == a)
+                continue;
+            mJacobianOffsets[4 * p] = offset(a, b);
+            if (b < npq)
+                mJacobianOffsets[4 * p + 1] = offset(a, b + npqpv);
+            if (a < npq)
+                mJacobianOffsets[4 * p + 2] = offset(a + npqpv, b);
+            if (a < npq && b < npq)
+                mJacobianOffsets[4 * p + 3] = offset(a + npqpv, b + npqpv);
+        }
+    }
+
+    mJacobianDiagonalOffsets.assign(4 * npqpv, -1);
+    for (Int a = 0; a < npqpv; ++a) {
+        mJacobianDiagonalOffsets[4 * a] = offset(a, a);
+        if (a < npq) {
+            mJacobianDiagonalOffsets[4 * a + 1] = offset(a, a + npqpv);
+            mJacobianDiagonalOffsets[4 * a + 2] = offset(a + npqpv, a);
+            mJacobianDiagonalOffsets[4 * a + 3] = offset(a + npqpv, a + npqpv);
+        }
+    }
+
+    SPDLOG_LOGGER_INFO(mSLog, "Sparse Jacobian with {} unknowns and {} nonzeros", mNumUnknowns, mJSparse.nonZeros());
+}
+
+void PFSolverPowerPolar::calculateJacobianSparse() {
+    if (mJacobianOffsets.empty())
+        composeJacobianPattern();
+
+    UInt npqpv = mNumPQBuses + mNumPVBuses;
+    Real* J = mJSparse.valuePtr();
+    const Complex* Y = mY.valuePtr();
+
+    for (UInt a = 0; a < npqpv; ++a) {
+        UInt k = mPQPVBusIndices[a];
+        Complex Vk = mVoltageRect.coeff(k);
+        Real Gkk = 0., Bkk = 0.;
+
+        for (Int p = mY.outerIndexPtr()[k]; p < mY.outerIndexPtr()[k + 1]; ++p) {
+            Int j = mY.innerIndexPtr()[p];
+            if (j == static_cast<Int>(k)) {
+                Gkk = Y[p].real();
+                Bkk = Y[p].imag();
+                continue;
+            }
+
+            // Vk*Vj*(cos(Dk-Dj) + j*sin(Dk-Dj)) without evaluating trigonometric functions
+            Complex w = Vk * std::conj(mVoltageRect.coeff(j));
+            Real gcbs = Y[p].real() * w.real() + Y[p].imag() * w.imag();
+            Real gsbc = Y[p].real() * w.imag() - Y[p].imag() * w.real();
+
+            const Int* o = &mJacobianOffsets[4 * p];
+            if (o[0] >= 0) J[o[0]] = gsbc;
+            if (o[1] >= 0) J[o[1]] = gcbs;
+            if (o[2] >= 0) J[o[2]] = -gcbs;
+            if (o[3] >= 0) J[o[3]] = gsbc;
+        }
+
+        Real Vk2 = std::norm(Vk);
+        const Int* d = &mJacobianDiagonalOffsets[4 * a];
+        J[d[0]] = -Q(k) - Bkk * Vk2;
+        if (a < mNumPQBuses) {
+            J[d[1]] = P(k) + Gkk * Vk2;
+            J[d[2]] = P(k) - Gkk * Vk2;
+            J[d[3]] = Q(k) - Bkk * Vk2;
+        }
+    }
+}
+
 void PFSolverPowerPolar::updateSolution() {
     UInt npqpv = mNumPQBuses + mNumPVBuses;
     UInt k;
@@ -347,24 +495,10 @@ void PFSolverPowerPolar::calculateNodalInjection() {
 	}
 }
 
-Real PFSolverPowerPolar::P(UInt k) {
-    Real val = 0.0;
-    for (UInt j = 0; j < mSystem.mNodes.size(); ++j) {
-        val += sol_V.coeff(j)
-                *(G(k, j) * cos(sol_D.coeff(k) - sol_D.coeff(j))
-                + B(k, j) * sin(sol_D.coeff(k) - sol_D.coeff(j)));
-    }
-    return sol_V.coeff(k) * val;
-}
-
-Real PFSolverPowerPolar::Q(UInt k) {
-    Real val = 0.0;
-    for (UInt j = 0; j < mSystem.mNodes.size(); ++j) {
-        val += sol_V.coeff(j)
-                *(G(k, j) * sin(sol_D.coeff(k) - sol_D.coeff(j))
-                - B(k, j) * cos(sol_D.coeff(k) - sol_D.coeff(j)));
-    }
-    return sol_V.coeff(k) * val;
+void PFSolverPowerPolar::calculatePowerInjection() {
+    mVoltageRect = sol_V.binaryExpr(sol_D, [](Real v, Real d) { return std::polar(v, d); });
+    mCurrentInjection.noalias() = mY * mVoltageRect;
+    mPowerInjection = mVoltageRect.cwiseProduct(mCurrentInjection.conjugate());
 }
 
 void PFSolverPowerPolar::calculatePAndQAtSlackBus() {
@@ -372,11 +506,8 @@ void PFSolverPowerPolar::calculatePAndQAtSlackBus() {
     for (auto topoNode: mVDBuses) {
         auto node_idx = topoNode->matrixNodeIndex();
 
-        // calculate power flowing out of the node into the admittance matrix (i.e. S_inj)
-        CPS::Complex I(0.0, 0.0);
-        for (UInt j = 0; j < mSystem.mNodes.size(); ++j)
-            I += mY.coeff(node_idx, j) * sol_Vcx(j);
-        CPS::Complex S = sol_Vcx(node_idx) * conj(I);
+        // power flowing out of the node into the admittance matrix (i.e. S_inj)
+        CPS::Complex S = mPowerInjection.coeff(node_idx);
 
         // add load power to obtain generator power (S_gen = S_inj + S_load)
         for(auto comp : mSystem.mComponentsAtNode[topoNode])
@@ -414,11 +545,8 @@ void PFSolverPowerPolar::calculateQAtPVBuses() {
     for (auto topoNode: mPVBuses) {
         auto node_idx = topoNode->matrixNodeIndex();
 
-        // calculate power flowing out of the node into the admittance matrix (i.e. S_inj)
-        CPS::Complex I(0.0, 0.0);
-        for (UInt j = 0; j < mSystem.mNodes.size(); ++j)
-            I += mY.coeff(node_idx, j) * sol_Vcx(j);
-        Complex S = sol_Vcx(node_idx) * conj(I);
+        // power flowing out of the node into the admittance matrix (i.e. S_inj)
+        Complex S = mPowerInjection.coeff(node_idx);
 
         // add load power to obtain generator power (S_gen = S_inj + S_load)
         auto Sgen = S;
@@ -448,11 +576,8 @@ void PFSolverPowerPolar::calculatePAndQInjectionPQBuses() {
     for (auto topoNode: mPQBuses) {
         auto node_idx = topoNode->matrixNodeIndex();
 
-        // calculate power flowing out of the node into the admittance matrix (i.e. S_inj)
-        CPS::Complex I(0.0, 0.0);
-        for (UInt j = 0; j < mSystem.mNodes.size(); ++j)
-            I += mY.coeff(node_idx, j) * sol_Vcx(j);
-        CPS::Complex S = sol_Vcx(node_idx) * conj(I);
+        // power flowing out of the node into the admittance matrix (i.e. S_inj)
+        CPS::Complex S = mPowerInjection.coeff(node_idx);
 
         // Subtracting shunt power to obtain power injection flowing from this node to the other nodes (i.e. S_inj_to_other)
         CPS::Real V =  sol_V.coeff(node_idx);
@@ -0,0 +1,466 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include <Eigen/OrderingMethods>
+
+#include <dpsim/ParallelSparseLUAdapter.h>
+
+#ifdef WITH_OPENMP
+	#include <omp.h>
+#endif
+
+using namespace DPsim;
+
+namespace
+{
+/* calls func(item, thread) for all items, level by level. Items of the same level
+ * are independent and distributed over the threads, levels are separated by barriers */
+template <typename Func>
+void forEachLevel(const std::vector<Int> &levels, const std::vector<Int> &items, Int numThreads, Bool parallel, Func func)
+{
+#ifdef WITH_OPENMP
+	#pragma omp parallel num_threads(numThreads) if(parallel)
+	{
+		Int thread = omp_get_thread_num();
+		for (std::size_t level = 0; level + 1 < levels.size(); ++level)
+		{
+			#pragma omp for schedule(static)
+			for (Int idx = levels[level]; idx < levels[level + 1]; ++idx)
+				func(items[idx], thread);
+		}
+	}
+#else
+	/* items are stored in level order, so a plain loop respects all dependencies */
+	for (Int item : items)
+		func(item, 0);
+#endif
+}
+
+/* groups the indices by level, keeping ascending indices within a level */
+void createLevels(const std::vector<Int> &level, std::vector<Int> &levels, std::vector<Int> &items)
+{
+	Int numLevels = level.empty() ? 0 : *std::max_element(level.begin(), level.end()) + 1;
+	levels.assign(numLevels + 1, 0);
+	for (Int l : level)
+		++levels[l + 1];
+	for (Int l = 0; l < numLevels; ++l)
+		levels[l + 1] += levels[l];
+
+	std::vector<Int> next(levels.begin(), levels.end() - 1);
+	items.resize(level.size());
+	for (std::size_t idx = 0; idx < level.size(); ++idx)
+		items[next[level[idx]]++] = static_cast<Int>(idx);
+}
+
+/* transposes the pattern of a compressed column matrix and records the source position of each entry */
+void transposePattern(Int n, const std::vector<Int> &colPtr, const std::vector<Int> &rowIdx,
+	std::vector<Int> &rowPtr, std::vector<Int> &colIdx, std::vector<Int> &source)
+{
+	rowPtr.assign(n + 1, 0);
+	for (Int i : rowIdx)
+		++rowPtr[i + 1];
+	for (Int i = 0; i < n; ++i)
+		rowPtr[i + 1] += rowPtr[i];
+
+	std::vector<Int> next(rowPtr.begin(), rowPtr.end() - 1);
+	colIdx.resize(rowIdx.size());
+	source.resize(rowIdx.size());
+	for (Int j = 0; j < n; ++j)
+	{
+		for (Int p = colPtr[j]; p < colPtr[j + 1]; ++p)
+		{
+			Int pos = next[rowIdx[p]]++;
+			colIdx[pos] = j;
+			source[pos] = p;
+		}
+	}
+}
+}
+
+namespace DPsim
+{
+ParallelSparseLUAdapter::ParallelSparseLUAdapter()
+{
+	setNumberOfThreads(0);
+}
+
+ParallelSparseLUAdapter::ParallelSparseLUAdapter(CPS::Logger::Log log) : ParallelSparseLUAdapter()
+{
+	this->mSLog = log;
+}
+
+ParallelSparseLUAdapter::~ParallelSparseLUAdapter()
+{
+	if (mSLog)
+		SPDLOG_LOGGER_INFO(mSLog, "Number of Pivot Faults: {}", mPivotFaults);
+}
+
+void ParallelSparseLUAdapter::setNumberOfThreads(Int numThreads)
+{
+#ifdef WITH_OPENMP
+	mNumThreads = numThreads > 0 ? numThreads : omp_get_max_threads();
+#else
+	mNumThreads = 1;
+#endif
+	if (!mWork.empty())
+		mWork.assign(mNumThreads, std::vector<Real>(mN, 0.));
+}
+
+void ParallelSparseLUAdapter::preprocessing(SparseMatrix &systemMatrix,
+	std::vector<std::pair<UInt, UInt>> &listVariableSystemMatrixEntries)
+{
+	systemMatrix.makeCompressed();
+	mN = Eigen::internal::convert_index<Int>(systemMatrix.rows());
+	nnz = Eigen::internal::convert_index<Int>(systemMatrix.nonZeros());
+
+	/* AMD ordering on the pattern of A + A^T, the columns are eliminated in this order */
+	Eigen::SparseMatrix<Real, Eigen::ColMajor, Int> pattern = systemMatrix;
+	Eigen::AMDOrdering<Int> ordering;
+	Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, Int> permutation;
+	ordering(pattern, permutation);
+	mColPerm.assign(permutation.indices().data(), permutation.indices().data() + mN);
+
+	std::vector<Int> colPermInv(mN);
+	for (Int k = 0; k < mN; ++k)
+		colPermInv[mColPerm[k]] = k;
+
+	/* the column-permuted matrix is stored column-wise, referencing the values of the row-major system matrix */
+	const auto outer = systemMatrix.outerIndexPtr();
+	const auto inner = systemMatrix.innerIndexPtr();
+	mBColPtr.assign(mN + 1, 0);
+	for (Int p = 0; p < nnz; ++p)
+		++mBColPtr[colPermInv[inner[p]] + 1];
+	for (Int k = 0; k < mN; ++k)
+		mBColPtr[k + 1] += mBColPtr[k];
+
+	std::vector<Int> next(mBColPtr.begin(), mBColPtr.end() - 1);
+	mBRowIdx.resize(nnz);
+	mBValueOffsets.resize(nnz);
+	for (Int row = 0; row < mN; ++row)
+	{
+		for (Int p = outer[row]; p < outer[row + 1]; ++p)
+		{
+			Int pos = next[colPermInv[inner[p]]]++;
+			mBRowIdx[pos] = row;
+			mBValueOffsets[pos] = p;
+		}
+	}
+
+	/* no valid factorization until factorize is called */
+	mLColPtr.clear();
+}
+
+Int ParallelSparseLUAdapter::reach(Int k, std::vector<Int> &stack, std::vector<char> &marked,
+	const std::vector<Int> &lColPtr, const std::vector<Int> &lRowIdx) const
+{
+	/* depth-first search in the graph of L starting at the rows of B(:,k). The first half
+	 * of the stack holds the search path, the second half the position within each column */
+	Int top = mN;
+	for (Int p = mBColPtr[k]; p < mBColPtr[k + 1]; ++p)
+	{
+		if (marked[mBRowIdx[p]])
+			continue;
+
+		Int head = 0;
+		stack[0] = mBRowIdx[p];
+		while (head >= 0)
+		{
+			Int j = stack[head];
+			Int pivot = mRowPermInv[j];
+			if (!marked[j])
+			{
+				marked[j] = 1;
+				stack[mN + head] = pivot < 0 ? 0 : lColPtr[pivot];
+			}
+
+			Bool done = true;
+			Int end = pivot < 0 ? 0 : lColPtr[pivot + 1];
+			for (Int q = stack[mN + head]; q < end; ++q)
+			{
+				Int i = lRowIdx[q];
+				if (marked[i])
+					continue;
+				stack[mN + head] = q;
+				stack[++head] = i;
+				done = false;
+				break;
+			}
+
+			if (done)
+			{
+				--head;
+				stack[--top] = j;
+			}
+		}
+	}
+
+	for (Int p = top; p < mN; ++p)
+		marked[stack[p]] = 0;
+	return top;
+}
+
+void ParallelSparseLUAdapter::factorize(SparseMatrix &systemMatrix)
+{
+	if (systemMatrix.nonZeros() != nnz || systemMatrix.rows() != mN || mBColPtr.empty())
+	{
+		std::vector<std::pair<UInt, UInt>> noVariableEntries;
+		preprocessing(systemMatrix, noVariableEntries);
+	}
+
+	const Real *values = systemMatrix.valuePtr();
+
+	/* L is built with original row indices, which are mapped to pivot order at the end */
+	std::vector<Int> lColPtr(1, 0);
+	std::vector<Int> lRowIdx;
+	std::vector<Real> lValues;
+	std::vector<std::pair<Int, Real>> uColumn;
+	mUColPtr.assign(1, 0);
+	mURowIdx.clear();
+	mUValues.clear();
+	mUDiag.assign(mN, 0.);
+	mRowPerm.assign(mN, -1);
+	mRowPermInv.assign(mN, -1);
+
+	std::vector<Real> x(mN, 0.);
+	std::vector<Int> stack(2 * mN);
+	std::vector<char> marked(mN, 0);
+
+	for (Int k = 0; k < mN; ++k)
+	{
+		/* sparse triangular solve x = L \ B(:,k) */
+		Int top = reach(k, stack, marked, lColPtr, lRowIdx);
+		for (Int p = mBColPtr[k]; p < mBColPtr[k + 1]; ++p)
+			x[mBRowIdx[p]] += values[mBValueOffsets[p]];
+		for (Int px = top; px < mN; ++px)
+		{
+			Int j = stack[px];
+			Int pivot = mRowPermInv[j];
+			if (pivot < 0)
+				continue;
+			for (Int p = lColPtr[pivot]; p < lColPtr[pivot + 1]; ++p)
+				x[lRowIdx[p]] -= lValues[p] * x[j];
+		}
+
+		/* entries in pivotal rows belong to U, the largest remaining entry is the pivot candidate */
+		Int pivotRow = -1;
+		Real largest = -1;
+		uColumn.clear();
+		for (Int px = top; px < mN; ++px)
+		{
+			Int i = stack[px];
+			if (mRowPermInv[i] >= 0)
+				uColumn.emplace_back(mRowPermInv[i], x[i]);
+			else if (std::abs(x[i]) > largest)
+			{
+				largest = std::abs(x[i]);
+				pivotRow = i;
+			}
+		}
+		if (pivotRow < 0 || !(largest > 0))
+			throw CPS::SystemError("System matrix is singular, no pivot found in column " + std::to_string(mColPerm[k]));
+
+		/* prefer the diagonal to keep the fill-reducing ordering intact */
+		Int diagonal = mColPerm[k];
+		if (mRowPermInv[diagonal] < 0 && std::abs(x[diagonal]) >= mPivotTolerance * largest)
+			pivotRow = diagonal;
+
+		Real pivot = x[pivotRow];
+		mUDiag[k] = pivot;
+		mRowPermInv[pivotRow] = k;
+		mRowPerm[k] = pivotRow;
+
+		for (Int px = top; px < mN; ++px)
+		{
+			Int i = stack[px];
+			if (mRowPermInv[i] < 0)
+			{
+				lRowIdx.push_back(i);
+				lValues.push_back(x[i] / pivot);
+			}
+			x[i] = 0;
+		}
+		lColPtr.push_back(static_cast<Int>(lRowIdx.size()));
+
+		/* ascending rows are a valid elimination order for the refactorization */
+		std::sort(uColumn.begin(), uColumn.end(),
+			[](const std::pair<Int, Real> &a, const std::pair<Int, Real> &b) { return a.first < b.first; });
+		for (auto &entry : uColumn)
+		{
+			mURowIdx.push_back(entry.first);
+			mUValues.push_back(entry.second);
+		}
+		mUColPtr.push_back(static_cast<Int>(mURowIdx.size()));
+	}
+
+	for (Int &i : lRowIdx)
+		i = mRowPermInv[i];
+	mLColPtr = std::move(lColPtr);
+	mLRowIdx = std::move(lRowIdx);
+	mLValues = std::move(lValues);
+
+	mBPivotRow.resize(mBRowIdx.size());
+	for (std::size_t p = 0; p < mBRowIdx.size(); ++p)
+		mBPivotRow[p] = mRowPermInv[mBRowIdx[p]];
+
+	mWork.assign(mNumThreads, std::vector<Real>(mN, 0.));
+	createSchedules();
+	updateRowValues();
+}
+
+void ParallelSparseLUAdapter::refactorize(SparseMatrix &systemMatrix)
+{
+	if (systemMatrix.nonZeros() != nnz || mLColPtr.empty())
+	{
+		factorize(systemMatrix);
+		return;
+	}
+
+	const Real *values = systemMatrix.valuePtr();
+	std::atomic<bool> pivotFault(false);
+
+	/* the pivot sequence is kept, so column k only depends on the columns j in the pattern of U(:,k) */
+	forEachLevel(mFactorLevels, mFactorLevelItems, mNumThreads, useParallelLevels(), [&](Int k, Int thread) {
+		auto &x = mWork[thread];
+		for (Int p = mBColPtr[k]; p < mBColPtr[k + 1]; ++p)
+			x[mBPivotRow[p]] += values[mBValueOffsets[p]];
+
+		for (Int q = mUColPtr[k]; q < mUColPtr[k + 1]; ++q)
+		{
+			Int j = mURowIdx[q];
+			Real xj = x[j];
+			x[j] = 0;
+			mUValues[q] = xj;
+			for (Int p = mLColPtr[j]; p < mLColPtr[j + 1]; ++p)
+				x[mLRowIdx[p]] -= mLValues[p] * xj;
+		}
+
+		Real pivot = x[k];
+		x[k] = 0;
+		Real largest = std::abs(pivot);
+		for (Int p = mLColPtr[k]; p < mLColPtr[k + 1]; ++p)
+			largest = std::max(largest, std::abs(x[mLRowIdx[p]]));
+		if (!(std::abs(pivot) > 0) || std::abs(pivot) < mPivotTolerance * largest || !std::isfinite(pivot))
+			pivotFault = true;
+
+		mUDiag[k] = pivot;
+		for (Int p = mLColPtr[k]; p < mLColPtr[k + 1]; ++p)
+		{
+			Int i = mLRowIdx[p];
+			mLValues[p] = x[i] / pivot;
+			x[i] = 0;
+		}
+	});
+
+	if (pivotFault)
+	{
+		/* pivot became too small => factorize again with partial pivoting */
+		mPivotFaults++;
+		factorize(systemMatrix);
+		return;
+	}
+	updateRowValues();
+}
+
+void ParallelSparseLUAdapter::partialRefactorize(SparseMatrix &systemMatrix,
+	std::vector<std::pair<UInt, UInt>> &listVariableSystemMatrixEntries)
+{
+	refactorize(systemMatrix);
+}
+
+Matrix ParallelSparseLUAdapter::solve(Matrix &rightSideVector)
+{
+	Matrix x;
+	solve(rightSideVector, x);
+	return x;
+}
+
+void ParallelSparseLUAdapter::solve(const Matrix &rightSideVector, Matrix &leftSideVector)
+{
+	/* does not allocate if the sizes did not change since the last solve */
+	leftSideVector.resize(rightSideVector.rows(), rightSideVector.cols());
+	mSolveBuffer.resize(mN);
+	Real *y = mSolveBuffer.data();
+	const Bool parallel = useParallelLevels();
+
+	for (Eigen::Index col = 0; col < rightSideVector.cols(); ++col)
+	{
+		for (Int k = 0; k < mN; ++k)
+			y[k] = rightSideVector(mRowPerm[k], col);
+
+		forEachLevel(mForwardLevels, mForwardLevelItems, mNumThreads, parallel, [&](Int i, Int) {
+			Real sum = y[i];
+			for (Int m = mLRowPtr[i]; m < mLRowPtr[i + 1]; ++m)
+				sum -= mLRowValues[m] * y[mLColIdx[m]];
+			y[i] = sum;
+		});
+
+		forEachLevel(mBackwardLevels, mBackwardLevelItems, mNumThreads, parallel, [&](Int i, Int) {
+			Real sum = y[i];
+			for (Int m = mURowPtr[i]; m < mURowPtr[i + 1]; ++m)
+				sum -= mURowValues[m] * y[mUColIdx[m]];
+			y[i] = sum / mUDiag[i];
+		});
+
+		for (Int k = 0; k < mN; ++k)
+			leftSideVector(mColPerm[k], col) = y[k];
+	}
+}
+
+std::size_t ParallelSparseLUAdapter::factorizationMemory() const
+{
+	/* L and U are stored column- and row-wise, each entry with a value and an index */
+	std::size_t entries = mLValues.size() + mUValues.size();
+	return 2 * entries * (sizeof(Real) + sizeof(Int)) + mUDiag.size() * sizeof(Real);
+}
+
+void ParallelSparseLUAdapter::createSchedules()
+{
+	std::vector<Int> level(mN, 0);
+
+	/* refactorization: column k waits for all columns in the pattern of U(:,k) */
+	for (Int k = 0; k < mN; ++k)
+		for (Int q = mUColPtr[k]; q < mUColPtr[k + 1]; ++q)
+			level[k] = std::max(level[k], level[mURowIdx[q]] + 1);
+	createLevels(level, mFactorLevels, mFactorLevelItems);
+
+	/* forward substitution: row i of L waits for all rows j < i it references */
+	transposePattern(mN, mLColPtr, mLRowIdx, mLRowPtr, mLColIdx, mLRowSource);
+	std::fill(level.begin(), level.end(), 0);
+	for (Int i = 0; i < mN; ++i)
+		for (Int m = mLRowPtr[i]; m < mLRowPtr[i + 1]; ++m)
+			level[i] = std::max(level[i], level[mLColIdx[m]] + 1);
+	createLevels(level, mForwardLevels, mForwardLevelItems);
+
+	/* backward substitution: row i of U waits for all rows j > i it references */
+	transposePattern(mN, mUColPtr, mURowIdx, mURowPtr, mUColIdx, mURowSource);
+	std::fill(level.begin(), level.end(), 0);
+	for (Int i = mN - 1; i >= 0; --i)
+		for (Int m = mURowPtr[i]; m < mURowPtr[i + 1]; ++m)
+			level[i] = std::max(level[i], level[mUColIdx[m]] + 1);
+	createLevels(level, mBackwardLevels, mBackwardLevelItems);
+
+	mLRowValues.resize(mLRowSource.size());
+	mURowValues.resize(mURowSource.size());
+
+	if (mSLog)
+		SPDLOG_LOGGER_DEBUG(mSLog, "Parallel LU levels (factorization/forward/backward): {}/{}/{} for {} columns",
+			mFactorLevels.size() - 1, mForwardLevels.size() - 1, mBackwardLevels.size() - 1, mN);
+}
+
+void ParallelSparseLUAdapter::updateRowValues()
+{
+	for (std::size_t m = 0; m < mLRowSource.size(); ++m)
+		mLRowValues[m] = mLValues[mLRowSource[m]];
+	for (std::size_t m = 0; m < mURowSource.size(); ++m)
+		mURowValues[m] = mUValues[mURowSource[m]];
+}
+}
@@ -0,0 +1,131 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <dpsim/RingBufferResultWriter.h>
+
+using namespace DPsim;
+
+namespace {
+	template<typename T>
+	void append(std::vector<char>& buffer, T value) {
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	void appendString(std::vector<char>& buffer, const String& value) {
+		std::uint16_t length = static_cast<std::uint16_t>(std::min<std::size_t>(value.size(), UINT16_MAX));
+		append(buffer, length);
+		buffer.insert(buffer.end(), value.begin(), value.begin() + length);
+	}
+
+	std::size_t alignUp(std::size_t size, std::size_t alignment) {
+		return (size + alignment - 1) / alignment * alignment;
+	}
+
+	enum State : std::uint32_t { RUNNING = 1, CLOSED = 2 };
+
+	// offsets of the fields in the header that change while running
+	constexpr std::size_t STATE_OFFSET = 20;
+	constexpr std::size_t SEQUENCE_OFFSET = 32;
+	constexpr std::size_t ROWS_OFFSET = 40;
+}
+
+RingBufferResultWriter::RingBufferResultWriter(const fs::path& filename, UInt capacity) :
+	mFilename(filename),
+	mCapacity(capacity > 0 ? capacity : 1) { }
+
+RingBufferResultWriter::~RingBufferResultWriter() {
+	close();
+}
+
+void RingBufferResultWriter::open(const std::vector<String>& names, const std::vector<String>& units) {
+#ifdef __linux__
+	mNumColumns = static_cast<UInt>(names.size());
+
+	std::vector<char> header;
+	header.insert(header.end(), "DPSIMRNG", "DPSIMRNG" + 8);
+	append<std::uint32_t>(header, VERSION);
+	append<std::uint32_t>(header, mNumColumns);
+	append<std::uint32_t>(header, mCapacity);
+	append<std::uint32_t>(header, RUNNING);
+	append<std::uint64_t>(header, 0);
+	append<std::uint64_t>(header, 0);
+	append<std::uint64_t>(header, 0);
+	for (UInt column = 0; column < mNumColumns; ++column) {
+		appendString(header, names[column]);
+		appendString(header, column < units.size() ? units[column] : "");
+	}
+	std::uint64_t headerSize = alignUp(header.size(), 64);
+	std::memcpy(header.data() + 24, &headerSize, sizeof(headerSize));
+	header.resize(headerSize, 0);
+
+	mSize = headerSize + static_cast<std::size_t>(mCapacity) * (mNumColumns + 1) * sizeof(Real);
+
+	// a new file, so that readers of a previous run keep their mapping of the old one
+	::unlink(mFilename.c_str());
+	int fd = ::open(mFilename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		throw CPS::SystemError("Cannot open result file " + mFilename.string());
+	if (::ftruncate(fd, static_cast<off_t>(mSize)) != 0) {
+		::close(fd);
+		throw CPS::SystemError("Cannot resize result file " + mFilename.string());
+	}
+	void* mapped = ::mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED)
+		throw CPS::SystemError("Cannot map result file " + mFilename.string());
+
+	mMapped = static_cast<char*>(mapped);
+	std::memcpy(mMapped, header.data(), header.size());
+	mSequence = new (mMapped + SEQUENCE_OFFSET) std::atomic<std::uint64_t>(0);
+	mRowsWritten = new (mMapped + ROWS_OFFSET) std::atomic<std::uint64_t>(0);
+	mRows = reinterpret_cast<Real*>(mMapped + headerSize);
+	mRowCount = 0;
+#else
+	throw CPS::SystemError("Ring buffer results are only supported on Linux");
+#endif
+}
+
+void RingBufferResultWriter::write(Real time, const Real* values) {
+	if (!mMapped)
+		return;
+
+	Real* row = mRows + (mRowCount % mCapacity) * (mNumColumns + 1);
+	mSequence->store(2 * mRowCount + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	row[0] = time;
+	std::memcpy(row + 1, values, mNumColumns * sizeof(Real));
+	++mRowCount;
+	mRowsWritten->store(mRowCount, std::memory_order_release);
+	mSequence->store(2 * mRowCount, std::memory_order_release);
+}
+
+void RingBufferResultWriter::close() {
+#ifdef __linux__
+	if (!mMapped)
+		return;
+
+	std::uint32_t state = CLOSED;
+	std::memcpy(mMapped + STATE_OFFSET, &state, sizeof(state));
+	::munmap(mMapped, mSize);
+	mMapped = nullptr;
+	mSequence = nullptr;
+	mRowsWritten = nullptr;
+	mRows = nullptr;
+#endif
+}
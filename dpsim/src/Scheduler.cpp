@@ -21,12 +21,12 @@ CPS::AttributeBase::Ptr Scheduler::external;
 void Scheduler::initMeasurements(const Task::List& tasks) {
 	// Fill map here already since it's not protected by a mutex
 	for (auto task : tasks) {
-		mMeasurements[task.get()] = std::vector<TaskTime>();
+		mMeasurements[task.get()].reset();
 	}
 }
 
 void Scheduler::updateMeasurement(Task* ptr, TaskTime time) {
-	mMeasurements[ptr].push_back(time);
+	mMeasurements[ptr].update(std::chrono::duration<Real>(time).count());
 }
 
 void Scheduler::writeMeasurements(String filename) {
@@ -62,16 +62,8 @@ void Scheduler::readMeasurements(String filename, std::unordered_map<String, Tas
 }
 
 Scheduler::TaskTime Scheduler::getAveragedMeasurement(CPS::Task* task) {
-	TaskTime avg(0), tot(0);
-
-	for (TaskTime time : mMeasurements[task]) {
-		tot += time;
-	}
-
-	if (!mMeasurements[task].empty())
-		avg = tot / mMeasurements[task].size();
-
-	return avg;
+	auto avg = std::chrono::duration<Real>(mMeasurements[task].mean());
+	return std::chrono::duration_cast<TaskTime>(avg);
 }
 
 
@@ -11,6 +11,7 @@
 #include <dpsim-models/Utils.h>
 #include <dpsim/MNASolverFactory.h>
 #include <dpsim/PFSolverPowerPolar.h>
+#include <dpsim/PFSolverFastDecoupled.h>
 #include <dpsim/DiakopticsSolver.h>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
@@ -80,6 +81,8 @@ void Simulation::initialize() {
 
 	mTime = 0;
 	mTimeStepCount = 0;
+	mStepTimes.reset();
+	mStepTimes.enableTrace(mTimingTrace);
 
 	schedule();
 
@@ -99,13 +102,33 @@ void Simulation::createSolvers() {
 			mSolvers.push_back(solver);
 			break;
 #endif /* WITH_SUNDIALS */
-		case Solver::Type::NRP:
-			solver = std::make_shared<PFSolverPowerPolar>(**mName, mSystem, **mTimeStep, mLogLevel);
+		case Solver::Type::NRP: {
+			auto pfSolver = std::make_shared<PFSolverPowerPolar>(**mName, mSystem, **mTimeStep, mLogLevel);
+			pfSolver->doSparseJacobian(mSparseJacobian);
+			pfSolver->doWarmStart(mPowerflowWarmStart);
+			pfSolver->setJacobianReuseRatio(mJacobianReuseRatio);
+			pfSolver->setDirectLinearSolverImplementation(mDirectImpl);
+			pfSolver->setDirectLinearSolverConfiguration(mDirectLinearSolverConfiguration);
+			solver = pfSolver;
 			solver->doInitFromNodesAndTerminals(mInitFromNodesAndTerminals);
 			solver->setSolverAndComponentBehaviour(mSolverBehaviour);
 			solver->initialize();
 			mSolvers.push_back(solver);
 			break;
+		}
+		case Solver::Type::FDLF: {
+			auto pfSolver = std::make_shared<PFSolverFastDecoupled>(**mName, mSystem, **mTimeStep, mLogLevel);
+			pfSolver->setVariant(mFastDecoupledVariant);
+			pfSolver->doWarmStart(mPowerflowWarmStart);
+			pfSolver->setDirectLinearSolverImplementation(mDirectImpl);
+			pfSolver->setDirectLinearSolverConfiguration(mDirectLinearSolverConfiguration);
+			solver = pfSolver;
+			solver->doInitFromNodesAndTerminals(mInitFromNodesAndTerminals);
+			solver->setSolverAndComponentBehaviour(mSolverBehaviour);
+			solver->initialize();
+			mSolvers.push_back(solver);
+			break;
+		}
 		default:
 			throw UnsupportedSolverException();
 	}
@@ -136,6 +159,11 @@ void Simulation::createMNASolver() {
 	else
 		subnets.push_back(mSystem);
 
+	// Shared by all subnet solvers, so that replicated subnets are only analysed once
+	mSymbolicAnalysisPool.reset();
+	if (mSharedSymbolicAnalysis)
+		mSymbolicAnalysisPool = std::make_shared<SymbolicAnalysisPool>();
+
 	for (UInt net = 0; net < subnets.size(); ++net) {
 		String copySuffix;
 	   	if (subnets.size() > 1)
@@ -154,18 +182,44 @@ void Simulation::createMNASolver() {
 			solver->setTimeStep(**mTimeStep);
 			solver->doSteadyStateInit(**mSteadyStateInit);
 			solver->doFrequencyParallelization(mFreqParallel);
+			solver->doHarmonicSolveGrouping(mHarmonicSolveGrouping);
 			solver->setSteadStIniTimeLimit(mSteadStIniTimeLimit);
 			solver->setSteadStIniAccLimit(mSteadStIniAccLimit);
 			solver->setSystem(subnets[net]);
 			solver->setSolverAndComponentBehaviour(mSolverBehaviour);
 			solver->doInitFromNodesAndTerminals(mInitFromNodesAndTerminals);
 			solver->doSystemMatrixRecomputation(mSystemMatrixRecomputation);
+			solver->doLazySwitchedMatrices(mLazySwitchedMatrices);
+			solver->setSwitchedMatrixCacheLimits(mSwitchedMatrixCacheSize, mSwitchedMatrixCacheMemory);
+			solver->doTimingTrace(mTimingTrace);
+			solver->doStampSlotReassembly(mStampSlotReassembly);
+			solver->doLowRankSwitchUpdates(mLowRankSwitchUpdates, mMaxLowRankSwitchChanges);
 			solver->setDirectLinearSolverConfiguration(mDirectLinearSolverConfiguration);
+			solver->setSymbolicAnalysisPool(mSymbolicAnalysisPool);
 			solver->initialize();
 			solver->setMaxNumberOfIterations(mMaxIterations);
 		}
 		mSolvers.push_back(solver);
 	}
+
+	if (mSymbolicAnalysisPool)
+		SPDLOG_LOGGER_INFO(mLog, "Subnets share {:d} symbolic analyses, {:d} analyses were reused",
+			mSymbolicAnalysisPool->size(), mSymbolicAnalysisPool->numShared());
+}
+
+void Simulation::prewarmSwitchStates() {
+	std::vector<SwitchStateChange> changes;
+	for (auto event : mEvents.pendingEvents()) {
+		if (auto swEvent = std::dynamic_pointer_cast<SwitchEvent>(event))
+			changes.push_back({ swEvent->time(), swEvent->switchState(), swEvent->newState() });
+		else if (auto swEvent3Ph = std::dynamic_pointer_cast<SwitchEvent3Ph>(event))
+			changes.push_back({ swEvent3Ph->time(), swEvent3Ph->switchState(), swEvent3Ph->newState() });
+	}
+	if (changes.empty())
+		return;
+
+	for (auto solver : mSolvers)
+		solver->prewarmSwitchStates(changes);
 }
 
 void Simulation::sync() const {
@@ -336,6 +390,9 @@ void Simulation::start() {
 	if (!mInitialized)
 		initialize();
 
+	if (mLazySwitchedMatrices)
+		prewarmSwitchStates();
+
 	SPDLOG_LOGGER_INFO(mLog, "Opening interfaces.");
 
 	for (auto intf : mInterfaces)
@@ -349,7 +406,7 @@ void Simulation::start() {
 
 	// In PF we dont log the initial conditions of the componentes because they are not calculated
 	// In dynamic simulations log initial values of attributes (t=0)
-	if (mSolverType != Solver::Type::NRP) {
+	if (mSolverType != Solver::Type::NRP && mSolverType != Solver::Type::FDLF) {
 		if (mLoggers.size() > 0) 
 			mLoggers[0]->log(0, 0);
 
@@ -409,21 +466,30 @@ Real Simulation::step() {
 
 	auto end = std::chrono::steady_clock::now();
 	std::chrono::duration<double> diff = end-start;
-	mStepTimes.push_back(diff.count());
+	mStepTimes.update(diff.count());
 	return mTime;
 }
 
 void Simulation::logStepTimes(String logName) {
-	auto stepTimeLog = Logger::get(logName, Logger::Level::info);
-	Logger::setLogPattern(stepTimeLog, "%v");
-	stepTimeLog->info("step_time");
-
-	Real stepTimeSum = 0;
-	for (auto meas : mStepTimes) {
-		stepTimeSum += meas;
-		stepTimeLog->info("{:.9f}", meas);
+	if (mStepTimes.hasTrace()) {
+		auto stepTimeLog = Logger::get(logName, Logger::Level::info);
+		Logger::setLogPattern(stepTimeLog, "%v");
+		stepTimeLog->info("step_time");
+
+		for (auto meas : mStepTimes.trace())
+			stepTimeLog->info("{:.9f}", meas);
 	}
-	SPDLOG_LOGGER_INFO(mLog, "Average step time: {:.9f}", stepTimeSum / mStepTimes.size());
+	mStepTimes.log(mLog, "step");
+}
+
+std::map<String, std::reference_wrapper<const TimingStatistics>> Simulation::timingStatistics() const {
+	std::map<String, std::reference_wrapper<const TimingStatistics>> statistics;
+	statistics.emplace("step", std::cref(mStepTimes));
+	for (auto& solver : mSolvers) {
+		for (auto& entry : solver->timingStatistics())
+			statistics.emplace(solver->name() + "." + entry.first, std::cref(entry.second));
+	}
+	return statistics;
 }
 
 void Simulation::logLUTimes() {
@@ -447,10 +513,23 @@ CPS::AttributeBase::Ptr Simulation::getIdObjAttribute(const String &comp, const
 			SPDLOG_LOGGER_ERROR(mLog, "Attribute with name {} not found on component {}", attr, comp);
 			throw InvalidAttributeException();
 		}
-	} else {
-		SPDLOG_LOGGER_ERROR(mLog, "Component or node with name {} not found", comp);
-		throw InvalidArgumentException();
 	}
+
+	// solvers like the powerflow solver provide statistics as attributes
+	for (auto solver : mSolvers) {
+		auto attrList = std::dynamic_pointer_cast<AttributeList>(solver);
+		if (attrList && solver->name() == comp) {
+			try {
+				return attrList->attribute(attr);
+			} catch (InvalidAttributeException &e) {
+				SPDLOG_LOGGER_ERROR(mLog, "Attribute with name {} not found on solver {}", attr, comp);
+				throw InvalidAttributeException();
+			}
+		}
+	}
+
+	SPDLOG_LOGGER_ERROR(mLog, "Component or node with name {} not found", comp);
+	throw InvalidArgumentException();
 }
 
 void Simulation::logIdObjAttribute(const String &comp, const String &attr) {
@@ -40,4 +40,14 @@ namespace DPsim
     {
         return LUFactorizedSparse.solve(mRightHandSideVector);
     }
+
+    void SparseLUAdapter::solve(const Matrix& rightSideVector, Matrix& leftSideVector)
+    {
+        leftSideVector = LUFactorizedSparse.solve(rightSideVector);
+    }
+
+    std::size_t SparseLUAdapter::factorizationMemory() const
+    {
+        return static_cast<std::size_t>(LUFactorizedSparse.nnzL() + LUFactorizedSparse.nnzU()) * (sizeof(Real) + sizeof(int));
+    }
 }
@@ -0,0 +1,73 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <functional>
+
+#include <dpsim/SymbolicAnalysisPool.h>
+
+using namespace DPsim;
+
+Bool SymbolicAnalysisPool::preprocessingShared(SparseMatrix& systemMatrix,
+	const std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries, DirectLinearSolver& solver) {
+	systemMatrix.makeCompressed();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto range = mReferences.equal_range(patternHash(systemMatrix));
+	for (auto it = range.first; it != range.second;) {
+		auto reference = it->second.solver.lock();
+		if (!reference) {
+			it = mReferences.erase(it);
+			continue;
+		}
+		if (matches(it->second, systemMatrix, listVariableSystemMatrixEntries)
+			&& solver.preprocessingShared(systemMatrix, *reference)) {
+			++mNumShared;
+			return true;
+		}
+		++it;
+	}
+	return false;
+}
+
+void SymbolicAnalysisPool::add(const SparseMatrix& systemMatrix,
+	const std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries,
+	const std::shared_ptr<DirectLinearSolver>& solver) {
+	if (!systemMatrix.isCompressed())
+		return;
+
+	Reference reference;
+	reference.rows = systemMatrix.rows();
+	reference.outer.assign(systemMatrix.outerIndexPtr(), systemMatrix.outerIndexPtr() + systemMatrix.outerSize() + 1);
+	reference.inner.assign(systemMatrix.innerIndexPtr(), systemMatrix.innerIndexPtr() + systemMatrix.nonZeros());
+	reference.variableEntries = listVariableSystemMatrixEntries;
+	reference.solver = solver;
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mReferences.emplace(patternHash(systemMatrix), std::move(reference));
+}
+
+std::size_t SymbolicAnalysisPool::patternHash(const SparseMatrix& systemMatrix) {
+	std::size_t hash = std::hash<Eigen::Index>()(systemMatrix.rows());
+	auto combine = [&hash](Int value) {
+		hash ^= std::hash<Int>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	};
+	std::for_each(systemMatrix.outerIndexPtr(), systemMatrix.outerIndexPtr() + systemMatrix.outerSize() + 1, combine);
+	std::for_each(systemMatrix.innerIndexPtr(), systemMatrix.innerIndexPtr() + systemMatrix.nonZeros(), combine);
+	return hash;
+}
+
+Bool SymbolicAnalysisPool::matches(const Reference& reference, const SparseMatrix& systemMatrix,
+	const std::vector<std::pair<UInt, UInt>>& listVariableSystemMatrixEntries) {
+	return reference.rows == systemMatrix.rows()
+		&& reference.outer.size() == static_cast<std::size_t>(systemMatrix.outerSize() + 1)
+		&& reference.inner.size() == static_cast<std::size_t>(systemMatrix.nonZeros())
+		&& std::equal(reference.outer.begin(), reference.outer.end(), systemMatrix.outerIndexPtr())
+		&& std::equal(reference.inner.begin(), reference.inner.end(), systemMatrix.innerIndexPtr())
+		&& reference.variableEntries == listVariableSystemMatrixEntries;
+}
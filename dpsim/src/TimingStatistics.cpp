@@ -0,0 +1,126 @@
+/* Copyright 2017-2021 Institute for Automation of Complex Power Systems,
+ *                     EONERC, RWTH Aachen University
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *********************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include <dpsim/TimingStatistics.h>
+
+using namespace DPsim;
+
+void TimingStatistics::update(Real value) {
+	++mCount;
+	mSum += value;
+
+	Real delta = value - mMean;
+	mMean += delta / static_cast<Real>(mCount);
+	mM2 += delta * (value - mMean);
+
+	if (mCount == 1 || value < mMin)
+		mMin = value;
+	if (mCount == 1 || value > mMax)
+		mMax = value;
+
+	Real nanoseconds = std::round(value * 1e9);
+	std::uint64_t ticks = 0;
+	if (nanoseconds >= static_cast<Real>(mMaxValue))
+		ticks = mMaxValue;
+	else if (nanoseconds > 0)
+		ticks = static_cast<std::uint64_t>(nanoseconds);
+	if (mHistogram.empty())
+		mHistogram.assign(mNumBuckets, 0);
+	++mHistogram[bucketIndex(ticks)];
+
+	if (mTrace)
+		mTraceValues.push_back(value);
+}
+
+void TimingStatistics::reset() {
+	mCount = 0;
+	mSum = 0;
+	mMean = 0;
+	mM2 = 0;
+	mMin = 0;
+	mMax = 0;
+	std::fill(mHistogram.begin(), mHistogram.end(), 0);
+	mTraceValues.clear();
+}
+
+void TimingStatistics::enableTrace(Bool enable) {
+	mTrace = enable;
+	if (!mTrace)
+		std::vector<Real>().swap(mTraceValues);
+}
+
+Real TimingStatistics::variance() const {
+	if (mCount < 2)
+		return 0;
+	return mM2 / static_cast<Real>(mCount - 1);
+}
+
+Real TimingStatistics::stddev() const {
+	return std::sqrt(variance());
+}
+
+Real TimingStatistics::percentile(Real percent) const {
+	if (mCount == 0)
+		return 0;
+
+	percent = std::min(std::max(percent, 0.), 100.);
+	auto rank = static_cast<std::uint64_t>(std::ceil(percent / 100. * static_cast<Real>(mCount)));
+	rank = std::max<std::uint64_t>(rank, 1);
+	// the largest sample is known exactly, also beyond the histogram range
+	if (rank >= mCount)
+		return mMax;
+
+	std::uint64_t cumulative = 0;
+	for (std::size_t index = 0; index < mHistogram.size(); ++index) {
+		cumulative += mHistogram[index];
+		if (cumulative >= rank) {
+			Real value = static_cast<Real>(bucketValue(index)) * 1e-9;
+			return std::min(std::max(value, mMin), mMax);
+		}
+	}
+	return mMax;
+}
+
+void TimingStatistics::log(CPS::Logger::Log log, const String& name) const {
+	SPDLOG_LOGGER_INFO(log, "Number of {} measurements: {:d}", name, mCount);
+	if (mCount == 0)
+		return;
+
+	SPDLOG_LOGGER_INFO(log, "Cumulative {} time: {:.12f}", name, mSum);
+	SPDLOG_LOGGER_INFO(log, "Average {} time: {:.12f}", name, mMean);
+	SPDLOG_LOGGER_INFO(log, "Minimum {} time: {:.12f}", name, min());
+	SPDLOG_LOGGER_INFO(log, "Maximum {} time: {:.12f}", name, max());
+	SPDLOG_LOGGER_INFO(log, "Standard deviation of {} time: {:.12f}", name, stddev());
+	SPDLOG_LOGGER_INFO(log, "Percentiles (50/90/99/99.9) of {} time: {:.12f} {:.12f} {:.12f} {:.12f}",
+		name, percentile(50), percentile(90), percentile(99), percentile(99.9));
+}
+
+std::size_t TimingStatistics::bucketIndex(std::uint64_t value) {
+	if (value < mSubBucketCount)
+		return static_cast<std::size_t>(value);
+
+	// Shift the value so that exactly mSubBucketBits significant bits remain
+	UInt shift = 0;
+	while ((value >> shift) >= mSubBucketCount)
+		++shift;
+
+	return static_cast<std::size_t>(shift * mSubBucketHalfCount + (value >> shift));
+}
+
+std::uint64_t TimingStatistics::bucketValue(std::size_t index) {
+	if (index < mSubBucketCount)
+		return index;
+
+	// Return the center of the range covered by the bucket
+	UInt shift = static_cast<UInt>(index / mSubBucketHalfCount) - 1;
+	std::uint64_t lower = (index % mSubBucketHalfCount + mSubBucketHalfCount) << shift;
+	return lower + ((1ULL << shift) >> 1);
+}
@@ -53,8 +53,8 @@ CommandLineArgs::CommandLineArgs(int argc, char *argv[],
 		{ "start-at",		required_argument,	0, 'a', "ISO8601", "Start time of real-time simulation" },
 		{ "start-in",		required_argument,	0, 'i', "SECS", "" },
 		{ "solver-domain",	required_argument,	0, 'D', "(SP|DP|EMT)", "Domain of solver" },
-		{ "solver-type",	required_argument,	0, 'T', "(NRP|MNA)", "Type of solver" },
-		{ "linear-solver-impl", required_argument, 0, 'U', "(DenseLU|SparseLU|KLU|CUDADense|CUDASparse)", "Type of direct linear solver implementation"},
+		{ "solver-type",	required_argument,	0, 'T', "(NRP|FDLF|MNA)", "Type of solver" },
+		{ "linear-solver-impl", required_argument, 0, 'U', "(DenseLU|SparseLU|ParallelSparseLU|KLU|KLUComplex|CUDADense|CUDASparse)", "Type of direct linear solver implementation"},
 		{ "option",		required_argument,	0, 'o', "KEY=VALUE", "User-definable options" },
 		{ "name",		required_argument,	0, 'n', "NAME", "Name of log files" },
 		{ "params",		required_argument,	0, 'p', "PATH", "Json file containing parametrization"},
@@ -108,8 +108,8 @@ CommandLineArgs::CommandLineArgs(
 		{ "start-at",		required_argument,	0, 'a', "ISO8601", "Start time of real-time simulation" },
 		{ "start-in",		required_argument,	0, 'i', "SECS", "" },
 		{ "solver-domain",	required_argument,	0, 'D', "(SP|DP|EMT)", "Domain of solver" },
-		{ "solver-type",	required_argument,	0, 'T', "(NRP|MNA)", "Type of solver" },
-		{ "linear-solver-impl", required_argument, 0, 'U', "(DenseLU|SparseLU|KLU|CUDADense|CUDASparse)", "Type of direct linear solver implementation"},
+		{ "solver-type",	required_argument,	0, 'T', "(NRP|FDLF|MNA)", "Type of solver" },
+		{ "linear-solver-impl", required_argument, 0, 'U', "(DenseLU|SparseLU|ParallelSparseLU|KLU|KLUComplex|CUDADense|CUDASparse)", "Type of direct linear solver implementation"},
 		{ "option",		required_argument,	0, 'o', "KEY=VALUE", "User-definable options" },
 		{ "name",		required_argument,	0, 'n', "NAME", "Name of log files" },
 		{ 0 }
@@ -228,8 +228,10 @@ void CommandLineArgs::parseArguments(int argc, char *argv[])
 					solver.type = Solver::Type::MNA;
 				else if (arg == "NRP")
 					solver.type = Solver::Type::NRP;
+				else if (arg == "FDLF")
+					solver.type = Solver::Type::FDLF;
 				else
-					throw std::invalid_argument("Invalid value for --solver-type: must be a string of NRP or MNA");
+					throw std::invalid_argument("Invalid value for --solver-type: must be a string of NRP, FDLF or MNA");
 				break;
 			}
 			case 'U': {
@@ -238,8 +240,12 @@ void CommandLineArgs::parseArguments(int argc, char *argv[])
 					directImpl = DirectLinearSolverImpl::DenseLU;
 				} else if (arg == "SparseLU") {
 					directImpl = DirectLinearSolverImpl::SparseLU;
+				} else if (arg == "ParallelSparseLU") {
+					directImpl = DirectLinearSolverImpl::ParallelSparseLU;
 				} else if (arg == "KLU") {
 					directImpl = DirectLinearSolverImpl::KLU;
+				} else if (arg == "KLUComplex") {
+					directImpl = DirectLinearSolverImpl::KLUComplex;
 				} else if (arg == "CUDADense") {
 					directImpl = DirectLinearSolverImpl::CUDADense;
 				} else if (arg == "CUDASparse") {
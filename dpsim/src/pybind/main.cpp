@@ -17,6 +17,8 @@
 
 #include <dpsim/Simulation.h>
 #include <dpsim/RealTimeSimulation.h>
+#include <dpsim/PFContingencySolver.h>
+#include <dpsim/CompressedResultReader.h>
 #include <dpsim-models/IdentifiedObject.h>
 #include <DPsim.h>
 
@@ -97,13 +99,20 @@ PYBIND11_MODULE(dpsimpy, m) {
 	py::enum_<DPsim::Solver::Type>(m, "Solver")
 		.value("MNA", DPsim::Solver::Type::MNA)
 		.value("DAE", DPsim::Solver::Type::DAE)
-		.value("NRP", DPsim::Solver::Type::NRP);
+		.value("NRP", DPsim::Solver::Type::NRP)
+		.value("FDLF", DPsim::Solver::Type::FDLF);
+
+	py::enum_<DPsim::FastDecoupledVariant>(m, "FastDecoupledVariant")
+		.value("XB", DPsim::FastDecoupledVariant::XB)
+		.value("BX", DPsim::FastDecoupledVariant::BX);
 
 	py::enum_<DPsim::DirectLinearSolverImpl>(m, "DirectLinearSolverImpl")
 		.value("Undef", DPsim::DirectLinearSolverImpl::Undef)
 		.value("DenseLU", DPsim::DirectLinearSolverImpl::DenseLU)
 		.value("SparseLU", DPsim::DirectLinearSolverImpl::SparseLU)
+		.value("ParallelSparseLU", DPsim::DirectLinearSolverImpl::ParallelSparseLU)
 		.value("KLU", DPsim::DirectLinearSolverImpl::KLU)
+		.value("KLUComplex", DPsim::DirectLinearSolverImpl::KLUComplex)
 		.value("CUDADense", DPsim::DirectLinearSolverImpl::CUDADense)
 		.value("CUDASparse", DPsim::DirectLinearSolverImpl::CUDASparse)
 		.value("CUDAMagma", DPsim::DirectLinearSolverImpl::CUDAMagma);
@@ -156,6 +165,17 @@ PYBIND11_MODULE(dpsimpy, m) {
 		.def("get_partial_refactorization_method", &DPsim::DirectLinearSolverConfiguration::getPartialRefactorizationMethod)
 		.def("get_btf", &DPsim::DirectLinearSolverConfiguration::getBTF);
 
+	py::class_<DPsim::TimingStatistics>(m, "TimingStatistics")
+		.def("count", &DPsim::TimingStatistics::count)
+		.def("sum", &DPsim::TimingStatistics::sum)
+		.def("mean", &DPsim::TimingStatistics::mean)
+		.def("min", &DPsim::TimingStatistics::min)
+		.def("max", &DPsim::TimingStatistics::max)
+		.def("variance", &DPsim::TimingStatistics::variance)
+		.def("stddev", &DPsim::TimingStatistics::stddev)
+		.def("percentile", &DPsim::TimingStatistics::percentile, "percent"_a)
+		.def("trace", &DPsim::TimingStatistics::trace);
+
     py::class_<DPsim::Simulation>(m, "Simulation")
 	    .def(py::init<std::string, CPS::Logger::Level>(), "name"_a, "loglevel"_a = CPS::Logger::Level::off)
 		.def("name", &DPsim::Simulation::name)
@@ -175,14 +195,33 @@ PYBIND11_MODULE(dpsimpy, m) {
 		.def("log_attribute", &DPsim::Simulation::logAttribute, "name"_a, "attr"_a)
 		.def("do_init_from_nodes_and_terminals", &DPsim::Simulation::doInitFromNodesAndTerminals)
 		.def("do_system_matrix_recomputation", &DPsim::Simulation::doSystemMatrixRecomputation)
+		.def("do_lazy_switched_matrices", &DPsim::Simulation::doLazySwitchedMatrices)
+		.def("do_stamp_slot_reassembly", &DPsim::Simulation::doStampSlotReassembly)
+		.def("do_low_rank_switch_updates", &DPsim::Simulation::doLowRankSwitchUpdates, "value"_a, "max_changes"_a = 4)
+		.def("do_shared_symbolic_analysis", &DPsim::Simulation::doSharedSymbolicAnalysis, "value"_a = true)
+		.def("do_sparse_jacobian", &DPsim::Simulation::doSparseJacobian, "value"_a = true)
+		.def("set_fast_decoupled_variant", &DPsim::Simulation::setFastDecoupledVariant, "variant"_a)
+		.def("do_powerflow_warm_start", &DPsim::Simulation::doPowerflowWarmStart, "value"_a = true, "jacobian_reuse_ratio"_a = 0.5)
+		.def("set_switched_matrix_cache_limits", &DPsim::Simulation::setSwitchedMatrixCacheLimits, "max_entries"_a, "max_memory"_a = 0)
 		.def("do_steady_state_init", &DPsim::Simulation::doSteadyStateInit)
 		.def("do_frequency_parallelization", &DPsim::Simulation::doFrequencyParallelization)
+		.def("do_harmonic_solve_grouping", &DPsim::Simulation::doHarmonicSolveGrouping)
 		.def("set_tearing_components", &DPsim::Simulation::setTearingComponents)
 		.def("add_event", &DPsim::Simulation::addEvent)
 		.def("set_solver_component_behaviour", &DPsim::Simulation::setSolverAndComponentBehaviour)
 		.def("set_direct_solver_implementation", &DPsim::Simulation::setDirectLinearSolverImplementation)
 		.def("set_direct_linear_solver_configuration", &DPsim::Simulation::setDirectLinearSolverConfiguration)
-		.def("log_lu_times", &DPsim::Simulation::logLUTimes);
+		.def("log_lu_times", &DPsim::Simulation::logLUTimes)
+		.def("do_timing_trace", &DPsim::Simulation::doTimingTrace, "value"_a = true)
+		.def("log_step_times", &DPsim::Simulation::logStepTimes, "log_name"_a)
+		.def("step_times", &DPsim::Simulation::stepTimes, py::return_value_policy::reference_internal)
+		.def("timing_statistics", [](const DPsim::Simulation &sim) {
+			// Python receives copies, the statistics continue to be updated by the simulation
+			std::map<CPS::String, DPsim::TimingStatistics> statistics;
+			for (auto &entry : sim.timingStatistics())
+				statistics.emplace(entry.first, entry.second.get());
+			return statistics;
+		});
 
 	py::class_<DPsim::RealTimeSimulation, DPsim::Simulation>(m, "RealTimeSimulation")
 		.def(py::init<std::string, CPS::Logger::Level>(), "name"_a, "loglevel"_a = CPS::Logger::Level::info)
@@ -195,6 +234,48 @@ PYBIND11_MODULE(dpsimpy, m) {
 		.def("set_solver", &DPsim::RealTimeSimulation::setSolverType)
 		.def("set_domain", &DPsim::RealTimeSimulation::setDomain);
 
+	py::class_<DPsim::PFBatchResult>(m, "PFBatchResult")
+		.def_readonly("node_names", &DPsim::PFBatchResult::nodeNames)
+		.def_readonly("branch_names", &DPsim::PFBatchResult::branchNames)
+		.def_readonly("voltages", &DPsim::PFBatchResult::voltages)
+		.def_readonly("branch_power_from", &DPsim::PFBatchResult::branchPowerFrom)
+		.def_readonly("branch_power_to", &DPsim::PFBatchResult::branchPowerTo)
+		.def_readonly("iterations", &DPsim::PFBatchResult::iterations);
+
+	py::class_<DPsim::PFBatchSolver, std::shared_ptr<DPsim::PFBatchSolver>>(m, "PFBatchSolver")
+		.def(py::init<std::string, const CPS::SystemTopology&, CPS::Logger::Level>(), "name"_a, "system"_a, "loglevel"_a = CPS::Logger::Level::off)
+		.def("set_number_of_threads", &DPsim::PFBatchSolver::setNumberOfThreads)
+		.def("do_warm_start", &DPsim::PFBatchSolver::doWarmStart, "value"_a = true)
+		.def("solve", &DPsim::PFBatchSolver::solve, "active_power"_a, "reactive_power"_a, py::call_guard<py::gil_scoped_release>());
+
+	py::enum_<DPsim::PFContingencyViolation::Type>(m, "PFContingencyViolationType")
+		.value("branch_overload", DPsim::PFContingencyViolation::Type::BranchOverload)
+		.value("undervoltage", DPsim::PFContingencyViolation::Type::Undervoltage)
+		.value("overvoltage", DPsim::PFContingencyViolation::Type::Overvoltage);
+
+	py::class_<DPsim::PFContingencyViolation>(m, "PFContingencyViolation")
+		.def_readonly("type", &DPsim::PFContingencyViolation::type)
+		.def_readonly("element", &DPsim::PFContingencyViolation::element)
+		.def_readonly("value", &DPsim::PFContingencyViolation::value)
+		.def_readonly("limit", &DPsim::PFContingencyViolation::limit);
+
+	py::class_<DPsim::PFContingencyResult>(m, "PFContingencyResult")
+		.def_readonly("outage", &DPsim::PFContingencyResult::outage)
+		.def_readonly("islanding", &DPsim::PFContingencyResult::islanding)
+		.def_readonly("verified", &DPsim::PFContingencyResult::verified)
+		.def_readonly("converged", &DPsim::PFContingencyResult::converged)
+		.def_readonly("iterations", &DPsim::PFContingencyResult::iterations)
+		.def_readonly("estimated_loading", &DPsim::PFContingencyResult::estimatedLoading)
+		.def_readonly("severity", &DPsim::PFContingencyResult::severity)
+		.def_readonly("violations", &DPsim::PFContingencyResult::violations);
+
+	py::class_<DPsim::PFContingencySolver, DPsim::PFBatchSolver, std::shared_ptr<DPsim::PFContingencySolver>>(m, "PFContingencySolver")
+		.def(py::init<std::string, const CPS::SystemTopology&, CPS::Logger::Level>(), "name"_a, "system"_a, "loglevel"_a = CPS::Logger::Level::off)
+		.def("set_branch_limit", &DPsim::PFContingencySolver::setBranchLimit, "name"_a, "apparent_power"_a)
+		.def("set_voltage_limits", &DPsim::PFContingencySolver::setVoltageLimits, "min_voltage"_a, "max_voltage"_a)
+		.def("set_screening_threshold", &DPsim::PFContingencySolver::setScreeningThreshold, "threshold"_a)
+		.def("analyze", &DPsim::PFContingencySolver::analyze, py::call_guard<py::gil_scoped_release>());
+
 	py::class_<CPS::SystemTopology, std::shared_ptr<CPS::SystemTopology>>(m, "SystemTopology")
         .def(py::init<CPS::Real, CPS::TopologicalNode::List, CPS::IdentifiedObject::List>())
 		.def(py::init<CPS::Real, CPS::Matrix, CPS::TopologicalNode::List, CPS::IdentifiedObject::List>())
@@ -220,8 +301,35 @@ PYBIND11_MODULE(dpsimpy, m) {
 
 	py::class_<DPsim::Interface, std::shared_ptr<DPsim::Interface>>(m, "Interface");
 
+	py::enum_<DPsim::DataLogger::Format>(m, "LoggerFormat")
+		.value("CSV", DPsim::DataLogger::Format::CSV)
+		.value("BINARY_FLOAT64", DPsim::DataLogger::Format::BINARY_FLOAT64)
+		.value("BINARY_FLOAT32", DPsim::DataLogger::Format::BINARY_FLOAT32)
+		.value("COMPRESSED", DPsim::DataLogger::Format::COMPRESSED)
+		.value("RING_BUFFER", DPsim::DataLogger::Format::RING_BUFFER);
+
+	py::enum_<DPsim::DataLogger::Overflow>(m, "LoggerOverflow")
+		.value("BLOCK", DPsim::DataLogger::Overflow::BLOCK)
+		.value("DROP", DPsim::DataLogger::Overflow::DROP)
+		.value("COUNT", DPsim::DataLogger::Overflow::COUNT);
+
+	py::enum_<DPsim::DataLogger::Trigger>(m, "LoggerTrigger")
+		.value("ABOVE", DPsim::DataLogger::Trigger::ABOVE)
+		.value("BELOW", DPsim::DataLogger::Trigger::BELOW)
+		.value("CHANGE", DPsim::DataLogger::Trigger::CHANGE);
+
 	py::class_<DPsim::DataLogger, std::shared_ptr<DPsim::DataLogger>>(m, "Logger")
         .def(py::init<std::string>())
+		.def(py::init<std::string, CPS::Bool, CPS::UInt, DPsim::DataLogger::Format>(), "name"_a, "enabled"_a = true, "downsampling"_a = 1, "format"_a = DPsim::DataLogger::Format::CSV)
+		.def("set_unit", &DPsim::DataLogger::setUnit, "name"_a, "unit"_a)
+		.def("set_async", &DPsim::DataLogger::setAsync, "value"_a = true, "capacity"_a = 1024, "overflow"_a = DPsim::DataLogger::Overflow::BLOCK)
+		.def("overflows", &DPsim::DataLogger::overflows)
+		.def("set_ring_buffer_rows", &DPsim::DataLogger::setRingBufferRows, "rows"_a)
+		.def("set_envelope", &DPsim::DataLogger::setEnvelope, "window"_a)
+		.def("set_trigger", &DPsim::DataLogger::setTrigger, "column"_a, "condition"_a, "threshold"_a, "pre_trigger"_a = 100, "post_trigger"_a = 1000)
+		.def("set_deadband", py::overload_cast<CPS::Real>(&DPsim::DataLogger::setDeadband), "tolerance"_a)
+		.def("set_deadband", py::overload_cast<const CPS::String&, CPS::Real>(&DPsim::DataLogger::setDeadband), "name"_a, "tolerance"_a)
+		.def("reset_capture", &DPsim::DataLogger::resetCapture)
 		.def_static("set_log_dir", &CPS::Logger::setLogDir)
 		.def_static("get_log_dir", &CPS::Logger::logDir)
 		.def("log_attribute", py::overload_cast<const CPS::String&, CPS::AttributeBase::Ptr, CPS::UInt, CPS::UInt>(&DPsim::DataLogger::logAttribute), "name"_a, "attr"_a, "max_cols"_a = 0, "max_rows"_a = 0)
@@ -236,6 +344,14 @@ PYBIND11_MODULE(dpsimpy, m) {
 			logger.logAttribute(names, comp.attribute(attr));
 		});
 
+	py::class_<DPsim::CompressedResultReader>(m, "CompressedResult")
+		.def(py::init<const std::string&>(), "path"_a)
+		.def_property_readonly("names", &DPsim::CompressedResultReader::names)
+		.def_property_readonly("units", &DPsim::CompressedResultReader::units)
+		.def_property_readonly("rows", &DPsim::CompressedResultReader::rows)
+		.def_property_readonly("time", &DPsim::CompressedResultReader::time)
+		.def("column", &DPsim::CompressedResultReader::column, "name"_a);
+
 	py::class_<CPS::IdentifiedObject, std::shared_ptr<CPS::IdentifiedObject>>(m, "IdentifiedObject")
 		.def("name", &CPS::IdentifiedObject::name)
 		/// CHECK: It would be nicer if all the attributes of an IdObject were bound as properties so they show up in the documentation and auto-completion.
@@ -0,0 +1,298 @@
+import os
+import struct
+
+import numpy as np
+
+import dpsim
+from dpsim import results
+
+
+def simulate(log_dir, name, format, configure=None, final_time=0.25, observe=None, probe=None):
+    dpsim.Logger.set_log_dir(str(log_dir))
+
+    gnd = dpsim.dp.SimNode.gnd
+    n1 = dpsim.dp.SimNode('n1')
+    n2 = dpsim.dp.SimNode('n2')
+
+    vs = dpsim.dp.ph1.VoltageSource('vs')
+    vs.set_parameters(complex(10, 0))
+    r1 = dpsim.dp.ph1.Resistor('r_1')
+    r1.set_parameters(5)
+    l1 = dpsim.dp.ph1.Inductor('l_1')
+    l1.set_parameters(0.02)
+
+    vs.connect([gnd, n1])
+    r1.connect([n1, n2])
+    l1.connect([n2, gnd])
+
+    system = dpsim.SystemTopology(50, [gnd, n1, n2], [vs, r1, l1])
+
+    logger = dpsim.Logger(name, format=format)
+    logger.log_attribute('n1.v', 'v', n1)
+    logger.log_attribute('n2.v', 'v', n2)
+    logger.log_attribute('l_1.i_intf', 'i_intf', l1)
+    if probe is not None:
+        # a resistor outside of the system, its resistance is logged as it is set for each step
+        resistor = dpsim.dp.ph1.Resistor('probe')
+        logger.log_attribute('probe.R', 'R', resistor)
+        # the initial value is logged on start, each further value in one step
+        resistor.attr('R').set(probe[0])
+        remaining = iter(probe[1:])
+
+        def observe():
+            value = next(remaining, None)
+            if value is None:
+                return False
+            resistor.attr('R').set(value)
+            return True
+    if configure is not None:
+        configure(logger)
+
+    sim = dpsim.Simulation(name)
+    sim.set_domain(dpsim.Domain.DP)
+    sim.set_system(system)
+    sim.set_time_step(0.0001)
+    sim.set_final_time(final_time)
+    sim.add_logger(logger)
+    if observe is None:
+        sim.run()
+    else:
+        # the initial values are logged on start, each step logs one more row
+        sim.start()
+        while observe():
+            sim.next()
+        sim.stop()
+
+
+def read_csv(path):
+    with open(path) as f:
+        names = [name.strip() for name in f.readline().split(',')]
+    values = np.loadtxt(path, delimiter=',', skiprows=1, ndmin=2)
+    return {name: values[:, column] for column, name in enumerate(names)}
+
+
+def test_binary_float64(tmp_path):
+    # more rows than fit into one chunk, the last chunk is partially filled
+    simulate(tmp_path, 'csv', dpsim.LoggerFormat.CSV)
+    simulate(tmp_path, 'float64', dpsim.LoggerFormat.BINARY_FLOAT64)
+
+    expected = read_csv(os.path.join(tmp_path, 'csv.csv'))
+    result = results.read_binary(os.path.join(tmp_path, 'float64.bin'))
+
+    assert sorted(result) == sorted(expected)
+    assert len(result['time']) == len(expected['time']) > 1024
+    for name in expected:
+        assert result[name].dtype == np.float64
+        # the CSV file holds the values with six decimals only
+        np.testing.assert_allclose(result[name], expected[name], rtol=1e-5, atol=1e-6)
+
+
+def test_binary_float32(tmp_path):
+    simulate(tmp_path, 'float64', dpsim.LoggerFormat.BINARY_FLOAT64)
+    simulate(tmp_path, 'float32', dpsim.LoggerFormat.BINARY_FLOAT32)
+
+    expected = results.read_binary(os.path.join(tmp_path, 'float64.bin'))
+    result = results.read_binary(os.path.join(tmp_path, 'float32.bin'))
+
+    # the time is always stored as float64
+    np.testing.assert_array_equal(result['time'], expected['time'])
+    for name in expected:
+        np.testing.assert_array_equal(result[name], expected[name].astype(np.float32))
+
+
+def test_binary_without_chunks(tmp_path):
+    names = b''.join(struct.pack('<H', len(text)) + text for text in (b'x', b'V'))
+    header = struct.pack('<8sIIIIQQ', b'DPSIMBIN', 1, 8, 1, 16, 64, 8 + 16 * 16)
+    path = os.path.join(tmp_path, 'empty.bin')
+    with open(path, 'wb') as f:
+        f.write((header + names).ljust(64, b'\0'))
+
+    result = results.BinaryResult(path)
+    assert result.names == ['x']
+    assert result.units == ['V']
+    assert result.time.dtype == np.float64 and len(result.time) == 0
+    assert result.column('x').dtype == np.float64 and len(result.column('x')) == 0
+
+
+def test_async(tmp_path):
+    simulate(tmp_path, 'sync', dpsim.LoggerFormat.BINARY_FLOAT64)
+    # a small buffer, so that the simulation has to wait for the writer thread
+    simulate(tmp_path, 'async', dpsim.LoggerFormat.BINARY_FLOAT64,
+             lambda logger: logger.set_async(True, capacity=4))
+    simulate(tmp_path, 'sync_csv', dpsim.LoggerFormat.CSV)
+    simulate(tmp_path, 'async_csv', dpsim.LoggerFormat.CSV,
+             lambda logger: logger.set_async(True, capacity=4))
+
+    expected = results.read_binary(os.path.join(tmp_path, 'sync.bin'))
+    result = results.read_binary(os.path.join(tmp_path, 'async.bin'))
+    assert sorted(result) == sorted(expected)
+    for name in expected:
+        np.testing.assert_array_equal(result[name], expected[name])
+
+    with open(os.path.join(tmp_path, 'sync_csv.csv')) as f:
+        expected_csv = f.read()
+    with open(os.path.join(tmp_path, 'async_csv.csv')) as f:
+        assert f.read() == expected_csv
+
+
+def full_rows(tmp_path):
+    simulate(tmp_path, 'all', dpsim.LoggerFormat.BINARY_FLOAT64)
+    result = results.BinaryResult(os.path.join(tmp_path, 'all.bin'))
+    return result.names, result.time, np.column_stack([result.column(name) for name in result.names])
+
+
+def test_envelope(tmp_path):
+    names, time, rows = full_rows(tmp_path)
+    window = 64
+    simulate(tmp_path, 'envelope', dpsim.LoggerFormat.BINARY_FLOAT64,
+             lambda logger: logger.set_envelope(window))
+    result = results.read_binary(os.path.join(tmp_path, 'envelope.bin'))
+
+    # the last window is partially filled
+    starts = np.arange(0, len(time), window)
+    assert len(time) % window != 0
+    np.testing.assert_array_equal(result['time'], time[starts])
+    for column, name in enumerate(names):
+        windows = [rows[start:start + window, column] for start in starts]
+        np.testing.assert_array_equal(result[name + '.min'], [w.min() for w in windows])
+        np.testing.assert_array_equal(result[name + '.max'], [w.max() for w in windows])
+        np.testing.assert_allclose(result[name + '.mean'], [w.mean() for w in windows], rtol=1e-12)
+
+
+def expected_trigger(values, condition, threshold, pre, post):
+    written = []
+    history = []
+    last = 0.
+    remaining = 0
+    for row, value in enumerate(values):
+        if condition == dpsim.LoggerTrigger.ABOVE:
+            fired = value > threshold
+        elif condition == dpsim.LoggerTrigger.BELOW:
+            fired = value < threshold
+        else:
+            fired = abs(value - last) > threshold
+        last = value
+        if fired:
+            written += history + [row]
+            history = []
+            remaining = post
+        elif remaining > 0:
+            remaining -= 1
+            written.append(row)
+        elif pre > 0:
+            history = (history + [row])[-pre:]
+    return written
+
+
+def test_trigger(tmp_path):
+    names, time, rows = full_rows(tmp_path)
+    values = rows[:, names.index('l_1.i_intf.re')]
+
+    cases = {
+        # the current changes fast at the beginning of the transient only
+        'change': (dpsim.LoggerTrigger.CHANGE, np.percentile(np.abs(np.diff(values)), 90)),
+        # the current rises above the threshold in the middle of the simulation
+        'above': (dpsim.LoggerTrigger.ABOVE, (values.min() + values.max()) / 2),
+    }
+    for name, (condition, threshold) in cases.items():
+        simulate(tmp_path, name, dpsim.LoggerFormat.BINARY_FLOAT64,
+                 lambda logger: logger.set_trigger('l_1.i_intf.re', condition, threshold, 20, 50))
+        result = results.read_binary(os.path.join(tmp_path, name + '.bin'))
+
+        written = expected_trigger(values, condition, threshold, 20, 50)
+        assert 0 < len(written) < len(time)
+        np.testing.assert_array_equal(result['time'], time[written])
+        for column, column_name in enumerate(names):
+            np.testing.assert_array_equal(result[column_name], rows[written, column])
+
+
+def test_deadband(tmp_path):
+    names, time, rows = full_rows(tmp_path)
+    tolerance = 0.01
+    simulate(tmp_path, 'deadband', dpsim.LoggerFormat.BINARY_FLOAT64,
+             lambda logger: logger.set_deadband(tolerance))
+    result = results.read_binary(os.path.join(tmp_path, 'deadband.bin'))
+
+    written = [0]
+    for row in range(1, len(time)):
+        if np.any(np.abs(rows[row] - rows[written[-1]]) > tolerance):
+            written.append(row)
+    # the last row is written on close
+    if written[-1] != len(time) - 1:
+        written.append(len(time) - 1)
+
+    assert len(written) < len(time)
+    np.testing.assert_array_equal(result['time'], time[written])
+    for index, name in enumerate(names):
+        np.testing.assert_array_equal(result[name], rows[written, index])
+
+
+def test_compressed(tmp_path):
+    special = [0., -0., np.nan, -np.nan, np.inf, -np.inf, np.inf, 5e-324, -5e-324,
+               np.finfo(np.float64).max, np.finfo(np.float64).tiny, 1., 1., 1.]
+    random = np.random.default_rng(42).integers(0, 2**64, 2000, dtype=np.uint64).view(np.float64)
+    # more rows than fit into one chunk
+    values = np.concatenate([special, np.linspace(0., 1., 2000), random, special,
+                             325. * np.sin(np.arange(1000) * 0.0314)])
+    assert len(values) > 4096
+
+    simulate(tmp_path, 'compressed', dpsim.LoggerFormat.COMPRESSED, final_time=1, probe=values)
+
+    path = os.path.join(tmp_path, 'compressed.dpz')
+    result = results.CompressedResult(path)
+    native = dpsim.CompressedResult(path)
+    assert result.names == native.names
+    assert result.units == native.units
+    assert result.rows == native.rows == len(values)
+
+    # compare the bits, so that NaN, signed zeros and subnormal numbers are checked as well
+    np.testing.assert_array_equal(result.column('probe.R').view('<u8'), values.view('<u8'))
+    np.testing.assert_array_equal(result.time.view('<u8'), np.asarray(native.time).view('<u8'))
+    for name in result.names:
+        np.testing.assert_array_equal(result.column(name).view('<u8'), np.asarray(native.column(name)).view('<u8'))
+
+
+def test_ring_buffer(tmp_path):
+    names, time, rows = full_rows(tmp_path)
+    capacity = 256
+    name = 'test_results_ring'
+    path = os.path.join('/dev/shm' if os.path.exists('/dev/shm') else str(tmp_path), name + '.ring')
+
+    ring = None
+    written = 0
+
+    def check(ring, count, written):
+        latest = ring.latest(count)
+        first = max(written - min(capacity if count is None else count, capacity), 0)
+        np.testing.assert_array_equal(latest['time'], time[first:written])
+        for column, column_name in enumerate(names):
+            np.testing.assert_array_equal(latest[column_name], rows[first:written, column])
+
+    def observe():
+        nonlocal ring, written
+        if ring is None:
+            ring = results.RingBufferResult(path)
+        written += 1
+        assert ring.running
+        assert ring.rows_written == written
+        assert ring.sequence == 2 * written
+        check(ring, 50, written)
+        return written < len(time)
+
+    try:
+        simulate(tmp_path, name, dpsim.LoggerFormat.RING_BUFFER,
+                 lambda logger: logger.set_ring_buffer_rows(capacity), observe=observe)
+        assert written == len(time) > capacity
+
+        # the last rows remain readable after closing
+        ring = results.RingBufferResult(path)
+        assert not ring.running
+        assert ring.names == names
+        assert ring.rows_written == len(time)
+        assert ring.sequence == 2 * len(time)
+        for count in (1, 10, capacity, 10 * capacity):
+            check(ring, count, len(time))
+        check(ring, None, len(time))
+    finally:
+        if os.path.exists(path):
+            os.remove(path)
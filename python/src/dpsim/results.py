@@ -0,0 +1,252 @@
+import math
+import os
+import struct
+
+import numpy as np
+
+_BINARY_MAGIC = b'DPSIMBIN'
+_BINARY_HEADER = struct.Struct('<8sIIIIQQ')
+_COMPRESSED_MAGIC = b'DPSIMCMP'
+_COMPRESSED_HEADER = struct.Struct('<8sIIIIQ')
+_COMPRESSED_CHUNK = struct.Struct('<QII')
+_RING_MAGIC = b'DPSIMRNG'
+# the ring buffer is shared with the simulation on the same host and uses its byte order
+_RING_HEADER = struct.Struct('=8sIIIIQQQ')
+_DOUBLE = struct.Struct('<d')
+_BITS = struct.Struct('<Q')
+
+
+class BinaryResult:
+    """Result file written by a Logger in a binary format, see BinaryResultWriter.h.
+
+    The chunks of the file are memory-mapped as a numpy structured array, so
+    that no values are parsed or copied when the file is opened. Columns are
+    gathered from the chunks on access.
+    """
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            fixed = f.read(_BINARY_HEADER.size)
+            magic, version, value_size, num_columns, chunk_rows, header_size, chunk_size = _BINARY_HEADER.unpack(fixed)
+            if magic != _BINARY_MAGIC or version != 1:
+                raise ValueError('{} is not a binary result file of version 1'.format(path))
+            columns = f.read(header_size - _BINARY_HEADER.size)
+
+        self.names = []
+        self.units = []
+        offset = 0
+        for _ in range(num_columns):
+            for target in (self.names, self.units):
+                length, = struct.unpack_from('<H', columns, offset)
+                target.append(columns[offset + 2:offset + 2 + length].decode())
+                offset += 2 + length
+
+        value_type = '<f8' if value_size == 8 else '<f4'
+        dtype = np.dtype({
+            'names': ['rows', 'time', 'values'],
+            'formats': ['<u8', ('<f8', (chunk_rows,)), (value_type, (num_columns, chunk_rows))],
+            'offsets': [0, 8, 8 + 8 * chunk_rows],
+            'itemsize': chunk_size
+        })
+        num_chunks = (os.path.getsize(path) - header_size) // chunk_size
+        if num_chunks > 0:
+            self.chunks = np.memmap(path, dtype=dtype, mode='r', offset=header_size, shape=(num_chunks,))
+        else:
+            self.chunks = np.zeros(0, dtype=dtype)
+
+    def _gather(self, field):
+        rows = self.chunks['rows']
+        if len(rows) == 0:
+            return np.zeros(0, dtype=field.dtype)
+        if len(rows) == 1:
+            return field[0, :rows[0]]
+        return np.concatenate([field[chunk, :rows[chunk]] for chunk in range(len(rows))])
+
+    @property
+    def time(self):
+        return self._gather(self.chunks['time'])
+
+    def column(self, name):
+        return self._gather(self.chunks['values'][:, self.names.index(name), :])
+
+    def to_dict(self):
+        result = {'time': self.time}
+        for name in self.names:
+            result[name] = self.column(name)
+        return result
+
+
+def read_binary(path):
+    """Read a binary result file into a dictionary of numpy arrays, including the time."""
+    return BinaryResult(path).to_dict()
+
+
+def _predict(values, index, linear):
+    if index == 0:
+        return 0
+    if linear and index >= 2:
+        prediction = (values[index - 1] + values[index - 1]) - values[index - 2]
+        if not math.isnan(prediction):
+            return _BITS.unpack(_DOUBLE.pack(prediction))[0]
+    return _BITS.unpack(_DOUBLE.pack(values[index - 1]))[0]
+
+
+def _decode_stream(stream, count, predictor):
+    """Decode a value stream of a compressed result, see FloatCodec.h for the encoding."""
+    padded = bytes(stream) + bytes(9)
+    position = 0
+
+    def read(bits):
+        nonlocal position
+        window = int.from_bytes(padded[position >> 3:(position >> 3) + 9], 'big')
+        value = (window >> (72 - (position & 7) - bits)) & ((1 << bits) - 1)
+        position += bits
+        return value
+
+    values = []
+    leading = trailing = 0
+    for index in range(count):
+        delta = 0
+        if read(1):
+            if read(1) == 0:
+                delta = read(64 - leading - trailing) << trailing
+            else:
+                leading = read(5)
+                length = read(6) or 64
+                trailing = 64 - leading - length
+                delta = read(length) << trailing
+        bits = delta ^ _predict(values, index, predictor == 1)
+        values.append(_DOUBLE.unpack(_BITS.pack(bits))[0])
+    return values
+
+
+class CompressedResult:
+    """Result file written by a Logger in the compressed format.
+
+    This is a pure Python decoder that works without the C++ module. The
+    class dpsimpy.CompressedResult provides the same interface and decodes
+    large files much faster.
+    """
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self._data = f.read()
+
+        magic, version, num_columns, chunk_rows, _, header_size = _COMPRESSED_HEADER.unpack_from(self._data)
+        if magic != _COMPRESSED_MAGIC or version != 1:
+            raise ValueError('{} is not a compressed result file of version 1'.format(path))
+
+        self.names = []
+        self.units = []
+        offset = _COMPRESSED_HEADER.size
+        for _ in range(num_columns):
+            for target in (self.names, self.units):
+                length, = struct.unpack_from('<H', self._data, offset)
+                target.append(self._data[offset + 2:offset + 2 + length].decode())
+                offset += 2 + length
+
+        # a chunk that was not completely written is ignored
+        self._chunks = []
+        offset = header_size
+        while offset + _COMPRESSED_CHUNK.size <= len(self._data):
+            size, rows, num_streams = _COMPRESSED_CHUNK.unpack_from(self._data, offset)
+            end = offset + 8 + size
+            if end > len(self._data):
+                break
+            directory = struct.unpack_from('<{}I'.format(2 * num_streams), self._data, offset + _COMPRESSED_CHUNK.size)
+            position = offset + _COMPRESSED_CHUNK.size + 8 * num_streams
+            streams = []
+            for stream in range(num_streams):
+                streams.append((position, directory[2 * stream], directory[2 * stream + 1]))
+                position += directory[2 * stream]
+            self._chunks.append((rows, streams))
+            offset = end
+
+        self.rows = sum(rows for rows, _ in self._chunks)
+
+    def _stream(self, index):
+        values = []
+        for rows, streams in self._chunks:
+            position, size, predictor = streams[index]
+            values.extend(_decode_stream(self._data[position:position + size], rows, predictor))
+        return np.array(values, dtype=np.float64)
+
+    @property
+    def time(self):
+        return self._stream(0)
+
+    def column(self, name):
+        return self._stream(self.names.index(name) + 1)
+
+    def to_dict(self):
+        result = {'time': self.time}
+        for name in self.names:
+            result[name] = self.column(name)
+        return result
+
+
+def read_compressed(path):
+    """Read a compressed result file into a dictionary of numpy arrays, including the time."""
+    return CompressedResult(path).to_dict()
+
+
+class RingBufferResult:
+    """Live view of the ring buffer of a Logger with the RING_BUFFER format.
+
+    The file is memory-mapped, so that the rows written by the running
+    simulation are visible without reopening it. The attribute buffer is a
+    zero-copy view of all slots with the time in column 0. Use latest() for
+    a consistent copy of the most recent rows.
+    """
+
+    def __init__(self, path):
+        self._map = np.memmap(path, dtype=np.uint8, mode='r')
+        magic, version, num_columns, capacity, _, header_size, _, _ = _RING_HEADER.unpack_from(self._map)
+        if magic != _RING_MAGIC or version != 1:
+            raise ValueError('{} is not a ring buffer result file of version 1'.format(path))
+
+        self.names = []
+        self.units = []
+        offset = _RING_HEADER.size
+        for _ in range(num_columns):
+            for target in (self.names, self.units):
+                length, = struct.unpack_from('=H', self._map, offset)
+                target.append(bytes(self._map[offset + 2:offset + 2 + length]).decode())
+                offset += 2 + length
+
+        self.capacity = capacity
+        self._state = self._map[20:24].view('=u4')
+        self._counters = self._map[32:48].view('=u8')
+        self.buffer = self._map[header_size:].view('=f8').reshape(capacity, num_columns + 1)
+
+    @property
+    def running(self):
+        return int(self._state[0]) == 1
+
+    @property
+    def sequence(self):
+        return int(self._counters[0])
+
+    @property
+    def rows_written(self):
+        return int(self._counters[1])
+
+    def latest(self, count=None):
+        """Copy the most recent rows into a dictionary of numpy arrays, including the time.
+
+        The sequence counter is read before and after copying. Rows that the
+        simulation may have overwritten in the meantime are dropped, so that
+        fewer than count rows are returned if the reader falls behind.
+        """
+        written = self.sequence // 2
+        count = min(self.capacity if count is None else count, written, self.capacity)
+        first = written - count
+        rows = self.buffer[np.arange(first, written) % self.capacity]
+        oldest_valid = (self.sequence + 1) // 2 - self.capacity
+        if oldest_valid > first:
+            rows = rows[oldest_valid - first:]
+
+        result = {'time': rows[:, 0]}
+        for column, name in enumerate(self.names):
+            result[name] = rows[:, column + 1]
+        return result